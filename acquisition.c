@@ -0,0 +1,184 @@
+/**
+ * 
+ * File:                acquisition.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the background acquisition of the weather station. A
+ * sample is started every ACQ_SAMPLE_PERIOD_MS and the temperature conversions
+ * requested by the BMP180 refresh schedule are interleaved. Each sample is 
+ * written into the snapshot buffer which is not published and is published 
+ * afterwards by a single byte write of its index, which can't be interrupted.
+ * A reader thus always copies a complete snapshot, since the writer never
+ * interrupts a reader: either both run in the main loop, or the reader is an
+ * interrupt service routine which runs to completion.
+*/
+
+
+#include "acquisition.h"
+#include "trend.h"
+#include "tick.h"
+
+// Phases of the background acquisition
+typedef enum {
+    ACQ_PHASE_WAIT_PERIOD,
+    ACQ_PHASE_COLLECT_TEMPERATURE,
+    ACQ_PHASE_COLLECT_PRESSURE
+} AcquisitionPhase;
+
+// Local variables
+static ACQ_SNAPSHOT snapshots[2];
+static volatile uint8_t publishedIndex;     // snapshot readers copy
+static uint16_t sampleSequence;             // 0 = nothing published yet
+static AcquisitionPhase acquisitionPhase;
+static uint16_t sampleStartTick;
+static uint16_t rawTemperature;
+static BMP180_PARAM *acquisitionSensor;
+
+// Function prototypes
+static void publishSample(uint32_t rawPressure);
+
+
+/******************************************************************************* 
+ * Function to initialise the acquisition task
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void initAcquisition(BMP180_PARAM *pSensor) {
+    
+    acquisitionSensor = pSensor;
+    publishedIndex = 0;
+    sampleSequence = 0;
+    acquisitionPhase = ACQ_PHASE_WAIT_PERIOD;
+    sampleStartTick = getTickMs() - ACQ_SAMPLE_PERIOD_MS;
+}
+
+
+/******************************************************************************* 
+ * Function to run the acquisition task
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void runAcquisition(void) {
+    
+    uint32_t rawPressure;
+    
+    switch (acquisitionPhase) {
+        case ACQ_PHASE_WAIT_PERIOD:
+            if (!hasTickElapsed(sampleStartTick, ACQ_SAMPLE_PERIOD_MS))
+                return;
+            sampleStartTick += ACQ_SAMPLE_PERIOD_MS;
+            if (hasTickElapsed(sampleStartTick, ACQ_SAMPLE_PERIOD_MS))
+                sampleStartTick = getTickMs(); // too late; resynchronise
+            if (BMP180_IsTemperatureRefreshDue(acquisitionSensor)) {
+                if (BMP180_StartTemperatureConversion(acquisitionSensor) == 0)
+                    acquisitionPhase = ACQ_PHASE_COLLECT_TEMPERATURE;
+            } else if (BMP180_StartPressureConversion(acquisitionSensor) == 0) {
+                // Reuse the cached raw temperature for this pressure sample
+                rawTemperature = BMP180_GetLastRawTemperature(
+                        acquisitionSensor);
+                acquisitionPhase = ACQ_PHASE_COLLECT_PRESSURE;
+            }
+            break;
+        case ACQ_PHASE_COLLECT_TEMPERATURE:
+            if (!BMP180_IsConversionComplete(acquisitionSensor))
+                return;
+            rawTemperature = BMP180_CollectRawTemperature(acquisitionSensor);
+            if (BMP180_StartPressureConversion(acquisitionSensor) == 0)
+                acquisitionPhase = ACQ_PHASE_COLLECT_PRESSURE;
+            else
+                acquisitionPhase = ACQ_PHASE_WAIT_PERIOD;
+            break;
+        case ACQ_PHASE_COLLECT_PRESSURE:
+            if (!BMP180_IsConversionComplete(acquisitionSensor))
+                return;
+            acquisitionPhase = ACQ_PHASE_WAIT_PERIOD;
+            rawPressure = BMP180_CollectRawPressure(acquisitionSensor);
+            if (rawPressure == BMP180_INVALID_DATA 
+                    || rawTemperature == BMP180_INVALID_DATA)
+                break; // sample lost due to a bus failure
+            publishSample(rawPressure);
+            break;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to read the newest snapshot
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool getAcquisitionSnapshot(ACQ_SNAPSHOT *pSnapshot) {
+    
+    *pSnapshot = snapshots[publishedIndex];
+    
+    return pSnapshot->sequence != 0;
+}
+
+
+/******************************************************************************* 
+ * Function to check whether the acquisition task is ready to run
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool isAcquisitionReady(void) {
+    
+    if (acquisitionPhase == ACQ_PHASE_WAIT_PERIOD)
+        return hasTickElapsed(sampleStartTick, ACQ_SAMPLE_PERIOD_MS);
+    
+    return BMP180_IsConversionDue(acquisitionSensor);
+}
+
+
+/******************************************************************************* 
+ * Function to publish a sample
+ ******************************************************************************/
+/*
+ * @brief This function calculates temperature, pressure and altitude from the
+ * raw sensor data, writes them into the snapshot buffer which is not 
+ * published and publishes it. The pressure is also recorded for the weather
+ * trend if a reading is due.
+ * 
+ * @param rawPressure -> raw pressure of the sample
+ * 
+ * @return void 
+ * 
+*/
+static void publishSample(uint32_t rawPressure) {
+    
+    uint8_t index = publishedIndex ^ 1;
+    ACQ_SNAPSHOT *pSnapshot = &snapshots[index];
+    
+    pSnapshot->temperature = BMP180_CalcTemperature(acquisitionSensor, 
+            rawTemperature);
+    pSnapshot->pressure = BMP180_CalcPressure(acquisitionSensor, rawPressure,
+            rawTemperature);
+    pSnapshot->altitude = BMP180_CalcAltitude(pSnapshot->pressure);
+    pSnapshot->tick = getTickMs();
+    if (++sampleSequence == 0)
+        sampleSequence = 1; // 0 is reserved for no sample published
+    pSnapshot->sequence = sampleSequence;
+    publishedIndex = index;
+    
+    if (updatePressureReading) {
+        updatePressureReadings(pSnapshot->pressure);
+    }
+}
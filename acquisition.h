@@ -0,0 +1,112 @@
+/* 
+ * File:                acquisition.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module samples the BMP180 at a fixed rate as a task of the main loop,
+ * independent of the display carousel. Each sample is published into one of
+ * two snapshot buffers, so that the display states and any other consumer, 
+ * incl. interrupt service routines, read the newest consistent measurements 
+ * without locks.
+ *    
+ */
+
+#ifndef ACQUISITION_H
+#define	ACQUISITION_H
+
+#include "mcc_generated_files/mcc.h"
+#include "bmp180.h"
+
+/* Sample period (ms). It has to exceed the conversion time of a temperature
+ * and a pressure sample, i.e. 9 ms at oss = 0 up to 30.5 ms at oss = 3. */
+#define ACQ_SAMPLE_PERIOD_MS        1000
+
+// Snapshot of the measurements published by the acquisition task
+typedef struct {
+    int16_t temperature;    // 0.1 Celsius degree
+    int32_t pressure;       // Pa
+    int16_t altitude;       // m
+    uint16_t sequence;      // number of the sample, counting from 1
+    uint16_t tick;          // millisecond tick the sample was published at
+} ACQ_SNAPSHOT;
+
+/******************************************************************************* 
+ * Function to initialise the acquisition task
+ ******************************************************************************/
+/*
+ * @brief This initialisation function needs to be invoked once, after the 
+ * sensor and the millisecond tick have been initialised. The first sample is
+ * started by the next run.
+ * 
+ * @param pointer to the BMP180 sensor the samples are taken from
+ * 
+ * @return void 
+ * 
+*/
+void initAcquisition(BMP180_PARAM *pSensor);
+
+
+/******************************************************************************* 
+ * Function to run the acquisition task
+ ******************************************************************************/
+/*
+ * @brief This starts a sample every ACQ_SAMPLE_PERIOD_MS and publishes it once
+ * the conversions are complete. It never waits for the sensor and needs to be
+ * invoked cyclically by the main loop. Samples which couldn't be read are not
+ * published.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void runAcquisition(void);
+
+
+/******************************************************************************* 
+ * Function to read the newest snapshot
+ ******************************************************************************/
+/*
+ * @brief This copies the newest published snapshot. It may be invoked by the
+ * main loop and by interrupt service routines, but not concurrently by both.
+ * 
+ * @param pointer to the snapshot to copy to
+ * 
+ * @return true if a sample has been published, false if not yet 
+ * 
+*/
+_Bool getAcquisitionSnapshot(ACQ_SNAPSHOT *pSnapshot);
+
+
+/******************************************************************************* 
+ * Function to check whether the acquisition task is ready to run
+ ******************************************************************************/
+/*
+ * @brief This checks without accessing the sensor whether the next run would
+ * start a sample or check the conversion in progress. Otherwise, the task
+ * only waits for the millisecond tick and the CPU may idle.
+ * 
+ * @param None
+ * 
+ * @return true if the task is ready to run
+ * 
+*/
+_Bool isAcquisitionReady(void);
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* ACQUISITION_H */
+
@@ -18,12 +18,105 @@
  */
 
 #include "bmp180.h"
+#include "i2c_profile.h"
+#include "tick.h"
 
-/* Internal global variables */
-static BMP180_PARAM *pBMP180;
+/* Oversampling setting of the pressure path, either constant if selected at
+ * build time or taken from the sensor data structure */
+#if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+    #define BMP180_OSS(bmp180)              ((bmp180)->oversampling)
+    #define BMP180_OSS_CTRL_REG(bmp180)     ((bmp180)->ossCtrlRegValue)
+    #define BMP180_OSS_CONV_TIME(bmp180)    ((bmp180)->ossConvTime)
+#elif BMP180_FIXED_OSS == 0
+    #define BMP180_OSS(bmp180)              0
+    #define BMP180_OSS_CTRL_REG(bmp180)     BMP180_CTRL_MEAS_VAL_OSS_0
+    #define BMP180_OSS_CONV_TIME(bmp180)    BMP180_CONV_TIME_OSS_0
+#elif BMP180_FIXED_OSS == 1
+    #define BMP180_OSS(bmp180)              1
+    #define BMP180_OSS_CTRL_REG(bmp180)     BMP180_CTRL_MEAS_VAL_OSS_1
+    #define BMP180_OSS_CONV_TIME(bmp180)    BMP180_CONV_TIME_OSS_1
+#elif BMP180_FIXED_OSS == 2
+    #define BMP180_OSS(bmp180)              2
+    #define BMP180_OSS_CTRL_REG(bmp180)     BMP180_CTRL_MEAS_VAL_OSS_2
+    #define BMP180_OSS_CONV_TIME(bmp180)    BMP180_CONV_TIME_OSS_2
+#elif BMP180_FIXED_OSS == 3
+    #define BMP180_OSS(bmp180)              3
+    #define BMP180_OSS_CTRL_REG(bmp180)     BMP180_CTRL_MEAS_VAL_OSS_3
+    #define BMP180_OSS_CONV_TIME(bmp180)    BMP180_CONV_TIME_OSS_3
+#else
+    #error "BMP180_FIXED_OSS must be 0 to 3 or BMP180_OSS_RUNTIME"
+#endif
+
+static _Bool hasI2C1Failed(void);
+static _Bool hasI2C2Failed(void);
+
+/* Bus binding to the MSSP1 via the I2C Foundation Services simple master */
+const BMP180_BUS bmp180BusI2C1 = {
+    i2c1_read1ByteRegister,
+    i2c1_write1ByteRegister,
+    i2c1_writeNBytes,
+    i2c1_readNBytes,
+    i2c1_readDataBlock,
+    hasI2C1Failed
+};
+
+/* Bus binding to the MSSP2 via the I2C Foundation Services simple master */
+const BMP180_BUS bmp180BusI2C2 = {
+    i2c_read1ByteRegister,
+    i2c_write1ByteRegister,
+    i2c_writeNBytes,
+    i2c_readNBytes,
+    i2c_readDataBlock,
+    hasI2C2Failed
+};
+
+/* Altitude [m] according to the international barometric formula, tabulated
+ * in steps of 1024 Pa from 30000 Pa (index 0) to 110896 Pa (index 79). Being
+ * constant, the table is placed in program memory. */
+static const int16_t altitudeTable[BMP180_ALT_TABLE_SIZE] = {
+    9165, 8940, 8721, 8507, 8298, 8095, 7896, 7702,
+    7512, 7326, 7144, 6966, 6791, 6620, 6452, 6287,
+    6125, 5966, 5810, 5656, 5505, 5356, 5210, 5066,
+    4924, 4784, 4647, 4511, 4378, 4246, 4116, 3988,
+    3861, 3736, 3613, 3492, 3372, 3253, 3136, 3020,
+    2905, 2792, 2681, 2570, 2461, 2353, 2246, 2140,
+    2035, 1932, 1829, 1728, 1627, 1528, 1429, 1332,
+    1235, 1139, 1045, 951, 858, 765, 674, 583,
+    494, 404, 316, 229, 142, 56, -30, -114,
+    -198, -281, -364, -446, -528, -608, -688, -768
+};
 
 /* Internal function prototypes */
-static int32_t calcB5(uint16_t rawTemperature);
+static int32_t calcB5(BMP180_PARAM *bmp180, uint16_t rawTemperature);
+static void updateCompensation(BMP180_PARAM *bmp180, uint16_t rawTemperature);
+static uint16_t unpackCalWord(const uint8_t *calData, uint8_t regMsb);
+static _Bool countBusTraffic(BMP180_PARAM *bmp180, uint8_t bytes);
+static void initConversionPolling(BMP180_PARAM *bmp180, 
+        BMP180_CONV_STATS *pStats);
+static _Bool pollConversionStatus(BMP180_PARAM *bmp180);
+static void resetConversionStats(BMP180_CONV_STATS *pStats);
+static int32_t calcAltitudeFixed(int32_t pressure);
+#if BMP180_DIVISION_FREE
+static uint32_t mulHigh32(uint32_t a, uint32_t b);
+static void calcReciprocal(uint32_t divisor, uint32_t *pReciprocal, 
+        uint8_t *pShift);
+static uint32_t divideByReciprocal(uint32_t dividend, uint32_t divisor, 
+        uint32_t reciprocal, uint8_t shift);
+#endif
+
+#if BMP180_DIVISION_FREE
+/* The estimate of the quotient falls short by at most two for divisors of at
+ * least 2^3 and by up to ten below, see divideByReciprocal() */
+#define BMP180_RECIPROCAL_MIN_SHIFT         3
+#define BMP180_RECIPROCAL_MAX_CORRECTION    2
+
+/* Initial reciprocal estimates 2^20 / (17 + i) for normalised divisors whose 
+ * four bits following the most significant bit equal i */
+static const uint16_t reciprocalTable[16] = {
+    61680, 58254, 55188, 52428, 49932, 47662, 45590, 43690,
+    41943, 40329, 38836, 37449, 36157, 34952, 33825, 32768
+};
+#endif
 
 /******************************************************************************* 
  * Function to initialise the communication with the BMP180 sensor
@@ -35,77 +128,104 @@ static int32_t calcB5(uint16_t rawTemperature);
  */
 uint8_t BMP180_Init(BMP180_PARAM *bmp180) {
 
-    /* Assign BMP180 structure to internal global pointer variable */
+    uint8_t calData[BMP180_CAL_DATA_SIZE];
+
     if (bmp180 == 0)
         return 1; // Error 1; null pointer
-    pBMP180 = bmp180;
+    
+    /* Bind the sensor to the default bus and address if not assigned */
+    if (bmp180->bus == 0)
+        bmp180->bus = &bmp180BusI2C2;
+    if (bmp180->deviceAddr == 0)
+        bmp180->deviceAddr = BMP180_I2C_ADDR;
     
     /* Assign the oversampling control register value and the max. conversion
      * time according to the selected hardware pressure sampling accuracy mode */
-    switch (pBMP180->oversampling) {
+    #if BMP180_FIXED_OSS != BMP180_OSS_RUNTIME
+        bmp180->oversampling = BMP180_FIXED_OSS;
+    #endif
+    switch (bmp180->oversampling) {
         case BMP180_MODE_ULTRALOWPOWER:
-            pBMP180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_0;
+            bmp180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_0;
+            bmp180->ossConvTime = BMP180_CONV_TIME_OSS_0;
             break;
         case BMP180_MODE_STANDARD:
-            pBMP180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_1;
+            bmp180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_1;
+            bmp180->ossConvTime = BMP180_CONV_TIME_OSS_1;
             break;
         case BMP180_MODE_HIGHRESOLUTION:
-            pBMP180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_2;
+            bmp180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_2;
+            bmp180->ossConvTime = BMP180_CONV_TIME_OSS_2;
             break;
         case BMP180_MODE_ULTRAHIGHRESOLUTION:
-            pBMP180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_3;
+            bmp180->ossCtrlRegValue = BMP180_CTRL_MEAS_VAL_OSS_3;
+            bmp180->ossConvTime = BMP180_CONV_TIME_OSS_3;
             break;
     }
+    bmp180->convType = BMP180_CONV_NONE;
+    bmp180->compensation.isValid = false;
+    bmp180->hasRawTemperature = false;
+    if (bmp180->tempRefreshSamples == 0)
+        bmp180->tempRefreshSamples = 1; // refresh with every pressure sample
+    resetConversionStats(&bmp180->tempConvStats);
+    resetConversionStats(&bmp180->pressConvStats);
 
     /* Read sensor chip-id to check whether communication is established */
-    pBMP180->chipId = (i2c_read1ByteRegister(BMP180_I2C_ADDR,
+    bmp180->busStats.transactions = 0;
+    bmp180->busStats.bytes = 0;
+    bmp180->busStats.errors = 0;
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_CHIP_ID);
+    bmp180->chipId = (bmp180->bus->read1ByteRegister(bmp180->deviceAddr,
             BMP180_REG_CHIP_ID)); 
-    if (pBMP180->chipId != BMP180_REG_CHIP_ID_VALUE)
+    if (!countBusTraffic(bmp180, 1 + BMP180_I2C_REG_READ_OVERHEAD) 
+            || bmp180->chipId != BMP180_REG_CHIP_ID_VALUE)
         return 2; // Error 2; communication failed
     
     
-    /* Read calibration data AC1 to AC6 from the EEPROM of the BMP180 */
-    pBMP180->calibParam.ac1 = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    /* Read the whole calibration block AC1 to MD from the EEPROM of the BMP180
+     * in a single burst transaction. The coefficients are stored MSB first
+     * in consecutive registers. */
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_CALIBRATION);
+    bmp180->bus->readDataBlock(bmp180->deviceAddr, BMP180_CAL_COEFF_AC1_MSB, 
+            calData, sizeof(calData));
+    if (!countBusTraffic(bmp180, sizeof(calData) 
+            + BMP180_I2C_REG_READ_OVERHEAD))
+        return 2; // Error 2; communication failed
+    
+    bmp180->calibParam.ac1 = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_AC1_MSB);
-    pBMP180->calibParam.ac2 = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.ac2 = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_AC2_MSB);
-    pBMP180->calibParam.ac3 = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.ac3 = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_AC3_MSB);
-    pBMP180->calibParam.ac4 = i2c_read2ByteRegister(BMP180_I2C_ADDR, 
-            BMP180_CAL_COEFF_AC4_MSB);
-    pBMP180->calibParam.ac5 = i2c_read2ByteRegister(BMP180_I2C_ADDR, 
-            BMP180_CAL_COEFF_AC5_MSB);
-    pBMP180->calibParam.ac6 = i2c_read2ByteRegister(BMP180_I2C_ADDR, 
-            BMP180_CAL_COEFF_AC6_MSB);
-    
-    /* Read calibration data B1 and B2 from the EEPROM of the BMP180 */
-    pBMP180->calibParam.b1 = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.ac4 = unpackCalWord(calData, BMP180_CAL_COEFF_AC4_MSB);
+    bmp180->calibParam.ac5 = unpackCalWord(calData, BMP180_CAL_COEFF_AC5_MSB);
+    bmp180->calibParam.ac6 = unpackCalWord(calData, BMP180_CAL_COEFF_AC6_MSB);
+    bmp180->calibParam.b1 = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_B1_MSB);
-    pBMP180->calibParam.b2 = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.b2 = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_B2_MSB);
-
-    /* Read calibration data MB, MC, MD from the EEPROM of the BMP180 */
-    pBMP180->calibParam.mb = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.mb = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_MB_MSB);
-    pBMP180->calibParam.mc = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.mc = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_MC_MSB);
-    pBMP180->calibParam.md = (int16_t) i2c_read2ByteRegister(BMP180_I2C_ADDR, 
+    bmp180->calibParam.md = (int16_t) unpackCalWord(calData, 
             BMP180_CAL_COEFF_MD_MSB);
 
     /* Debugging only! Use default parameters as provided in the data sheet */
     #if BMP180_DEBUG_USE_DEFAULT_PARAM == 1
-        pBMP180->calibParam.ac1 = 408;
-        pBMP180->calibParam.ac2 = -72;
-        pBMP180->calibParam.ac3 = -14383;
-        pBMP180->calibParam.ac4 = 32741;
-        pBMP180->calibParam.ac5 = 32757;
-        pBMP180->calibParam.ac6 = 23153;
-        pBMP180->calibParam.b1 = 6190;
-        pBMP180->calibParam.b2 = 4;
-        pBMP180->calibParam.mb = -32768;
-        pBMP180->calibParam.mc = -8711;
-        pBMP180->calibParam.md = 2868;
-        pBMP180->oversampling = BMP180_MODE_ULTRALOWPOWER; // oss = 0
+        bmp180->calibParam.ac1 = 408;
+        bmp180->calibParam.ac2 = -72;
+        bmp180->calibParam.ac3 = -14383;
+        bmp180->calibParam.ac4 = 32741;
+        bmp180->calibParam.ac5 = 32757;
+        bmp180->calibParam.ac6 = 23153;
+        bmp180->calibParam.b1 = 6190;
+        bmp180->calibParam.b2 = 4;
+        bmp180->calibParam.mb = -32768;
+        bmp180->calibParam.mc = -8711;
+        bmp180->calibParam.md = 2868;
+        bmp180->oversampling = BMP180_MODE_ULTRALOWPOWER; // oss = 0
     #endif
     
     return 0; // return successfully
@@ -119,23 +239,252 @@ uint8_t BMP180_Init(BMP180_PARAM *bmp180) {
  * header file
  * 
  */
-uint16_t BMP180_ReadRawTemperature(void) {
+uint16_t BMP180_ReadRawTemperature(BMP180_PARAM *bmp180) {
     
-    uint8_t dataBytes[BMP180_TEMPERATURE_DATA_BYTES] = {0};
-    uint8_t regOutputStartAddr = BMP180_REG_OUT_MSB;
-    uint16_t rawTemperature = 0; // uncompensated temperature UT
+    /* Start the conversion and wait for the max. required conversion time */
+    BMP180_StartTemperatureConversion(bmp180);
+    while (!BMP180_IsConversionComplete(bmp180));
+    
+    return BMP180_CollectRawTemperature(bmp180);
+}
+
+
+/******************************************************************************* 
+ * Function to read uncompensated pressure
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint32_t BMP180_ReadRawPressure(BMP180_PARAM *bmp180) {
+    
+    /* Start the conversion and wait for the max. required conversion time */
+    BMP180_StartPressureConversion(bmp180);
+    while (!BMP180_IsConversionComplete(bmp180));
+    
+    return BMP180_CollectRawPressure(bmp180);
+}
+
+
+/******************************************************************************* 
+ * Function to start a temperature conversion
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint8_t BMP180_StartTemperatureConversion(BMP180_PARAM *bmp180) {
+    
+    if (bmp180->convType != BMP180_CONV_NONE)
+        return 1; // Error 1; conversion still in progress
     
     /* Write value to oversampling control register */
-    i2c_write1ByteRegister(BMP180_I2C_ADDR, BMP180_REG_CTRL_MEAS, 
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_START);
+    bmp180->bus->write1ByteRegister(bmp180->deviceAddr, BMP180_REG_CTRL_MEAS, 
             BMP180_CTRL_MEAS_VAL_TEMP);
+    if (!countBusTraffic(bmp180, BMP180_I2C_REG_WRITE_BYTES))
+        return 2; // Error 2; conversion not started
+    
+    bmp180->convType = BMP180_CONV_TEMPERATURE;
+    bmp180->convTime = BMP180_CONV_TIME_TEMP;
+    bmp180->convStartTick = getTickMs();
+    initConversionPolling(bmp180, &bmp180->tempConvStats);
+    
+    return 0;
+}
+
+
+/******************************************************************************* 
+ * Function to start a pressure conversion
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint8_t BMP180_StartPressureConversion(BMP180_PARAM *bmp180) {
+    
+    if (bmp180->convType != BMP180_CONV_NONE)
+        return 1; // Error 1; conversion still in progress
+    
+    /* Write value to oversampling control register */
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_START);
+    bmp180->bus->write1ByteRegister(bmp180->deviceAddr, BMP180_REG_CTRL_MEAS, 
+            BMP180_OSS_CTRL_REG(bmp180));
+    if (!countBusTraffic(bmp180, BMP180_I2C_REG_WRITE_BYTES))
+        return 2; // Error 2; conversion not started
+    
+    bmp180->convType = BMP180_CONV_PRESSURE;
+    bmp180->convTime = BMP180_OSS_CONV_TIME(bmp180);
+    bmp180->convStartTick = getTickMs();
+    initConversionPolling(bmp180, &bmp180->pressConvStats);
+    
+    return 0;
+}
+
+
+/******************************************************************************* 
+ * Function to check whether the conversion in progress has completed
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool BMP180_IsConversionComplete(BMP180_PARAM *bmp180) {
+    
+    if (bmp180->convType == BMP180_CONV_NONE)
+        return true;
+    
+    if (bmp180->scoPolling)
+        return pollConversionStatus(bmp180);
+    
+    /* The conversion may have been started just before the next tick, hence
+     * one additional tick is required to guarantee the max. conversion time */
+    return hasTickElapsed(bmp180->convStartTick, bmp180->convTime + 1);
+}
 
-    /* Wait for the max. required conversion time */
-    __delay_ms(BMP180_CONV_TIME_TEMP);
 
-    /* Read raw temperature data (16-bit) */
-    i2c_writeNBytes(BMP180_I2C_ADDR, &regOutputStartAddr, 
-            sizeof(regOutputStartAddr));
-    i2c_readNBytes(BMP180_I2C_ADDR, dataBytes, sizeof(dataBytes));
+/******************************************************************************* 
+ * Function to check whether the conversion in progress is due to be checked
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool BMP180_IsConversionDue(BMP180_PARAM *bmp180) {
+    
+    if (bmp180->convType == BMP180_CONV_NONE)
+        return true;
+    
+    if (bmp180->scoPolling)
+        return hasTickElapsed(bmp180->convStartTick, bmp180->nextPollTime);
+    
+    return hasTickElapsed(bmp180->convStartTick, bmp180->convTime + 1);
+}
+
+
+/******************************************************************************* 
+ * Function to prepare polling the start-of-conversion bit
+ ******************************************************************************/
+/*
+ * @brief This function schedules the first poll of the SCO bit for a 
+ * conversion that has just been started, based on the learned conversion
+ * time estimate.
+ * 
+ * @param pointer to the conversion statistics of the started conversion
+ * 
+ * @return void
+ * 
+ */
+static void initConversionPolling(BMP180_PARAM *bmp180, 
+        BMP180_CONV_STATS *pStats) {
+    
+    if (pStats->estimate == 0 || pStats->estimate > bmp180->convTime)
+        pStats->estimate = bmp180->convTime;
+    bmp180->nextPollTime = pStats->estimate;
+    bmp180->pollBackoff = 1;
+    bmp180->isFirstPoll = true;
+}
+
+
+/******************************************************************************* 
+ * Function to poll the start-of-conversion bit
+ ******************************************************************************/
+/*
+ * @brief This function reads the SCO bit (bit 5) of the control register once
+ * the next poll time has elapsed. While the conversion is still running, 
+ * the interval to the next poll is doubled up to BMP180_SCO_POLL_BACKOFF_MAX.
+ * The max. conversion time of the data sheet bounds the polling, thus a 
+ * stuck SCO bit can't stall the caller. 
+ * 
+ * The estimate for the next conversion is decreased by 1 ms whenever the
+ * conversion has already completed at the first poll, otherwise it is set to
+ * the observed conversion time. Hence, the estimate tracks the real hardware.
+ * 
+ * @param None
+ * 
+ * @return True if the conversion has completed
+ * 
+ */
+static _Bool pollConversionStatus(BMP180_PARAM *bmp180) {
+    
+    BMP180_CONV_STATS *pStats;
+    uint16_t elapsedTicks;
+    uint8_t elapsed;
+    uint8_t ctrlMeas;
+    
+    elapsedTicks = getTickMs() - bmp180->convStartTick;
+    elapsed = (elapsedTicks > 0xFF) ? 0xFF : (uint8_t) elapsedTicks;
+    if (elapsed < bmp180->nextPollTime)
+        return false;
+    
+    if (elapsed <= bmp180->convTime) {
+        I2C_PROFILE_SITE(I2C_SITE_BMP180_POLL);
+        ctrlMeas = bmp180->bus->read1ByteRegister(bmp180->deviceAddr, 
+                BMP180_REG_CTRL_MEAS);
+        if (!countBusTraffic(bmp180, 1 + BMP180_I2C_REG_READ_OVERHEAD)
+                || (ctrlMeas & BMP180_CTRL_MEAS_SCO_BIT)) {
+            /* Conversion still running or status unknown; back off before 
+             * polling again */
+            bmp180->nextPollTime = elapsed + bmp180->pollBackoff;
+            if (bmp180->pollBackoff < BMP180_SCO_POLL_BACKOFF_MAX)
+                bmp180->pollBackoff <<= 1;
+            bmp180->isFirstPoll = false;
+            return false;
+        }
+    }
+    
+    /* Learn the conversion time and update the statistics */
+    pStats = (bmp180->convType == BMP180_CONV_TEMPERATURE) ? 
+        &bmp180->tempConvStats : &bmp180->pressConvStats;
+    if (elapsed > bmp180->convTime)
+        pStats->estimate = bmp180->convTime; // SCO bit not observed in time
+    else if (bmp180->isFirstPoll && pStats->estimate > 1)
+        pStats->estimate--;
+    else if (!bmp180->isFirstPoll)
+        pStats->estimate = elapsed;
+    
+    if (elapsed < pStats->minTime)
+        pStats->minTime = elapsed;
+    if (elapsed > pStats->maxTime)
+        pStats->maxTime = elapsed;
+    pStats->count++;
+    pStats->totalTime += elapsed;
+    
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to collect the uncompensated temperature
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint16_t BMP180_CollectRawTemperature(BMP180_PARAM *bmp180) {
+    
+    uint8_t dataBytes[BMP180_TEMPERATURE_DATA_BYTES] = {0};
+    uint16_t rawTemperature = 0; // uncompensated temperature UT
+    
+    if (bmp180->convType != BMP180_CONV_TEMPERATURE)
+        return BMP180_INVALID_DATA;
+    bmp180->convType = BMP180_CONV_NONE;
+
+    /* Read raw temperature data (16-bit) in a single transaction; the register 
+     * pointer is written and the result registers are read after a repeated
+     * start, so that no other master can access the sensor in between */
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_RESULT);
+    bmp180->bus->readDataBlock(bmp180->deviceAddr, BMP180_REG_OUT_MSB, 
+            dataBytes, sizeof(dataBytes));
+    if (!countBusTraffic(bmp180, sizeof(dataBytes) 
+            + BMP180_I2C_REG_READ_OVERHEAD))
+        return BMP180_INVALID_DATA;
 
     /* Typecast data array to temperature variable */
     rawTemperature = (uint16_t)(dataBytes[BMP180_TEMPERATURE_DATA_MSB] << 8 
@@ -145,65 +494,203 @@ uint16_t BMP180_ReadRawTemperature(void) {
     #if BMP180_DEBUG_USE_DEFAULT_PARAM == 1
         rawTemperature = 27898;
     #endif
+    
+    /* Keep the raw temperature for the following pressure samples */
+    bmp180->lastRawTemperature = rawTemperature;
+    bmp180->lastTemperatureTick = getTickMs();
+    bmp180->samplesSinceTemperature = 0;
+    bmp180->hasRawTemperature = true;
 
     return rawTemperature;
 }
 
 
 /******************************************************************************* 
- * Function to read uncompensated pressure
+ * Function to collect the uncompensated pressure
  ******************************************************************************/
 /*
  * @brief For more details refer to the documentation in the corresponding
  * header file
  * 
  */
-uint32_t BMP180_ReadRawPressure(void) {
+uint32_t BMP180_CollectRawPressure(BMP180_PARAM *bmp180) {
     
     uint8_t dataBytes[BMP180_PRESSURE_DATA_BYTES] = {0};
-    uint8_t regOutputStartAddr = BMP180_REG_OUT_MSB;
     uint32_t rawPressure = 0; // uncompensated pressure data UP
     
-    /* Write value to oversampling control register */
-    i2c_write1ByteRegister(BMP180_I2C_ADDR, BMP180_REG_CTRL_MEAS, 
-            pBMP180->ossCtrlRegValue);
-
-    /* Wait for the max. required conversion time */
-    switch (pBMP180->oversampling) {
-        case BMP180_MODE_ULTRALOWPOWER:
-            __delay_ms(BMP180_CONV_TIME_OSS_0);
-            break;
-        case BMP180_MODE_STANDARD:
-            __delay_ms(BMP180_CONV_TIME_OSS_1);
-            break;
-        case BMP180_MODE_HIGHRESOLUTION:
-            __delay_ms(BMP180_CONV_TIME_OSS_2);
-            break;
-        case BMP180_MODE_ULTRAHIGHRESOLUTION:
-            __delay_ms(BMP180_CONV_TIME_OSS_3);
-            break;
-    }
+    if (bmp180->convType != BMP180_CONV_PRESSURE)
+        return BMP180_INVALID_DATA;
+    bmp180->convType = BMP180_CONV_NONE;
 
-    /* Read raw pressure data UP (16 to 19-bit) */
-    i2c_writeNBytes(BMP180_I2C_ADDR, &regOutputStartAddr, 
-            sizeof(regOutputStartAddr));
-    i2c_readNBytes(BMP180_I2C_ADDR, dataBytes, sizeof(dataBytes));
+    /* Read raw pressure data UP (16 to 19-bit) in a single transaction; the register 
+     * pointer is written and the result registers are read after a repeated
+     * start, so that no other master can access the sensor in between */
+    I2C_PROFILE_SITE(I2C_SITE_BMP180_RESULT);
+    bmp180->bus->readDataBlock(bmp180->deviceAddr, BMP180_REG_OUT_MSB, 
+            dataBytes, sizeof(dataBytes));
+    if (!countBusTraffic(bmp180, sizeof(dataBytes) 
+            + BMP180_I2C_REG_READ_OVERHEAD))
+        return BMP180_INVALID_DATA;
 
     /* Typecast data array to pressure variable */
     rawPressure = 
             (uint32_t)((((uint32_t)dataBytes[BMP180_PRESSURE_DATA_MSB] << 16)
             | ((uint32_t)dataBytes[BMP180_PRESSURE_DATA_LSB] << 8)
             | (uint32_t)dataBytes[BMP180_PRESSURE_DATA_XLSB])
-            >> (8 - pBMP180->oversampling));
+            >> (8 - BMP180_OSS(bmp180)));
 
     /* Debugging only! Use default parameters as provided in the data sheet */
     #if BMP180_DEBUG_USE_DEFAULT_PARAM == 1
         rawPressure = 23843;
     #endif
+    
+    if (bmp180->samplesSinceTemperature < 0xFF)
+        bmp180->samplesSinceTemperature++;
 
     return rawPressure;
 }
 
+
+/******************************************************************************* 
+ * Function to check whether the raw temperature needs to be refreshed
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool BMP180_IsTemperatureRefreshDue(BMP180_PARAM *bmp180) {
+    
+    if (!bmp180->hasRawTemperature)
+        return true;
+    if (bmp180->samplesSinceTemperature >= bmp180->tempRefreshSamples)
+        return true;
+    if (bmp180->tempRefreshPeriod != 0 && hasTickElapsed(
+            bmp180->lastTemperatureTick, bmp180->tempRefreshPeriod))
+        return true;
+    
+    return false;
+}
+
+
+/******************************************************************************* 
+ * Function to get the most recent raw temperature
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint16_t BMP180_GetLastRawTemperature(BMP180_PARAM *bmp180) {
+    
+    return bmp180->lastRawTemperature;
+}
+
+/******************************************************************************* 
+ * Function to reset the conversion time statistics
+ ******************************************************************************/
+/*
+ * @brief This function resets the conversion time statistics and the learned
+ * estimate, which is reinitialised with the max. time of the data sheet on 
+ * the next conversion.
+ * 
+ * @param pointer to the conversion statistics
+ * 
+ * @return void
+ * 
+ */
+static void resetConversionStats(BMP180_CONV_STATS *pStats) {
+    
+    pStats->estimate = 0;
+    pStats->minTime = 0xFF;
+    pStats->maxTime = 0;
+    pStats->count = 0;
+    pStats->totalTime = 0;
+}
+
+
+/******************************************************************************* 
+ * Function to unpack a calibration coefficient
+ ******************************************************************************/
+/*
+ * @brief This function assembles a 16-bit calibration coefficient from the 
+ * calibration block, where the MSB is stored at the lower register address.
+ * 
+ * @param pointer to the calibration block, register address of the MSB
+ * 
+ * @return The unsigned 16-bit coefficient
+ * 
+ */
+static uint16_t unpackCalWord(const uint8_t *calData, uint8_t regMsb) {
+    
+    uint8_t offset = regMsb - BMP180_CAL_COEFF_AC1_MSB;
+    
+    return (uint16_t)((uint16_t)calData[offset] << 8 | calData[offset + 1]);
+}
+
+
+/******************************************************************************* 
+ * Function to account for I2C bus traffic
+ ******************************************************************************/
+/*
+ * @brief This function adds one transaction and the given number of bytes 
+ * clocked on the bus (including address bytes) to the bus statistics. It
+ * also checks the result of the transaction if the bus binding reports it.
+ * 
+ * @param number of bytes transferred
+ * 
+ * @return True if the transaction has succeeded
+ * 
+ */
+static _Bool countBusTraffic(BMP180_PARAM *bmp180, uint8_t bytes) {
+    
+    bmp180->busStats.transactions++;
+    bmp180->busStats.bytes += bytes;
+    if (bmp180->bus->hasFailed != 0 && bmp180->bus->hasFailed()) {
+        bmp180->busStats.errors++;
+        return false;
+    }
+    
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to check the result of the last I2C1 transaction
+ ******************************************************************************/
+/*
+ * @brief This function adapts the error reporting of the I2C1 simple master
+ * to the bus binding.
+ * 
+ * @param None
+ * 
+ * @return True if the last transaction has failed after all retries
+ * 
+ */
+static _Bool hasI2C1Failed(void) {
+    
+    return i2c1_getLastError() != I2C1_NOERR;
+}
+
+
+/******************************************************************************* 
+ * Function to check the result of the last I2C2 transaction
+ ******************************************************************************/
+/*
+ * @brief This function adapts the error reporting of the I2C2 simple master
+ * to the bus binding.
+ * 
+ * @param None
+ * 
+ * @return True if the last transaction has failed after all retries
+ * 
+ */
+static _Bool hasI2C2Failed(void) {
+    
+    return i2c_getLastError() != I2C2_NOERR;
+}
+
+
 /******************************************************************************* 
  * Function to calculate the internal parameter B5
  ******************************************************************************/
@@ -212,23 +699,75 @@ uint32_t BMP180_ReadRawPressure(void) {
  * header file and the BMP180 data sheet rev 1.2
  * 
  */
-static int32_t calcB5(uint16_t rawTemperature) {
+static int32_t calcB5(BMP180_PARAM *bmp180, uint16_t rawTemperature) {
 
     int32_t x1 = 0; 
     int32_t x2 = 0;
     
     x1 = (((int32_t) rawTemperature 
-            - (int32_t) pBMP180->calibParam.ac6)
-            * (int32_t) pBMP180->calibParam.ac5) >> 15;
+            - (int32_t) bmp180->calibParam.ac6)
+            * (int32_t) bmp180->calibParam.ac5) >> 15;
     
-    if (x1 == 0 && pBMP180->calibParam.md == 0)
+    if (x1 == 0 && bmp180->calibParam.md == 0)
         return 0; // return to avoid zero division
     
-    x2 = ((int32_t) pBMP180->calibParam.mc << 11) / (x1 + pBMP180->calibParam.md);
+    x2 = ((int32_t) bmp180->calibParam.mc << 11) / (x1 + bmp180->calibParam.md);
     return x1 + x2;    
 }
 
 
+/******************************************************************************* 
+ * Function to update the temperature-dependent compensation terms
+ ******************************************************************************/
+/*
+ * @brief This function calculates B5, B3 and B4, which only depend on the 
+ * raw temperature and the calibration coefficients. The terms are cached
+ * and only recalculated if the raw temperature has changed, thus saving the 
+ * 32-bit division in calcB5() and most of the multiplications for every
+ * further pressure sample. 
+ * 
+ * @param raw temperature (uint16_t)
+ * 
+ * @return void
+ * 
+ */
+static void updateCompensation(BMP180_PARAM *bmp180, uint16_t rawTemperature) {
+    
+    BMP180_COMPENSATION *pComp = &bmp180->compensation;
+    int32_t x1 = 0;
+    int32_t x2 = 0;
+    int32_t x3 = 0;
+    int32_t b6 = 0;
+    
+    if (pComp->isValid && pComp->rawTemperature == rawTemperature)
+        return; // cached terms are still valid
+    
+    /* Calculate B5 and B6 */
+    pComp->b5 = calcB5(bmp180, rawTemperature);
+    b6 = pComp->b5 - 4000;
+    
+    /* Calculate B3 */
+    x1 = (bmp180->calibParam.b2 * ((b6 * b6) >> 12)) >> 11;
+    x2 = (bmp180->calibParam.ac2 * b6) >> 11;
+    x3 = x1 + x2;
+    pComp->b3 = ((((int32_t)bmp180->calibParam.ac1 * 4 + x3) 
+            << BMP180_OSS(bmp180)) + 2) >> 2;
+    
+    /* Calculate B4 */
+    x1 = (bmp180->calibParam.ac3 * b6) >> 13;
+    x2 = (bmp180->calibParam.b1 * ((b6 * b6) >> 12)) >> 16;
+    x3 = ((x1 + x2) + 2) >> 2;
+    pComp->b4 = (bmp180->calibParam.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+    #if BMP180_DIVISION_FREE
+        if (pComp->b4 != 0)
+            calcReciprocal(pComp->b4, &pComp->b4Reciprocal, &pComp->b4Shift);
+    #endif
+    
+    pComp->rawTemperature = rawTemperature;
+    pComp->isValid = true;
+}
+
+
 /******************************************************************************* 
  * Function to calculate the true temperature
  ******************************************************************************/
@@ -237,10 +776,12 @@ static int32_t calcB5(uint16_t rawTemperature) {
  * header file and the BMP180 data sheet rev 1.2
  * 
  */
-int16_t BMP180_CalcTemperature(uint16_t rawTemperature) {
+int16_t BMP180_CalcTemperature(BMP180_PARAM *bmp180, uint16_t rawTemperature) {
     
     int16_t temperature = 0;
-    temperature = (int16_t)((calcB5(rawTemperature) + 8) >> 4);
+    
+    updateCompensation(bmp180, rawTemperature);
+    temperature = (int16_t)((bmp180->compensation.b5 + 8) >> 4);
     
     return temperature;
 }
@@ -254,46 +795,43 @@ int16_t BMP180_CalcTemperature(uint16_t rawTemperature) {
  * header file and the BMP180 data sheet rev 1.2
  * 
  */
-int32_t BMP180_CalcPressure(uint32_t rawPressure, uint32_t rawTemperature) {
+int32_t BMP180_CalcPressure(BMP180_PARAM *bmp180, uint32_t rawPressure, 
+        uint32_t rawTemperature) {
     
     int32_t pressure = 0;
     int32_t x1 = 0;
     int32_t x2 = 0;
-    int32_t x3 = 0;
-    int32_t b3 = 0;
-    int32_t b6 = 0;
     uint32_t b4 = 0;
     uint32_t b7 = 0;
     
-    /* Calculate B6 */
-    b6 = calcB5(rawTemperature) - 4000;
-    
-    /* Calculate B3 */
-    x1 = (pBMP180->calibParam.b2 * ((b6 * b6) >> 12)) >> 11;
-    x2 = (pBMP180->calibParam.ac2 * b6) >> 11;
-    x3 = x1 + x2;
-    b3 = ((((int32_t)pBMP180->calibParam.ac1 * 4 + x3) 
-            << pBMP180->oversampling) + 2) >> 2;
-    
-    /* Calculate B4 */
-    x1 = (pBMP180->calibParam.ac3 * b6) >> 13;
-    x2 = (pBMP180->calibParam.b1 * ((b6 * b6) >> 12)) >> 16;
-    x3 = ((x1 + x2) + 2) >> 2;
-    b4 = (pBMP180->calibParam.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+    /* Get B3 and B4, which only depend on the raw temperature */
+    updateCompensation(bmp180, (uint16_t) rawTemperature);
+    b4 = bmp180->compensation.b4;
     
     /* Calculate B7 */
-    b7 = ((uint32_t)(rawPressure - b3))
-            * (50000 >> pBMP180->oversampling);
+    b7 = ((uint32_t)(rawPressure - bmp180->compensation.b3))
+            * (50000 >> BMP180_OSS(bmp180));
    
     
     /* Calculate pressure in Pa */
     if (b4 == 0) 
         return 0;  // return to avoid zero division          
 
-    if (b7 < 0x80000000) 
-        pressure = (b7 << 1) / b4;
-    else
-        pressure = (b7 / b4) << 1;
+    #if BMP180_DIVISION_FREE
+        if (b7 < 0x80000000) 
+            pressure = divideByReciprocal(b7 << 1, b4, 
+                    bmp180->compensation.b4Reciprocal, 
+                    bmp180->compensation.b4Shift);
+        else
+            pressure = divideByReciprocal(b7, b4, 
+                    bmp180->compensation.b4Reciprocal, 
+                    bmp180->compensation.b4Shift) << 1;
+    #else
+        if (b7 < 0x80000000) 
+            pressure = (b7 << 1) / b4;
+        else
+            pressure = (b7 / b4) << 1;
+    #endif
     x1 = (pressure >> 8);
     x1 *= x1;
     x1 = (x1 * 3038) >> 16;
@@ -314,11 +852,190 @@ int32_t BMP180_CalcPressure(uint32_t rawPressure, uint32_t rawTemperature) {
  */
 int16_t BMP180_CalcAltitude(int32_t pressure) {
     
-    // The mean sea-level atmospheric pressure on Earth is 101,325 Pa
-    const float seaLevelPressure = 101325; 
-    float altitude;
+    // Round the altitude in 1/1024 m to the nearest metre
+    return (int16_t)((calcAltitudeFixed(pressure) 
+            + (1 << (BMP180_ALT_TABLE_STEP_SHIFT - 1))) 
+            >> BMP180_ALT_TABLE_STEP_SHIFT);
+}
+
+
+/******************************************************************************* 
+ * Function to calculate the absolute altitude in centimetres
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+int32_t BMP180_CalcAltitudeCm(int32_t pressure) {
+    
+    // Scale the altitude in 1/1024 m to cm and round to the nearest cm
+    return (calcAltitudeFixed(pressure) * 100 
+            + (1 << (BMP180_ALT_TABLE_STEP_SHIFT - 1))) 
+            >> BMP180_ALT_TABLE_STEP_SHIFT;
+}
+
+
+/******************************************************************************* 
+ * Function to interpolate the altitude from the lookup table
+ ******************************************************************************/
+/*
+ * @brief This function interpolates linearly between the two table entries 
+ * neighbouring the provided pressure.
+ * 
+ * @param pressure in Pa (int32_t)
+ * 
+ * @return The altitude in 1/1024 m (int32_t)
+ * 
+ */
+static int32_t calcAltitudeFixed(int32_t pressure) {
+    
+    uint8_t index;
+    int32_t offset; // pressure offset within the table segment [Pa]
+    
+    /* Clamp the pressure to the range covered by the lookup table */
+    if (pressure < BMP180_ALT_TABLE_PRESSURE_MIN)
+        pressure = BMP180_ALT_TABLE_PRESSURE_MIN;
+    offset = pressure - BMP180_ALT_TABLE_PRESSURE_MIN;
+    index = (uint8_t)(offset >> BMP180_ALT_TABLE_STEP_SHIFT);
+    if (index >= BMP180_ALT_TABLE_SIZE - 1) {
+        index = BMP180_ALT_TABLE_SIZE - 2;
+        offset = (int32_t)(BMP180_ALT_TABLE_SIZE - 1) 
+                << BMP180_ALT_TABLE_STEP_SHIFT;
+    }
+    offset -= (int32_t) index << BMP180_ALT_TABLE_STEP_SHIFT;
+    
+    return ((int32_t) altitudeTable[index] << BMP180_ALT_TABLE_STEP_SHIFT)
+            + (int32_t)(altitudeTable[index + 1] - altitudeTable[index]) 
+            * offset;
+}
+
+
+#if BMP180_DIVISION_FREE
+/******************************************************************************* 
+ * Function to multiply two 32-bit values and return the upper 32 bits
+ ******************************************************************************/
+/*
+ * @brief This function calculates the upper half of the 64-bit product from
+ * four 16 x 16-bit partial products, thus no 64-bit arithmetic is required.
+ * 
+ * @param factors a and b (uint32_t)
+ * 
+ * @return The upper 32 bits of the product a * b
+ * 
+ */
+static uint32_t mulHigh32(uint32_t a, uint32_t b) {
+    
+    uint16_t aHigh = (uint16_t)(a >> 16);
+    uint16_t aLow = (uint16_t) a;
+    uint16_t bHigh = (uint16_t)(b >> 16);
+    uint16_t bLow = (uint16_t) b;
+    uint32_t crossHigh = (uint32_t) aHigh * bLow;
+    uint32_t crossLow = (uint32_t) aLow * bHigh;
+    uint32_t middle;
+    
+    /* Sum up the bits 16 to 47 of the partial products to obtain the carry 
+     * into the upper half */
+    middle = (((uint32_t) aLow * bLow) >> 16) + (uint16_t) crossHigh 
+            + (uint16_t) crossLow;
+    
+    return (uint32_t) aHigh * bHigh + (crossHigh >> 16) + (crossLow >> 16) 
+            + (middle >> 16);
+}
+
+
+/******************************************************************************* 
+ * Function to calculate the reciprocal of a divisor
+ ******************************************************************************/
+/*
+ * @brief This function calculates the reciprocal 2^(32 + shift) / divisor, 
+ * where shift is the position of the most significant bit of the divisor. 
+ * The divisor is normalised to [2^31, 2^32), an initial estimate is taken 
+ * from a table and refined by three Newton iterations y = y * (2 - d * y), 
+ * which each double the number of correct bits (4 -> 8 -> 16 -> 32). The 
+ * result is finally decreased by a small margin, so that it never exceeds 
+ * the exact reciprocal despite the truncation in each iteration.
+ * 
+ * @param divisor (uint32_t) other than 0, pointers to the reciprocal and the
+ * shift to be used by divideByReciprocal()
+ * 
+ * @return void
+ * 
+ */
+static void calcReciprocal(uint32_t divisor, uint32_t *pReciprocal, 
+        uint8_t *pShift) {
+    
+    uint32_t normalised = divisor;
+    uint32_t reciprocal;
+    uint32_t error;
+    uint32_t next;
+    uint8_t shift = 31;
+    
+    /* Normalise the divisor so that its most significant bit is bit 31 */
+    while (!(normalised & 0x80000000)) {
+        normalised <<= 1;
+        shift--;
+    }
+    
+    /* Refine the estimate of 2^63 / normalised; an estimate y below the 
+     * exact value yields error = 2^31 - normalised * y / 2^32 >= 0 */
+    reciprocal = (uint32_t) reciprocalTable[(normalised >> 27) & 0x0F] << 16;
+    for (uint8_t i = 0; i < 3; i++) {
+        error = 0x80000000 - mulHigh32(normalised, reciprocal);
+        if (error & 0x80000000)
+            break; // estimate already exceeds the exact value
+        next = reciprocal + (mulHigh32(reciprocal, error) << 1);
+        if (next < reciprocal) {
+            reciprocal = 0xFFFFFFFF; // limit to the range of 32 bits
+            break;
+        }
+        reciprocal = next;
+    }
+    
+    *pReciprocal = reciprocal - 8;
+    *pShift = shift;
+}
+
+
+/******************************************************************************* 
+ * Function to divide by multiplying with a reciprocal
+ ******************************************************************************/
+/*
+ * @brief This function divides two unsigned 32-bit values using the 
+ * reciprocal of the divisor provided by calcReciprocal(). The estimate
+ * mulHigh32(dividend, reciprocal) >> shift never exceeds the exact quotient:
+ * the reciprocal is at most 2^(32 + shift) / divisor and both the product 
+ * and the shift round down. As the reciprocal falls short of the exact value
+ * by less than 16, the estimate falls short by less than 
+ * 1 + 16 * dividend / 2^(32 + shift), i.e. by at most two for a shift of at
+ * least BMP180_RECIPROCAL_MIN_SHIFT. Hence, comparing the remainder against
+ * the divisor twice yields the result of the integer division dividend / 
+ * divisor. Smaller divisors, which only result from a corrupt calibration,
+ * are divided directly. Both bounds are asserted for every divisor up to 
+ * 2^17 and a sample of the larger ones by host/bmp180_division_host_test.c.
+ * 
+ * @param dividend, divisor, reciprocal and shift of the divisor
+ * 
+ * @return The quotient rounded down (uint32_t)
+ * 
+ */
+static uint32_t divideByReciprocal(uint32_t dividend, uint32_t divisor, 
+        uint32_t reciprocal, uint8_t shift) {
+    
+    uint32_t quotient;
+    uint32_t remainder;
     
-    altitude = 44330 * (1.0 - pow(pressure / seaLevelPressure, 0.1903));
+    if (shift < BMP180_RECIPROCAL_MIN_SHIFT)
+        return dividend / divisor;
+    
+    quotient = mulHigh32(dividend, reciprocal) >> shift;
+    remainder = dividend - quotient * divisor;
+    for (uint8_t i = 0; i < BMP180_RECIPROCAL_MAX_CORRECTION 
+            && remainder >= divisor; i++) {
+        remainder -= divisor;
+        quotient++;
+    }
     
-    return (int16_t) altitude;
+    return quotient;
 }
+#endif
@@ -23,7 +23,6 @@
 #define	BMP180_H
 
 #include "mcc_generated_files/mcc.h"
-#include <math.h>
 
  /* I2C address definition */
 #define BMP180_I2C_ADDR                     0x77
@@ -59,6 +58,12 @@ typedef enum {
 #define BMP180_CTRL_MEAS_VAL_OSS_2          0xB4 // Pressure (oss = 2)
 #define BMP180_CTRL_MEAS_VAL_OSS_3          0xF4 // Pressure (oss = 3)
 
+/* Start of conversion (SCO) bit of the control register. It remains set while
+ * a conversion is running and is cleared by the sensor once it has completed */
+#define BMP180_CTRL_MEAS_SCO_BIT            0x20
+/* Upper limit of the interval between two polls of the SCO bit [ms] */
+#define BMP180_SCO_POLL_BACKOFF_MAX         4
+
 /* Note: According to the BMP180 data sheet, the max. conversion time depends
  * on the oversampling setting (oss). For oss = 0 the max. conversion time is
  * 5 ms */
@@ -68,6 +73,32 @@ typedef enum {
 #define BMP180_CONV_TIME_OSS_2              14  
 #define BMP180_CONV_TIME_OSS_3              26  
 
+/* Build-time selection of the oversampling setting (0 to 3). If set, the 
+ * oversampling member of every sensor is overridden at initialisation and 
+ * the pressure path is compiled with constant shifts, control register value
+ * and conversion time. Variable shifts are compiled to loops on the PIC18, so
+ * this saves cycles on every sample. BMP180_OSS_RUNTIME keeps the setting 
+ * selectable per sensor at runtime. */
+#define BMP180_OSS_RUNTIME                  0xFF
+#define BMP180_FIXED_OSS                    BMP180_OSS_RUNTIME
+
+/* Set to 1 to divide by B4 with a reciprocal, which is calculated once per 
+ * raw temperature, instead of a 32-bit software division per pressure 
+ * sample. Both kernels return identical results. */
+#ifndef BMP180_DIVISION_FREE
+#define BMP180_DIVISION_FREE                1
+#endif
+
+/* Default schedule for refreshing the raw temperature: temperature changes 
+ * slowly, so it is only converted once every N pressure samples or once the
+ * refresh period has elapsed, whichever comes first */
+#define BMP180_TEMP_REFRESH_SAMPLES         8
+#define BMP180_TEMP_REFRESH_PERIOD          1000 // [ms]
+
+/* Interval between two initialisation attempts if the sensor doesn't respond.
+ * Each attempt is bounded by the timeouts and retries of the I2C bus. */
+#define BMP180_INIT_RETRY_PERIOD            1000 // [ms]
+
 /* Register addresses for calibration coefficients */
 #define BMP180_CAL_DATA_SIZE                22 // in bytes
 #define BMP180_CAL_COEFF_AC1_MSB            0xAA    
@@ -105,6 +136,17 @@ typedef enum {
 
 #define BMP180_ALTITUDE_SCALE_FACTOR        443
 
+/* Altitude lookup table covering the sensor range of 300 to 1100 hPa */
+#define BMP180_ALT_TABLE_PRESSURE_MIN       30000 // pressure of entry 0 [Pa]
+#define BMP180_ALT_TABLE_STEP_SHIFT         10 // 2^10 = 1024 Pa per entry
+#define BMP180_ALT_TABLE_SIZE               80
+
+/* Bytes clocked on the bus in addition to the payload: slave address (write),
+ * register address and slave address (read) after the repeated start */
+#define BMP180_I2C_REG_READ_OVERHEAD        3
+/* Bytes clocked on the bus for writing a single register */
+#define BMP180_I2C_REG_WRITE_BYTES          3
+
 /* Data structure that holds device specific calibration parameters */
 typedef struct bmp180_cal_coeff_t
 {
@@ -122,18 +164,100 @@ typedef struct bmp180_cal_coeff_t
 } BMP180_CAL_COEFF;
 
 
-/* Data structure that holds the BMP180 initialisation parameters */
+/* Data structure that holds the I2C bus statistics of the sensor. After 
+ * invoking BMP180_Init(), these figures reflect the boot-time bus cost. */
+typedef struct bmp180_bus_stats_t
+{
+    uint16_t    transactions; // number of I2C start/stop transactions
+    uint16_t    bytes; // number of bytes clocked on the bus
+    uint16_t    errors; // transactions failed after all retries of the bus
+} BMP180_BUS_STATS;
+
+/* Data structure that holds the compensation terms, which only depend on the
+ * raw temperature UT and the calibration coefficients */
+typedef struct bmp180_compensation_t
+{
+    uint16_t    rawTemperature; // UT the cached terms are valid for
+    int32_t     b5;
+    int32_t     b3;
+    uint32_t    b4;
+    uint32_t    b4Reciprocal; // 2^(32 + b4Shift) / B4, rounded down
+    uint8_t     b4Shift; // position of the most significant bit of B4
+    _Bool       isValid;
+} BMP180_COMPENSATION;
+
+/* Data structure that holds the observed conversion times of one type of
+ * conversion when polling the SCO bit. The mean is totalTime / count. */
+typedef struct bmp180_conv_stats_t
+{
+    uint8_t     estimate; // learned conversion time [ms]
+    uint8_t     minTime; // [ms]
+    uint8_t     maxTime; // [ms]
+    uint16_t    count; // number of completed conversions
+    uint32_t    totalTime; // sum of all conversion times [ms]
+} BMP180_CONV_STATS;
+
+/* Type of the conversion currently in progress */
+typedef enum {
+    BMP180_CONV_NONE,
+    BMP180_CONV_TEMPERATURE,
+    BMP180_CONV_PRESSURE
+} BMP180_CONV_TYPE;
+
+/* Bus interface a sensor is bound to. The functions follow the signatures
+ * of the I2C Foundation Services simple master, so that each MSSP instance 
+ * generated by MCC can be bound by listing its helper functions. The 
+ * optional hasFailed function reports whether the last transaction has 
+ * failed despite the retries of the bus; without it, every transaction is
+ * assumed to succeed. */
+typedef struct bmp180_bus_t
+{
+    uint8_t (*read1ByteRegister)(uint8_t address, uint8_t reg);
+    void (*write1ByteRegister)(uint8_t address, uint8_t reg, uint8_t data);
+    void (*writeNBytes)(uint8_t address, void *data, size_t len);
+    void (*readNBytes)(uint8_t address, void *data, size_t len);
+    void (*readDataBlock)(uint8_t address, uint8_t reg, void *data, 
+            size_t len);
+    _Bool (*hasFailed)(void);
+} BMP180_BUS;
+
+/* Data structure that holds the BMP180 initialisation parameters. Each 
+ * sensor has its own instance, which is passed as handle to every function
+ * of this API. Hence, several sensors can be operated concurrently. */
 typedef struct bmp180_param_t
 {
     BMP180_CAL_COEFF        calibParam;
     BMP180_OVERSAMPLING     oversampling;
+    _Bool                   scoPolling; // poll SCO bit instead of waiting
+    uint8_t                 tempRefreshSamples; // pressure samples per UT
+    uint16_t                tempRefreshPeriod; // max. age of UT [ms], 0 = off
     uint8_t                 ossCtrlRegValue;
+    uint8_t                 ossConvTime; // pressure conversion time [ms]
     uint8_t                 chipId;
-    uint8_t                 deviceAddr;
+    uint8_t                 deviceAddr; // 0 = BMP180_I2C_ADDR
+    const BMP180_BUS        *bus; // 0 = bmp180BusI2C2
+    BMP180_CONV_TYPE        convType; // conversion in progress
+    uint8_t                 convTime; // max. time of this conversion [ms]
+    uint16_t                convStartTick; // tick when conversion started
+    BMP180_BUS_STATS        busStats;
+    BMP180_COMPENSATION     compensation;
+    uint8_t                 nextPollTime; // elapsed time of next SCO poll
+    uint8_t                 pollBackoff; // interval to the next SCO poll
+    _Bool                   isFirstPoll;
+    BMP180_CONV_STATS       tempConvStats;
+    BMP180_CONV_STATS       pressConvStats;
+    uint16_t                lastRawTemperature;
+    uint16_t                lastTemperatureTick;
+    uint8_t                 samplesSinceTemperature;
+    _Bool                   hasRawTemperature;
 } BMP180_PARAM; 
 
 typedef int32_t fixed_point_t;
 
+/* Bus bindings of sensors connected to the MSSP1 (I2C1) and MSSP2 (I2C2) */
+extern const BMP180_BUS bmp180BusI2C1;
+extern const BMP180_BUS bmp180BusI2C2;
+
 /******************************************************************************* 
  * Function to initialise the communication with the BMP180 sensor
  ******************************************************************************/
@@ -141,7 +265,9 @@ typedef int32_t fixed_point_t;
  * @brief This function is used to initialise the communication with the BMP180
  * sensor by reading calibration coefficients from its internal EEPROM
  * 
- * @param bmp180 -> pointer to BMP180 data structure 
+ * @param bmp180 -> pointer to BMP180 data structure; the members bus and
+ * deviceAddr select the bus binding, by default the sensor is expected at
+ * BMP180_I2C_ADDR on the I2C2 bus
  * 
  * @return the result of invoking the initialisation routine
  * @retval 0 -> success
@@ -149,7 +275,8 @@ typedef int32_t fixed_point_t;
  * @retval 2 -> failed; couldn't establish communication with the sensor
  * 
  * @note
- * The following calibration parameters are read from the sensor's EEPROM:
+ * The following calibration parameters are read from the sensor's EEPROM 
+ * in a single burst transaction starting at register 0xAA:
  *  Parameter  |  MSB    |  LSB    
  * ------------|---------|---------
  *      AC1    |  0xAA   | 0xAB
@@ -175,12 +302,12 @@ uint8_t BMP180_Init(BMP180_PARAM *bmp180);
  * @brief This function is used to read the uncompensated temperature from the
  * registers 0xF6 and 0xF7
  * 
- * @param None
+ * @param bmp180 -> pointer to BMP180 data structure
  * 
  * @return The uncompensated temperature
  * 
 */
-uint16_t BMP180_ReadRawTemperature(void);
+uint16_t BMP180_ReadRawTemperature(BMP180_PARAM *bmp180);
 
 
 /******************************************************************************* 
@@ -190,13 +317,156 @@ uint16_t BMP180_ReadRawTemperature(void);
  * @brief This function is used to read the uncompensated temperature from the
  * registers 0xF6 (MSB), 0xF7 (LSB), and 0xF8 (XLSB) 
  * 
- * @param None
+ * @param bmp180 -> pointer to BMP180 data structure
  * 
  * @return The uncompensated pressure
  * 
 */
 
-uint32_t BMP180_ReadRawPressure(void);
+uint32_t BMP180_ReadRawPressure(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to start a temperature conversion
+ ******************************************************************************/
+/*
+ * @brief This function starts a temperature conversion and returns 
+ * immediately without waiting for the conversion to complete. Once 
+ * BMP180_IsConversionComplete() returns true, the result can be collected by
+ * invoking BMP180_CollectRawTemperature().
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return the result of starting the conversion
+ * @retval 0 -> success
+ * @retval 1 -> failed; another conversion is still in progress
+ * @retval 2 -> failed; the control register couldn't be written
+ * 
+*/
+uint8_t BMP180_StartTemperatureConversion(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to start a pressure conversion
+ ******************************************************************************/
+/*
+ * @brief This function starts a pressure conversion using the oversampling
+ * setting provided at initialisation and returns immediately without waiting
+ * for the conversion to complete. Once BMP180_IsConversionComplete() returns 
+ * true, the result can be collected by invoking BMP180_CollectRawPressure().
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return the result of starting the conversion
+ * @retval 0 -> success
+ * @retval 1 -> failed; another conversion is still in progress
+ * @retval 2 -> failed; the control register couldn't be written
+ * 
+*/
+uint8_t BMP180_StartPressureConversion(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to check whether the conversion in progress has completed
+ ******************************************************************************/
+/*
+ * @brief This function checks, based on the millisecond timebase, whether 
+ * the max. conversion time of the conversion in progress has elapsed.
+ * If scoPolling was enabled before initialisation, the SCO bit of the 
+ * control register is polled instead, starting at the learned conversion 
+ * time and backing off while the conversion is still running. The observed
+ * conversion times are recorded in tempConvStats and pressConvStats.
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return True if the conversion has completed or no conversion is pending
+ * 
+*/
+_Bool BMP180_IsConversionComplete(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to check whether the conversion in progress is due to be checked
+ ******************************************************************************/
+/*
+ * @brief This function checks, without accessing the sensor, whether 
+ * BMP180_IsConversionComplete() would access the sensor or report the 
+ * completion, i.e. whether the max. conversion time or, if scoPolling is 
+ * enabled, the next poll time has elapsed. It allows the caller to idle 
+ * until then.
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return True if the conversion is due to be checked or no conversion is 
+ * pending
+ * 
+*/
+_Bool BMP180_IsConversionDue(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to collect the uncompensated temperature
+ ******************************************************************************/
+/*
+ * @brief This function reads the result of a completed temperature conversion
+ * from the registers 0xF6 (MSB) and 0xF7 (LSB)
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return The uncompensated temperature or BMP180_INVALID_DATA if no 
+ * temperature conversion was started or the result couldn't be read
+ * 
+*/
+uint16_t BMP180_CollectRawTemperature(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to collect the uncompensated pressure
+ ******************************************************************************/
+/*
+ * @brief This function reads the result of a completed pressure conversion
+ * from the registers 0xF6 (MSB), 0xF7 (LSB), and 0xF8 (XLSB)
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return The uncompensated pressure or BMP180_INVALID_DATA if no pressure 
+ * conversion was started or the result couldn't be read
+ * 
+*/
+uint32_t BMP180_CollectRawPressure(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to check whether the raw temperature needs to be refreshed
+ ******************************************************************************/
+/*
+ * @brief Temperature changes slowly, so the raw temperature doesn't need to
+ * be converted before every pressure sample. This function indicates whether
+ * a new temperature conversion is due according to the schedule configured 
+ * by tempRefreshSamples and tempRefreshPeriod. Otherwise, the result of
+ * BMP180_GetLastRawTemperature() can be used to compensate the pressure.
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return True if a temperature conversion is due
+ * 
+*/
+_Bool BMP180_IsTemperatureRefreshDue(BMP180_PARAM *bmp180);
+
+
+/******************************************************************************* 
+ * Function to get the most recent raw temperature
+ ******************************************************************************/
+/*
+ * @brief This function returns the raw temperature of the most recently 
+ * collected temperature conversion
+ * 
+ * @param bmp180 -> pointer to BMP180 data structure
+ * 
+ * @return The uncompensated temperature
+ * 
+*/
+uint16_t BMP180_GetLastRawTemperature(BMP180_PARAM *bmp180);
 
 
 /******************************************************************************* 
@@ -207,13 +477,14 @@ uint32_t BMP180_ReadRawPressure(void);
  * on the provided raw temperature. Therefore, the raw temperature must be read
  * before invoking. 
  * 
- * @param The result from invoking BMP180_ReadRawPressure(void)
+ * @param bmp180 -> pointer to BMP180 data structure
+ * @param The result from invoking BMP180_ReadRawTemperature(...)
  * 
  * @return The true temperature as a 16-bit signed integer in 0.1 Celsius degree
  * steps
  * 
 */
-int16_t BMP180_CalcTemperature(uint16_t rawTemperature);
+int16_t BMP180_CalcTemperature(BMP180_PARAM *bmp180, uint16_t rawTemperature);
 
 
 /******************************************************************************* 
@@ -222,14 +493,19 @@ int16_t BMP180_CalcTemperature(uint16_t rawTemperature);
 /*
  * @brief This function calculates the true pressure based on the provided
  * raw pressure and raw temperature. Therefore, these parameters must be read 
- * before invoking this function. 
+ * before invoking this function. The temperature-dependent terms B3 and B4
+ * are cached, so consecutive pressure samples with the same raw temperature
+ * only require the pressure-dependent part of the calculation.
  * 
- * @param The result from invoking BMP180_ReadRawPressure(void)
+ * @param bmp180 -> pointer to BMP180 data structure
+ * @param The results from invoking BMP180_ReadRawPressure(...) and 
+ * BMP180_ReadRawTemperature(...)
  * 
  * @return The true pressure in Pa as a 32-bit signed integer
  * 
 */
-int32_t BMP180_CalcPressure(uint32_t rawPressure, uint32_t rawTemperature);
+int32_t BMP180_CalcPressure(BMP180_PARAM *bmp180, uint32_t rawPressure, 
+        uint32_t rawTemperature);
 
 
 /******************************************************************************* 
@@ -242,6 +518,11 @@ int32_t BMP180_CalcPressure(uint32_t rawPressure, uint32_t rawTemperature);
  * altitude = 44330 * (1 - (p/p0)^(1/5.255))
  * 
  * where p0 = 101325 Pa which is equivalent to 1013.25 hPa and 1013.25 millibar
+ * 
+ * To avoid the floating point pow() function, integer arithmetic only is used
+ * to interpolate linearly between entries of a lookup table. Compared to the 
+ * exact formula, the error is less than 1.5 m over the range of 30000 to
+ * 110000 Pa. Pressure values below this range are clamped to 30000 Pa.
  *
  * @param The true pressure; result from invoking BMP180_CalcPressure(...)
  * 
@@ -251,6 +532,23 @@ int32_t BMP180_CalcPressure(uint32_t rawPressure, uint32_t rawTemperature);
 int16_t BMP180_CalcAltitude(int32_t pressure);
 
 
+/******************************************************************************* 
+ * Function to calculate the absolute altitude in centimetres
+ ******************************************************************************/
+/*
+ * @brief This function calculates the absolute altitude like 
+ * BMP180_CalcAltitude(), but keeps the fraction of the interpolation. The 
+ * absolute error remains the same, but the result changes smoothly with the
+ * pressure, which makes it suitable for relative altitude measurements.
+ *
+ * @param The true pressure; result from invoking BMP180_CalcPressure(...)
+ * 
+ * @return The absolute altitude in centimetres as 32-bit signed integer
+ * 
+*/
+int32_t BMP180_CalcAltitudeCm(int32_t pressure);
+
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
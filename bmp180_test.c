@@ -15,8 +15,10 @@
  * 
 */
 
+#include <math.h>
 #include "mcc_generated_files/mcc.h"
 #include "bmp180.h"
+#include "tick.h"
 
 #if BMP180_DEBUG_COMPILE_TEST
     BMP180_PARAM bmp180;
@@ -25,8 +27,19 @@
 
     extern int32_t calculateAltitude(uint32_t pressure);
 
+    /* Prints the I2C traffic of a single read, i.e. the conversion start,
+     * the SCO polls if enabled and the result read */
+    static void printBusTraffic(const BMP180_BUS_STATS *pBefore, 
+            const BMP180_BUS_STATS *pAfter){
+
+        printf("BMP180 - read I2C transactions: %u, bytes: %u\n",
+                pAfter->transactions - pBefore->transactions,
+                pAfter->bytes - pBefore->bytes);
+    }
+
     void BMP180_TestRoutine(void){
 
+        BMP180_BUS_STATS busStats;
         uint16_t rawTemperature;
         uint32_t rawPressure;
         int16_t temperature;
@@ -37,22 +50,29 @@
             initialiseSensor = false;
             initResult = BMP180_Init(&bmp180);
             printf("BMP180 initialisation result: %d\n", initResult);
+            printf("BMP180 - boot I2C transactions: %u, bytes: %u\n",
+                    bmp180.busStats.transactions, bmp180.busStats.bytes);
         }
 
         __delay_ms(100);
 
         if (initResult == 0){
 
-            rawTemperature = BMP180_ReadRawTemperature();
+            busStats = bmp180.busStats;
+            rawTemperature = BMP180_ReadRawTemperature(&bmp180);
             printf("BMP180 - raw temperature: %d\n", rawTemperature);
+            printBusTraffic(&busStats, &bmp180.busStats);
 
-            rawPressure = BMP180_ReadRawPressure();
+            busStats = bmp180.busStats;
+            rawPressure = BMP180_ReadRawPressure(&bmp180);
             printf("BMP180 - raw pressure: %ld\n", rawPressure);
+            printBusTraffic(&busStats, &bmp180.busStats);
 
-            temperature = BMP180_CalcTemperature(rawTemperature);
+            temperature = BMP180_CalcTemperature(&bmp180, rawTemperature);
             printf("BMP180 - temperature: %d\n", temperature);        
 
-            pressure = BMP180_CalcPressure(rawPressure, rawTemperature);
+            pressure = BMP180_CalcPressure(&bmp180, rawPressure, 
+                    rawTemperature);
             printf("BMP180 - pressure: %ld\n", pressure);
 
             altitude = BMP180_CalcAltitude(pressure);
@@ -70,4 +90,232 @@
 
 
     }
+
+    /* Runs one temperature and one OSS3 pressure conversion using the 
+     * non-blocking API and counts how often the loop body could run in the 
+     * meantime. A blocking driver would yield a count of 0. */
+    void BMP180_TestNonBlockingRoutine(void){
+
+        uint32_t loopCount = 0;
+        uint16_t startTick;
+        uint16_t rawTemperature;
+        uint32_t rawPressure;
+
+        bmp180.oversampling = BMP180_MODE_ULTRAHIGHRESOLUTION;
+        bmp180.scoPolling = true;
+        if (BMP180_Init(&bmp180) != 0) {
+            printf("BMP180 initialisation failed\n");
+            return;
+        }
+
+        startTick = getTickMs();
+        BMP180_StartTemperatureConversion(&bmp180);
+        while (!BMP180_IsConversionComplete(&bmp180))
+            loopCount++;
+        rawTemperature = BMP180_CollectRawTemperature(&bmp180);
+
+        BMP180_StartPressureConversion(&bmp180);
+        while (!BMP180_IsConversionComplete(&bmp180))
+            loopCount++;
+        rawPressure = BMP180_CollectRawPressure(&bmp180);
+
+        printf("BMP180 - OSS3 cycle: %u ms, %lu loop iterations\n",
+                (uint16_t)(getTickMs() - startTick), 
+                (unsigned long) loopCount);
+        printf("BMP180 - temperature: %d, pressure: %ld\n",
+                BMP180_CalcTemperature(&bmp180, rawTemperature),
+                BMP180_CalcPressure(&bmp180, rawPressure, rawTemperature));
+        printf("BMP180 - OSS3 conversion min/max: %u/%u ms, estimate: %u ms\n",
+                bmp180.pressConvStats.minTime, bmp180.pressConvStats.maxTime,
+                bmp180.pressConvStats.estimate);
+        printf("----------------------------------\n");
+
+        __delay_ms(2000);
+    }
+
+    /* Compares the integer altitude kernel against the floating point 
+     * barometric formula over the sensor range of 30000 to 110000 Pa and 
+     * measures the execution time of both over the same sweep. */
+    void BMP180_TestAltitudeRoutine(void){
+
+        const float seaLevelPressure = 101325;
+        int32_t pressure;
+        int16_t altitude;
+        float reference;
+        float error;
+        float maxError = 0;
+        int32_t maxErrorPressure = 0;
+        uint16_t startTick;
+        uint16_t kernelTime;
+        uint16_t referenceTime;
+
+        for (pressure = 30000; pressure <= 110000; pressure += 10) {
+            altitude = BMP180_CalcAltitude(pressure);
+            reference = 44330 * (1.0 - pow(pressure / seaLevelPressure, 
+                    0.1903));
+            error = fabs(altitude - reference);
+            if (error > maxError) {
+                maxError = error;
+                maxErrorPressure = pressure;
+            }
+        }
+        printf("BMP180 - altitude max. error: %.2f m at %ld Pa\n", maxError, 
+                maxErrorPressure);
+
+        startTick = getTickMs();
+        for (pressure = 30000; pressure <= 110000; pressure += 80) 
+            altitude = BMP180_CalcAltitude(pressure);
+        kernelTime = getTickMs() - startTick;
+
+        startTick = getTickMs();
+        for (pressure = 30000; pressure <= 110000; pressure += 80) 
+            altitude = (int16_t)(44330 * (1.0 - pow(pressure 
+                    / seaLevelPressure, 0.1903)));
+        referenceTime = getTickMs() - startTick;
+
+        printf("BMP180 - 1001 altitudes: kernel %u ms, pow() %u ms\n", 
+                kernelTime, referenceTime);
+        printf("----------------------------------\n");
+
+        __delay_ms(2000);
+    }
+
+    /* Measures the execution time of the per-sample pressure compensation 
+     * with cached temperature terms, averaged over 1000 samples. Build once 
+     * with BMP180_FIXED_OSS = BMP180_OSS_RUNTIME and once per fixed oss to 
+     * obtain the cycle deltas; the flash deltas are given by the program 
+     * memory figures of the XC8 memory summary of these builds. */
+    void BMP180_TestSpecialisationRoutine(void){
+
+        const uint16_t rawTemperature = 27898;
+        uint16_t startTick;
+        uint16_t elapsed;
+        int32_t pressure = 0;
+
+        #if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+            printf("BMP180 - oss selected at runtime: %u\n", 
+                    bmp180.oversampling);
+        #else
+            printf("BMP180 - oss fixed at build time: %u\n", 
+                    BMP180_FIXED_OSS);
+        #endif
+
+        (void) BMP180_CalcPressure(&bmp180, 23843, rawTemperature);
+        startTick = getTickMs();
+        for (uint16_t i = 0; i < 1000; i++)
+            pressure += BMP180_CalcPressure(&bmp180, 23000 + i, 
+                    rawTemperature);
+        elapsed = getTickMs() - startTick;
+
+        // 1 ms for 1000 samples = 1 us per sample = 4 instruction cycles
+        printf("BMP180 - CalcPressure: %u us, %u cycles per sample\n",
+                elapsed, elapsed * 4);
+        printf("BMP180 - checksum: %ld\n", pressure);
+        printf("----------------------------------\n");
+
+        __delay_ms(2000);
+    }
+
+    /* Data sheet algorithm of the temperature-dependent terms B3 and B4 and 
+     * of the true temperature, used as reference for the compensation */
+    static int16_t calcReferenceTerms(const BMP180_CAL_COEFF *cal, 
+            uint8_t oss, uint16_t rawTemperature, int32_t *pB3, 
+            uint32_t *pB4) {
+
+        int32_t x1, x2, x3, b5, b6;
+
+        x1 = (((int32_t) rawTemperature - (int32_t) cal->ac6) 
+                * (int32_t) cal->ac5) >> 15;
+        x2 = ((int32_t) cal->mc << 11) / (x1 + cal->md);
+        b5 = x1 + x2;
+        b6 = b5 - 4000;
+        x1 = (cal->b2 * ((b6 * b6) >> 12)) >> 11;
+        x2 = (cal->ac2 * b6) >> 11;
+        x3 = x1 + x2;
+        *pB3 = ((((int32_t) cal->ac1 * 4 + x3) << oss) + 2) >> 2;
+        x1 = (cal->ac3 * b6) >> 13;
+        x2 = (cal->b1 * ((b6 * b6) >> 12)) >> 16;
+        x3 = ((x1 + x2) + 2) >> 2;
+        *pB4 = (cal->ac4 * (uint32_t)(x3 + 32768)) >> 15;
+
+        return (int16_t)((b5 + 8) >> 4);
+    }
+
+    /* Data sheet algorithm of the true pressure */
+    static int32_t calcReferencePressure(uint32_t rawPressure, uint8_t oss,
+            int32_t b3, uint32_t b4) {
+
+        int32_t pressure, x1, x2;
+        uint32_t b7;
+
+        b7 = ((uint32_t)(rawPressure - b3)) * (50000 >> oss);
+        if (b7 < 0x80000000) 
+            pressure = (b7 << 1) / b4;
+        else
+            pressure = (b7 / b4) << 1;
+        x1 = (pressure >> 8);
+        x1 *= x1;
+        x1 = (x1 * 3038) >> 16;
+        x2 = (-7357 * pressure) >> 16;
+        pressure += (x1 + x2 + 3791) >> 4;
+
+        return pressure;
+    }
+
+    /* Compares BMP180_CalcPressure() against the data sheet algorithm for 
+     * every raw pressure of each oversampling setting and every raw 
+     * temperature within the operating range of -40 to +85 Celsius degree,
+     * using the calibration coefficients of the data sheet example. The 
+     * sweep takes several minutes when this routine is compiled for a host 
+     * PC; on the target, BMP180_TEST_SWEEP_STEP thins out the sweep. */
+    #define BMP180_TEST_SWEEP_STEP  1
+
+    void BMP180_TestDivisionFreeRoutine(void){
+
+        const BMP180_CAL_COEFF cal = {408, -72, -14383, 32741, 32757, 23153, 
+                6190, 4, -32768, -8711, 2868};
+        BMP180_PARAM sensor = {0};
+        uint32_t rawTemperature;
+        uint32_t rawPressure;
+        uint32_t checked = 0;
+        uint32_t mismatches = 0;
+        int32_t b3;
+        uint32_t b4;
+        int16_t temperature;
+        uint8_t oss;
+
+        sensor.calibParam = cal;
+        for (oss = 0; oss < 4; oss++) {
+            #if BMP180_FIXED_OSS != BMP180_OSS_RUNTIME
+                if (oss != BMP180_FIXED_OSS)
+                    continue;
+            #endif
+            sensor.oversampling = oss;
+            sensor.compensation.isValid = false;
+            for (rawTemperature = 0; rawTemperature <= 0xFFFF; 
+                    rawTemperature += BMP180_TEST_SWEEP_STEP) {
+                if ((((int32_t) rawTemperature - cal.ac6) * cal.ac5 >> 15)
+                        + cal.md == 0)
+                    continue; // invalid; division by zero in calcB5()
+                temperature = calcReferenceTerms(&cal, oss, 
+                        (uint16_t) rawTemperature, &b3, &b4);
+                if (temperature < -400 || temperature > 850 || b4 == 0)
+                    continue; // outside of the operating range
+                for (rawPressure = 0; rawPressure < (0x10000UL << oss); 
+                        rawPressure += BMP180_TEST_SWEEP_STEP) {
+                    checked++;
+                    if (BMP180_CalcPressure(&sensor, rawPressure, 
+                            rawTemperature) != calcReferencePressure(
+                            rawPressure, oss, b3, b4))
+                        mismatches++;
+                }
+            }
+        }
+
+        printf("BMP180 - compensation checked: %lu, mismatches: %lu\n", 
+                (unsigned long) checked, (unsigned long) mismatches);
+        printf("----------------------------------\n");
+
+        __delay_ms(2000);
+    }
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+/**
+ * 
+ * File:                console.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the command console on EUSART1. The handlers of the
+ * profilers are only invoked if the profiler is compiled in.
+*/
+
+
+#include "console.h"
+#include "i2c_profile.h"
+#include "state_profile.h"
+#include "power.h"
+
+
+/******************************************************************************* 
+ * Function to service the console
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void serviceConsole(void) {
+    
+    uint8_t command;
+    
+    if (!EUSART1_is_rx_ready())
+        return;
+    command = EUSART1_Read();
+    
+#if I2C_PROFILE_ENABLED
+    if (handleI2cProfileCommand(command))
+        return;
+#endif
+#if STATE_PROFILE_ENABLED
+    if (handleStateProfileCommand(command))
+        return;
+#endif
+    (void) handlePowerCommand(command);
+}
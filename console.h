@@ -0,0 +1,49 @@
+/* 
+ * File:                console.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module receives single character commands over EUSART1 and passes
+ * them to the modules reporting their statistics, i.e. the I2C profile ('i',
+ * 'I'), the state profile ('s', 'S') and the power statistics ('p', 'P').
+ * Lower case prints, upper case resets.
+ *    
+ */
+
+#ifndef CONSOLE_H
+#define	CONSOLE_H
+
+#include "mcc_generated_files/mcc.h"
+
+/******************************************************************************* 
+ * Function to service the console
+ ******************************************************************************/
+/*
+ * @brief This checks EUSART1 for a command without waiting and passes it to 
+ * the module handling it; unknown commands are ignored. It needs to be 
+ * invoked cyclically by the main loop.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void serviceConsole(void);
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CONSOLE_H */
+
@@ -0,0 +1,245 @@
+/**
+ * 
+ * File Name:           bmp180_division_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the division-free pressure kernel. The BMP180 driver is
+ * included here with BMP180_DIVISION_FREE set, so that its static helpers can
+ * be called, and linked a second time with the software division by
+ * host/bmp180_reference.c. First, the reciprocal of every divisor up to
+ * HOST_TEST_EXHAUSTIVE_DIVISORS and of a sample of the larger ones up to
+ * 2^32 - 1 is checked: it must not exceed 2^(32 + shift) / divisor, the
+ * estimated quotient must never exceed the exact one and must fall short by
+ * at most BMP180_RECIPROCAL_MAX_CORRECTION, and divideByReciprocal() must
+ * match the integer division. Then both drivers compensate every raw
+ * pressure of all oversampling settings at HOST_TEST_TEMPERATURES raw
+ * temperatures from -40 to 85 Celsius degree for several calibrations, and
+ * the results have to be identical. The exit code is the number of failed
+ * checks.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o bmp180_division_host_test \
+ *      host/bmp180_division_host_test.c host/bmp180_reference.c \
+ *      host/ssp2_emu.c host/host_clock.c host/xc_registers.c tick.c \
+ *      i2c_profile.c mcc_generated_files/i2c1_master.c \
+ *      mcc_generated_files/i2c2_master.c \
+ *      mcc_generated_files/drivers/i2c1_simple_master.c \
+ *      mcc_generated_files/drivers/i2c_simple_master.c
+ *  ./bmp180_division_host_test
+ * 
+*/
+
+#define BMP180_DIVISION_FREE                1
+
+#include <stdio.h>
+#include <string.h>
+#include "../bmp180.c"
+
+#define HOST_TEST_EXHAUSTIVE_DIVISORS   (1UL << 17)
+#define HOST_TEST_DIVISOR_STEP_SHIFT    12      // relative step above
+#define HOST_TEST_DIVIDENDS             16      // per divisor
+#define HOST_TEST_MAX_SHORTFALL         16      // LSB of the reciprocal
+#define HOST_TEST_TEMPERATURES          16
+#define HOST_TEST_MIN_TEMPERATURE       -400    // 0.1 Celsius degree
+#define HOST_TEST_MAX_TEMPERATURE       850
+#define HOST_TEST_LCG_MULTIPLIER        1103515245UL
+#define HOST_TEST_LCG_INCREMENT         12345UL
+
+// Reference driver with the software division, see bmp180_reference.c
+int16_t BMP180_REF_CalcTemperature(BMP180_PARAM *bmp180,
+        uint16_t rawTemperature);
+int32_t BMP180_REF_CalcPressure(BMP180_PARAM *bmp180, uint32_t rawPressure,
+        uint32_t rawTemperature);
+
+// Result of the reciprocal checks
+typedef struct {
+    uint32_t divisors;
+    uint32_t tooLarge;          // reciprocals above the exact value
+    uint32_t maxShortfall;      // of the reciprocal
+    uint32_t overestimates;     // estimated quotients above the exact one
+    uint32_t maxCorrection;     // for shifts of BMP180_RECIPROCAL_MIN_SHIFT
+    uint32_t mismatches;        // results of divideByReciprocal()
+} RECIPROCAL_RESULT;
+
+/* Calibration of the data sheet and calibrations with other AC1 to AC6, B1
+ * and B2, which spread B4 */
+static const BMP180_CAL_COEFF calibrations[] = {
+    {408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868},
+    {8200, -1100, -14700, 34500, 25200, 17500, 6500, 40, -32768, -11786,
+            2800},
+    {7400, -1200, -14200, 30200, 24800, 16000, 5500, 30, -32768, -11000,
+            2500},
+    {408, -72, -16000, 20000, 32757, 23153, 7000, 4, -32768, -8711, 2868}
+};
+static uint32_t randomState = 1;
+static uint8_t failures;
+
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+/* Returns 32 random bits from the upper halves of two steps of an LCG */
+static uint32_t getRandom(void) {
+    
+    uint32_t high;
+
+    randomState = randomState * HOST_TEST_LCG_MULTIPLIER
+            + HOST_TEST_LCG_INCREMENT;
+    high = randomState >> 16;
+    randomState = randomState * HOST_TEST_LCG_MULTIPLIER
+            + HOST_TEST_LCG_INCREMENT;
+
+    return (high << 16) | (randomState >> 16);
+}
+
+/* Checks the reciprocal of a divisor and the quotients of a set of
+ * dividends, which includes the largest ones and exact multiples */
+static void checkDivisor(uint32_t divisor, RECIPROCAL_RESULT *pResult) {
+    
+    uint32_t dividends[HOST_TEST_DIVIDENDS];
+    uint32_t reciprocal, estimate, quotient;
+    uint64_t exact;
+    uint8_t shift;
+
+    calcReciprocal(divisor, &reciprocal, &shift);
+    exact = (1ULL << (32 + shift)) / divisor;
+    pResult->divisors++;
+    if (reciprocal > exact)
+        pResult->tooLarge++;
+    else if (exact - reciprocal > pResult->maxShortfall)
+        pResult->maxShortfall = (uint32_t) (exact - reciprocal);
+
+    dividends[0] = 0xFFFFFFFF;
+    dividends[1] = 0xFFFFFFFE;
+    dividends[2] = 0xFFFFFFFF / divisor * divisor;
+    dividends[3] = dividends[2] - 1;
+    dividends[4] = divisor;
+    dividends[5] = divisor - 1;
+    for (uint8_t i = 6; i < HOST_TEST_DIVIDENDS; i++)
+        dividends[i] = getRandom();
+
+    for (uint8_t i = 0; i < HOST_TEST_DIVIDENDS; i++) {
+        estimate = mulHigh32(dividends[i], reciprocal) >> shift;
+        quotient = dividends[i] / divisor;
+        if (estimate > quotient)
+            pResult->overestimates++;
+        else if (shift >= BMP180_RECIPROCAL_MIN_SHIFT
+                && quotient - estimate > pResult->maxCorrection)
+            pResult->maxCorrection = quotient - estimate;
+        if (divideByReciprocal(dividends[i], divisor, reciprocal, shift)
+                != quotient)
+            pResult->mismatches++;
+    }
+}
+
+static void testReciprocal(void) {
+    
+    RECIPROCAL_RESULT result = {0};
+    uint64_t divisor;
+
+    for (divisor = 1; divisor <= HOST_TEST_EXHAUSTIVE_DIVISORS; divisor++)
+        checkDivisor((uint32_t) divisor, &result);
+    for (; divisor <= 0xFFFFFFFF;
+            divisor += (divisor >> HOST_TEST_DIVISOR_STEP_SHIFT) + 1)
+        checkDivisor((uint32_t) divisor, &result);
+    checkDivisor(0xFFFFFFFF, &result);
+
+    printf("HOST BENCH - %lu divisors: reciprocal short by max. %lu, "
+            "quotient by max. %lu\n", (unsigned long) result.divisors,
+            (unsigned long) result.maxShortfall,
+            (unsigned long) result.maxCorrection);
+    check("reciprocal never too large", result.tooLarge == 0
+            && result.maxShortfall < HOST_TEST_MAX_SHORTFALL);
+    check("quotient never overestimated", result.overestimates == 0);
+    check("correction bound",
+            result.maxCorrection <= BMP180_RECIPROCAL_MAX_CORRECTION);
+    check("division", result.mismatches == 0);
+}
+
+/* Returns the raw temperature of the given temperature */
+static uint16_t findRawTemperature(BMP180_PARAM *pSensor,
+        int16_t temperature) {
+    
+    uint32_t rawTemperature = pSensor->calibParam.ac6;
+
+    while (rawTemperature < 0xFFFF
+            && BMP180_CalcTemperature(pSensor, rawTemperature) < temperature)
+        rawTemperature++;
+
+    return (uint16_t) rawTemperature;
+}
+
+static void testKernels(void) {
+    
+    BMP180_PARAM sensor, reference;
+    uint16_t minRawTemperature, maxRawTemperature, rawTemperature;
+    uint32_t maxRawPressure;
+    uint32_t compared = 0, mismatches = 0, temperatureMismatches = 0;
+    uint32_t minB4 = 0xFFFFFFFF, maxB4 = 0;
+
+    for (uint8_t c = 0; c < sizeof(calibrations) / sizeof(calibrations[0]);
+            c++) {
+        memset(&sensor, 0, sizeof(sensor));
+        sensor.calibParam = calibrations[c];
+        minRawTemperature = findRawTemperature(&sensor,
+                HOST_TEST_MIN_TEMPERATURE);
+        maxRawTemperature = findRawTemperature(&sensor,
+                HOST_TEST_MAX_TEMPERATURE);
+
+        for (uint8_t oss = BMP180_MODE_ULTRALOWPOWER;
+                oss <= BMP180_MODE_ULTRAHIGHRESOLUTION; oss++) {
+            memset(&sensor, 0, sizeof(sensor));
+            sensor.calibParam = calibrations[c];
+            sensor.oversampling = oss;
+            reference = sensor;
+            maxRawPressure = (1UL << (16 + oss)) - 1;
+
+            for (uint8_t t = 0; t < HOST_TEST_TEMPERATURES; t++) {
+                rawTemperature = minRawTemperature
+                        + (uint32_t) (maxRawTemperature - minRawTemperature)
+                        * t / (HOST_TEST_TEMPERATURES - 1);
+                if (BMP180_CalcTemperature(&sensor, rawTemperature)
+                        != BMP180_REF_CalcTemperature(&reference,
+                        rawTemperature))
+                    temperatureMismatches++;
+                for (uint32_t up = 0; up <= maxRawPressure; up++) {
+                    if (BMP180_CalcPressure(&sensor, up, rawTemperature)
+                            != BMP180_REF_CalcPressure(&reference, up,
+                            rawTemperature))
+                        mismatches++;
+                    compared++;
+                }
+                if (sensor.compensation.b4 < minB4)
+                    minB4 = sensor.compensation.b4;
+                if (sensor.compensation.b4 > maxB4)
+                    maxB4 = sensor.compensation.b4;
+            }
+        }
+    }
+
+    printf("HOST BENCH - %lu raw pressures compared, B4 from %lu to %lu\n",
+            (unsigned long) compared, (unsigned long) minB4,
+            (unsigned long) maxB4);
+    check("temperature", temperatureMismatches == 0);
+    check("pressure identical to the division", mismatches == 0);
+}
+
+int main(void) {
+    
+    testReciprocal();
+    testKernels();
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
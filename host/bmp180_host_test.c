@@ -0,0 +1,725 @@
+/**
+ * 
+ * File Name:           bmp180_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the BMP180 driver against the BMP180 model. The unmodified
+ * driver, I2C2 simple master and I2C2 master driver run on the MSSP2
+ * emulator. First, the initialisation and the compensation are checked for
+ * all oversampling settings over the range of the sensor: the results of the
+ * driver have to match the data sheet reference bit by bit and follow the
+ * profile within the resolution of the raw values. The altitude kernel has
+ * to stay within HOST_TEST_ALTITUDE_MAX_ERROR of the floating point formula
+ * for every Pa of its range. The SCO polling, the noise and the faults of the
+ * sensor follow. The bytes written to the LCD per
+ * frame are reported for the direct functions and the shadow framebuffer,
+ * as well as the time to queue and to send a line of characters.
+ * Finally, the acquisition task and the state machine run a scripted weather
+ * front in emulated time, which is reported against the time taken on the
+ * host. Each published snapshot is compared with the profile and the samples
+ * have to follow the fixed rate of ACQ_SAMPLE_PERIOD_MS without gaps. The 
+ * screens of the display states are captured by the HD44780 emulator and
+ * compared with the readings. As the state handlers don't block, the main
+ * loop has to run at least HOST_TEST_MIN_LOOPS_PER_S times per emulated 
+ * second. Like main(), it idles whenever no task is ready, and the CPU has to
+ * be awake less than HOST_TEST_MAX_DUTY_CYCLE of the time. The exit code is
+ * the number of failed checks.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o bmp180_host_test \
+ *      host/bmp180_host_test.c host/bmp180_sim.c host/ssp2_emu.c \
+ *      host/host_clock.c host/host_eusart1.c host/xc_registers.c \
+ *      host/hd44780_emu.c bmp180.c acquisition.c state.c lcd.c lcd_app.c \
+ *      trend.c tick.c i2c_profile.c power.c state_profile.c console.c \
+ *      mcc_generated_files/i2c1_master.c mcc_generated_files/i2c2_master.c \
+ *      mcc_generated_files/drivers/i2c1_simple_master.c \
+ *      mcc_generated_files/drivers/i2c_simple_master.c -lm
+ *  ./bmp180_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../bmp180.h"
+#include "../state.h"
+#include "../acquisition.h"
+#include "../lcd.h"
+#include "../trend.h"
+#include "../tick.h"
+#include "../i2c_profile.h"
+#include "../power.h"
+#include "../state_profile.h"
+#include "../console.h"
+#include "../lcd_app.h"
+#include "host_clock.h"
+#include "host_eusart1.h"
+#include "ssp2_emu.h"
+#include "bmp180_sim.h"
+#include "hd44780_emu.h"
+
+#define HOST_TEST_OSS_COUNT             4
+#define HOST_TEST_ALTITUDE_MAX_ERROR    1.5     // m, see BMP180_CalcAltitude()
+#define HOST_TEST_SEA_LEVEL_PRESSURE    101325.0
+#define HOST_TEST_NOISE_SAMPLES         200
+#define HOST_TEST_NOISE_TEMPERATURE     4       // LSB of UT
+#define HOST_TEST_NOISE_PRESSURE        16      // LSB of UP
+#define HOST_TEST_NOISE_SEED            12345
+#define HOST_TEST_POLLING_SAMPLES       20
+#define HOST_TEST_POLLING_SCALE         60      // % of the max. conv. time
+#define HOST_TEST_FAULT_BOUND_MS        100     // bound of the simple master
+#define HOST_TEST_PIPELINE_MINUTES      30
+/* At 1 Hz, every other sample reuses the cached raw temperature, which lags
+ * the temperature ramp of the front by up to two samples */
+#define HOST_TEST_PIPELINE_TOLERANCE    10      // Pa
+#define HOST_TEST_NS_PER_MS             1000000ULL
+#define HOST_TEST_LCD_FRAMES            10
+#define HOST_TEST_MIN_LOOPS_PER_S       1000
+#define HOST_TEST_MAX_DUTY_CYCLE        200     // 0.1 %
+
+static const int16_t sweepTemperatures[] = {-200, 0, 150, 250, 400, 600};
+static const int32_t sweepPressures[] = {
+    30000, 50000, 70000, 90000, 101325, 110000
+};
+
+static BMP180_SIM_POINT profile[3];
+static uint8_t failures;
+
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+static uint32_t getTimeMs(void) {
+    
+    return (uint32_t) (getHostClockNs() / HOST_TEST_NS_PER_MS);
+}
+
+/* Sets a constant temperature and pressure */
+static void setConstantProfile(int16_t temperature, int32_t pressure) {
+    
+    profile[0] = (BMP180_SIM_POINT) {0, temperature, pressure};
+    setBmp180SimProfile(profile, 1);
+}
+
+/* Waits for the conversion in progress; the tick lets the emulators run */
+static void waitForConversion(BMP180_PARAM *pSensor) {
+    
+    while (!BMP180_IsConversionComplete(pSensor))
+        ;
+}
+
+/* Converts and collects UT and UP like the state machine */
+static bool measure(BMP180_PARAM *pSensor, uint16_t *pUt, uint32_t *pUp) {
+    
+    if (BMP180_StartTemperatureConversion(pSensor) != 0)
+        return false;
+    waitForConversion(pSensor);
+    *pUt = BMP180_CollectRawTemperature(pSensor);
+    if (BMP180_StartPressureConversion(pSensor) != 0)
+        return false;
+    waitForConversion(pSensor);
+    *pUp = BMP180_CollectRawPressure(pSensor);
+
+    return *pUt != BMP180_INVALID_DATA && *pUp != BMP180_INVALID_DATA;
+}
+
+static void testInit(void) {
+    
+    BMP180_PARAM sensor = {0};
+    const BMP180_CAL_COEFF expected = {
+        408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868
+    };
+
+    check("init", BMP180_Init(&sensor) == 0
+            && sensor.chipId == BMP180_REG_CHIP_ID_VALUE);
+    check("calibration", memcmp(&sensor.calibParam, &expected,
+            sizeof(expected)) == 0);
+    check("init bus traffic", sensor.busStats.transactions == 2
+            && sensor.busStats.errors == 0);
+}
+
+static void testCompensation(void) {
+    
+    BMP180_PARAM sensor;
+    uint16_t ut;
+    uint32_t up;
+    int16_t temperature;
+    int32_t pressure;
+    uint16_t mismatches = 0;
+    uint16_t errors = 0;
+    int32_t maxTempDev = 0;
+    int32_t maxPressDev;
+    uint32_t startMs;
+    uint16_t samples;
+    bool withinResolution = true;
+
+    resetBmp180SimStats();
+    for (uint8_t oss = 0; oss < HOST_TEST_OSS_COUNT; oss++) {
+        sensor = (BMP180_PARAM) {0};
+        sensor.oversampling = (BMP180_OVERSAMPLING) oss;
+        if (BMP180_Init(&sensor) != 0) {
+            errors++;
+            continue;
+        }
+        maxPressDev = 0;
+        samples = 0;
+        startMs = getTimeMs();
+        for (uint8_t t = 0; t < sizeof(sweepTemperatures)
+                / sizeof(sweepTemperatures[0]); t++) {
+            for (uint8_t p = 0; p < sizeof(sweepPressures)
+                    / sizeof(sweepPressures[0]); p++) {
+                setConstantProfile(sweepTemperatures[t], sweepPressures[p]);
+                if (!measure(&sensor, &ut, &up)) {
+                    errors++;
+                    continue;
+                }
+                samples++;
+                temperature = BMP180_CalcTemperature(&sensor, ut);
+                pressure = BMP180_CalcPressure(&sensor, up, ut);
+                if (temperature != calcBmp180SimTemperature(ut)
+                        || pressure != calcBmp180SimPressure(up, ut, oss))
+                    mismatches++;
+                if (abs(temperature - sweepTemperatures[t]) > maxTempDev)
+                    maxTempDev = abs(temperature - sweepTemperatures[t]);
+                if (labs(pressure - sweepPressures[p]) > maxPressDev)
+                    maxPressDev = labs(pressure - sweepPressures[p]);
+            }
+        }
+        // One LSB of UP is about 5 Pa at oss = 0 and halves with each step
+        if (maxPressDev > (5 >> oss) + 1)
+            withinResolution = false;
+        printf("HOST BENCH - oss %u: max. deviation %ld Pa, "
+                "%lu ms per measurement\n", oss, (long) maxPressDev,
+                (unsigned long) ((getTimeMs() - startMs)
+                    / (samples ? samples : 1)));
+    }
+
+    check("compensation", errors == 0 && mismatches == 0);
+    check("compensation temperature", maxTempDev == 0);
+    check("compensation pressure", withinResolution);
+    check("conversion timing", getBmp180SimStats()->earlyReads == 0
+            && getBmp180SimStats()->restartedConversions == 0);
+}
+
+/* Compares the integer altitude kernel against the floating point barometric
+ * formula for every Pa of the range of the lookup table */
+static void testAltitude(void) {
+    
+    double reference;
+    double error, errorCm;
+    double maxError = 0, maxErrorCm = 0;
+    int32_t maxErrorPressure = 0;
+    int32_t altitudeCm;
+    int32_t previousCm = INT32_MAX;
+    bool isMonotonic = true;
+
+    for (int32_t pressure = BMP180_ALT_TABLE_PRESSURE_MIN; pressure <= 110000;
+            pressure++) {
+        reference = 44330 * (1.0 - pow(pressure
+                / HOST_TEST_SEA_LEVEL_PRESSURE, 0.1903));
+        error = fabs(BMP180_CalcAltitude(pressure) - reference);
+        if (error > maxError) {
+            maxError = error;
+            maxErrorPressure = pressure;
+        }
+        altitudeCm = BMP180_CalcAltitudeCm(pressure);
+        errorCm = fabs(altitudeCm / 100.0 - reference);
+        if (errorCm > maxErrorCm)
+            maxErrorCm = errorCm;
+        if (altitudeCm > previousCm)
+            isMonotonic = false;
+        previousCm = altitudeCm;
+    }
+    printf("HOST BENCH - altitude: max. error %.2f m at %ld Pa, "
+            "%.2f m in cm\n", maxError, (long) maxErrorPressure, maxErrorCm);
+    check("altitude max. error", maxError < HOST_TEST_ALTITUDE_MAX_ERROR);
+    check("altitude cm max. error",
+            maxErrorCm < HOST_TEST_ALTITUDE_MAX_ERROR);
+    check("altitude cm monotonic", isMonotonic);
+    check("altitude clamped", BMP180_CalcAltitude(20000)
+            == BMP180_CalcAltitude(BMP180_ALT_TABLE_PRESSURE_MIN));
+}
+
+static void testScoPolling(void) {
+    
+    BMP180_PARAM sensor = {0};
+    uint16_t ut;
+    uint32_t up;
+    uint16_t errors = 0;
+    uint32_t startMs;
+
+    sensor.oversampling = BMP180_MODE_ULTRAHIGHRESOLUTION;
+    sensor.scoPolling = true;
+    setConstantProfile(215, 98000);
+    setBmp180SimConversionScale(HOST_TEST_POLLING_SCALE);
+    resetBmp180SimStats();
+    startMs = getTimeMs();
+    if (BMP180_Init(&sensor) != 0)
+        errors++;
+    for (uint8_t i = 0; i < HOST_TEST_POLLING_SAMPLES && !errors; i++) {
+        if (!measure(&sensor, &ut, &up)
+                || BMP180_CalcTemperature(&sensor, ut) != 215
+                || labs(BMP180_CalcPressure(&sensor, up, ut) - 98000) > 1)
+            errors++;
+    }
+    printf("HOST BENCH - SCO polling: %lu ms per measurement, "
+            "estimate %u ms of %u ms\n",
+            (unsigned long) ((getTimeMs() - startMs)
+                / HOST_TEST_POLLING_SAMPLES),
+            sensor.pressConvStats.estimate, sensor.ossConvTime);
+    setBmp180SimConversionScale(100);
+
+    check("SCO polling", errors == 0
+            && getBmp180SimStats()->earlyReads == 0);
+    check("SCO polling learns",
+            sensor.pressConvStats.estimate < sensor.ossConvTime
+            && sensor.tempConvStats.estimate < BMP180_CONV_TIME_TEMP);
+}
+
+static void testNoise(void) {
+    
+    BMP180_PARAM sensor = {0};
+    const int16_t temperature = 250;
+    const int32_t pressure = 95000;
+    uint16_t ut, ut0;
+    uint32_t up, up0;
+    int32_t utDev, upDev;
+    int32_t minUpDev = 0, maxUpDev = 0;
+    bool withinAmplitude = true;
+    double sum = 0, sumSquares = 0, mean, sigma;
+    uint16_t errors = 0;
+
+    sensor.oversampling = BMP180_MODE_ULTRAHIGHRESOLUTION;
+    setConstantProfile(temperature, pressure);
+    setBmp180SimNoise(HOST_TEST_NOISE_TEMPERATURE, HOST_TEST_NOISE_PRESSURE,
+            HOST_TEST_NOISE_SEED);
+    if (BMP180_Init(&sensor) != 0)
+        errors++;
+    ut0 = calcBmp180SimRawTemperature(temperature);
+    up0 = calcBmp180SimRawPressure(pressure, ut0, 3);
+    for (uint16_t i = 0; i < HOST_TEST_NOISE_SAMPLES && !errors; i++) {
+        if (!measure(&sensor, &ut, &up)) {
+            errors++;
+            break;
+        }
+        utDev = (int32_t) ut - ut0;
+        upDev = (int32_t) up - (int32_t) up0;
+        if (abs(utDev) > HOST_TEST_NOISE_TEMPERATURE
+                || labs(upDev) > HOST_TEST_NOISE_PRESSURE)
+            withinAmplitude = false;
+        if (upDev < minUpDev)
+            minUpDev = upDev;
+        if (upDev > maxUpDev)
+            maxUpDev = upDev;
+        // The pressure error includes the noise of UT
+        upDev = BMP180_CalcPressure(&sensor, up, ut) - pressure;
+        sum += upDev;
+        sumSquares += (double) upDev * upDev;
+    }
+    setBmp180SimNoise(0, 0, 0);
+
+    mean = sum / HOST_TEST_NOISE_SAMPLES;
+    sigma = sqrt(sumSquares / HOST_TEST_NOISE_SAMPLES - mean * mean);
+    printf("HOST BENCH - noise: pressure error mean %.2f Pa, "
+            "sigma %.2f Pa\n", mean, sigma);
+    check("noise", errors == 0 && withinAmplitude
+            && minUpDev < 0 && maxUpDev > 0);
+    check("noise mean", fabs(mean) < 2.0);
+}
+
+static void testFaults(void) {
+    
+    BMP180_PARAM sensor = {0};
+    uint32_t startMs;
+    uint16_t elapsed;
+    uint16_t startTick;
+
+    setConstantProfile(150, 101325);
+
+    setBmp180SimFault(BMP180_SIM_FAULT_ABSENT);
+    startMs = getTimeMs();
+    check("fault absent", BMP180_Init(&sensor) == 2
+            && getTimeMs() - startMs < HOST_TEST_FAULT_BOUND_MS);
+
+    sensor = (BMP180_PARAM) {0};
+    setBmp180SimFault(BMP180_SIM_FAULT_CHIP_ID);
+    check("fault chip-id", BMP180_Init(&sensor) == 2
+            && sensor.chipId == BMP180_SIM_CHIP_ID_BMP280);
+
+    sensor = (BMP180_PARAM) {0};
+    setBmp180SimFault(BMP180_SIM_FAULT_NONE);
+    (void) BMP180_Init(&sensor);
+    setBmp180SimFault(BMP180_SIM_FAULT_DATA_NACK);
+    startMs = getTimeMs();
+    check("fault data NACK", BMP180_StartPressureConversion(&sensor) == 2
+            && sensor.convType == BMP180_CONV_NONE
+            && getTimeMs() - startMs < HOST_TEST_FAULT_BOUND_MS);
+
+    // The driver polls the SCO bit no longer than the max. conversion time
+    setBmp180SimFault(BMP180_SIM_FAULT_SCO_STUCK);
+    sensor = (BMP180_PARAM) {0};
+    sensor.scoPolling = true;
+    (void) BMP180_Init(&sensor);
+    (void) BMP180_StartTemperatureConversion(&sensor);
+    startTick = getTickMs();
+    waitForConversion(&sensor);
+    elapsed = getTickMs() - startTick;
+    (void) BMP180_CollectRawTemperature(&sensor);
+    check("fault SCO stuck", elapsed >= BMP180_CONV_TIME_TEMP
+            && elapsed <= BMP180_CONV_TIME_TEMP + 1
+            && sensor.tempConvStats.estimate == BMP180_CONV_TIME_TEMP);
+
+    // Without polling, the stale result is read while still converting
+    resetBmp180SimStats();
+    sensor.scoPolling = false;
+    (void) BMP180_StartTemperatureConversion(&sensor);
+    waitForConversion(&sensor);
+    (void) BMP180_CollectRawTemperature(&sensor);
+    check("fault SCO stuck early read", getBmp180SimStats()->earlyReads == 1
+            && getBmp180SimStats()->restartedConversions == 1);
+    setBmp180SimFault(BMP180_SIM_FAULT_NONE);
+}
+
+/* Fills the line with spaces and prints the text at the column */
+static void printLine(char *pLine, uint8_t column, const char *pText) {
+    
+    memset(pLine, ' ', HD44780_EMU_COLUMNS);
+    pLine[HD44780_EMU_COLUMNS] = '\0';
+    memcpy(pLine + column, pText, strlen(pText));
+}
+
+/* Compares the screen with the one expected for the display state */
+static bool isStateScreen(DeviceState state, const DeviceContext *pContext) {
+    
+    char screen[HD44780_EMU_LINES][HD44780_EMU_COLUMNS + 1];
+    char expected[HD44780_EMU_LINES][HD44780_EMU_COLUMNS + 1];
+    char value[LCD_TEMPERATURE_BUFFER_SIZE];
+    // Worst case of a value, a blank and a unit of a full line
+    char text[LCD_TEMPERATURE_BUFFER_SIZE + 1 + HD44780_EMU_COLUMNS];
+    int length;
+    uint8_t column;
+    LcdTextIndex headline, unit;
+
+    if (state == STATE_DISPLAY_TEMPERATURE) {
+        headline = LCD_TXT_TEMPERATURE;
+        convertTemperatureToString(pContext->temperature, value);
+        length = snprintf(text, sizeof(text), "%s \xdf" "C", value);
+        column = (LCD_CHAR_LENGTH - strlen(value) - 3) / 2;
+    } else {
+        if (state == STATE_DISPLAY_PRESSURE) {
+            headline = LCD_TXT_PRESSURE;
+            unit = LCD_TXT_PRESSURE_UNIT;
+            snprintf(value, sizeof(value), "%d",
+                    (int16_t) (pContext->pressure / 100));
+        } else {
+            headline = LCD_TXT_ALTITUDE;
+            unit = LCD_TXT_ALTITUDE_UNIT;
+            snprintf(value, sizeof(value), "%d", pContext->altitude);
+        }
+        length = snprintf(text, sizeof(text), "%s %s", value,
+                getLcdText(unit));
+        column = (LCD_CHAR_LENGTH - strlen(value)
+                - strlen(getLcdText(unit))) / 2;
+    }
+    if (length < 0 || column + length > HD44780_EMU_COLUMNS) {
+        printf("HOST TEST - screen: \"%s\" exceeds the line\n", text);
+        return false;
+    }
+    printLine(expected[1], column, text);
+    printLine(expected[0], (LCD_CHAR_LENGTH 
+            - strlen(getLcdText(headline))) / 2, getLcdText(headline));
+
+    getHd44780EmuScreen(screen);
+    if (memcmp(screen, expected, sizeof(screen)) == 0)
+        return true;
+    printf("HOST TEST - screen: \"%s\" \"%s\", expected \"%s\" \"%s\"\n",
+            screen[0], screen[1], expected[0], expected[1]);
+    
+    return false;
+}
+
+static uint32_t getLcdBytes(void) {
+    
+    return LCD_GetBusStats()->commandBytes + LCD_GetBusStats()->dataBytes;
+}
+
+// Draws a temperature screen like the display states did before the flush
+static void drawDirect(int16_t temperature) {
+    
+    LCD_Clear();
+    LCD_SetCursor(LCD_FIRST_LINE, 2);
+    LCD_PrintString("Temperature");
+    LCD_SetCursor(LCD_SECOND_LINE, 5);
+    LCD_PrintInteger(temperature, INT_BASE_DECIMAL);
+    LCD_ShiftCursorRight();
+    LCD_PrintCharacter(0xdf);
+    LCD_PrintCharacter('C');
+}
+
+static void drawFrame(int16_t temperature) {
+    
+    LCD_FrameClear();
+    LCD_FrameSetCursor(LCD_FIRST_LINE, 2);
+    LCD_FramePrintString("Temperature");
+    LCD_FrameSetCursor(LCD_SECOND_LINE, 5);
+    LCD_FramePrintInteger(temperature, INT_BASE_DECIMAL);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintCharacter(0xdf);
+    LCD_FramePrintCharacter('C');
+    LCD_Flush();
+}
+
+static void testLcdFrame(void) {
+    
+    uint32_t bytes, directBytes, firstBytes, frameBytes;
+    uint64_t startNs, directNs, frameNs;
+    uint8_t i;
+    
+    LCD_Init();
+    
+    // The temperature changes by 0.1 degree per frame, i.e. one digit
+    bytes = getLcdBytes();
+    startNs = getHostClockNs();
+    for (i = 0; i < HOST_TEST_LCD_FRAMES; i++)
+        drawDirect(231 + i);
+    directBytes = (getLcdBytes() - bytes) / HOST_TEST_LCD_FRAMES;
+    directNs = (getHostClockNs() - startNs) / HOST_TEST_LCD_FRAMES;
+    
+    // The first flush after a clear writes every non-blank cell
+    LCD_Clear();
+    drawFrame(230);
+    firstBytes = LCD_GetBusStats()->lastFlushBytes;
+    bytes = getLcdBytes();
+    startNs = getHostClockNs();
+    for (i = 0; i < HOST_TEST_LCD_FRAMES; i++)
+        drawFrame(231 + i);
+    frameBytes = (getLcdBytes() - bytes) / HOST_TEST_LCD_FRAMES;
+    frameNs = (getHostClockNs() - startNs) / HOST_TEST_LCD_FRAMES;
+    
+    printf("HOST BENCH - LCD bytes per frame: %lu direct (%lu us), "
+            "%lu first flush, %lu per flush of one digit (%lu us)\n",
+            (unsigned long) directBytes, (unsigned long) (directNs / 1000),
+            (unsigned long) firstBytes, (unsigned long) frameBytes, 
+            (unsigned long) (frameNs / 1000));
+    
+    // The first flush of a shifted display redraws it completely
+    drawDirect(0);
+    LCD_ShiftDisplayLeft();
+    drawFrame(0);
+    
+    check("LCD frame first flush", firstBytes <= directBytes);
+    check("LCD frame one digit", frameBytes <= 2);
+    check("LCD frame shifted", LCD_GetBusStats()->lastFlushBytes 
+            == 1 + 1 + 11 + 1 + 4);
+}
+
+static void testLcdQueue(void) {
+    
+    uint64_t startNs, queuedNs, sentNs;
+    uint16_t stalls;
+    
+    LCD_Init();
+    LCD_SetCursor(LCD_FIRST_LINE, 0);
+    while (!LCD_IsQueueEmpty())
+        (void) getTickMs();
+    
+    stalls = LCD_GetBusStats()->queueStalls;
+    startNs = getHostClockNs();
+    LCD_PrintString("0123456789ABCDEF");
+    queuedNs = getHostClockNs() - startNs;
+    while (!LCD_IsQueueEmpty())
+        (void) getTickMs();
+    sentNs = getHostClockNs() - startNs;
+    
+    printf("HOST BENCH - LCD queue: 16 characters queued in %lu us, "
+            "sent in %lu us (%lu characters/s)\n", 
+            (unsigned long) (queuedNs / 1000), 
+            (unsigned long) (sentNs / 1000), 
+            (unsigned long) (16 * 1000000000ULL / sentNs));
+    
+    // Each access of PIE4 lets the emulators progress by some microseconds
+    check("LCD queue non-blocking", queuedNs * 4 < sentNs
+            && LCD_GetBusStats()->queueStalls == stalls);
+    check("LCD queue drained", sentNs >= 16 * LCD_QUEUE_TICK_US * 1000ULL);
+}
+
+/* Each state of the carousel has to be profiled, and the statistics have to
+ * match the histogram */
+static bool isStateProfileConsistent(void) {
+    
+    const STATE_PROFILE *pProfile;
+    uint16_t binCalls;
+
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        pProfile = getStateProfile((DeviceState) i);
+        binCalls = 0;
+        for (uint8_t bin = 0; bin < STATE_PROFILE_HISTOGRAM_BINS; bin++)
+            binCalls += pProfile->histogram[bin];
+        if (pProfile->calls == 0 || binCalls != pProfile->calls
+                || pProfile->minTime > pProfile->maxTime
+                || pProfile->totalTime < (uint32_t) pProfile->minTime
+                        * pProfile->calls
+                || pProfile->totalTime > (uint32_t) pProfile->maxTime
+                        * pProfile->calls
+                || (pProfile->maxTime <= pProfile->deadline 
+                        && pProfile->misses != 0))
+            return false;
+    }
+
+    return true;
+}
+
+static void testPipeline(void) {
+    
+    BMP180_PARAM sensor = {0};
+    DeviceState state, prevState;
+    DeviceContext context;
+    uint32_t startMs = getTimeMs();
+    uint32_t endMs = startMs + HOST_TEST_PIPELINE_MINUTES * 60000UL;
+    uint32_t nextMinuteMs = startMs + 60000UL;
+    int16_t temperature;
+    int32_t pressure;
+    int32_t maxPressDev = 0;
+    int32_t maxTempDev = 0;
+    uint16_t samples = 0;
+    uint16_t sequenceGaps = 0;
+    uint16_t expectedSamples;
+    ACQ_SNAPSHOT snapshot = {0};
+    uint16_t prevSequence = 0;
+    struct timespec hostStart, hostEnd;
+    double hostSeconds;
+    uint32_t lcdBytes = getLcdBytes();
+    uint16_t lcdFlushes = LCD_GetBusStats()->flushes;
+    uint16_t screens = 0;
+    uint16_t screenMismatches = 0;
+    uint32_t loops = 0;
+
+    // A front passes: the pressure drops by 12 hPa and recovers
+    profile[0] = (BMP180_SIM_POINT) {startMs, 180, 101500};
+    profile[1] = (BMP180_SIM_POINT) {startMs + 600000UL, 235, 100300};
+    profile[2] = (BMP180_SIM_POINT) {startMs + 1500000UL, 160, 101800};
+    setBmp180SimProfile(profile, 3);
+    resetBmp180SimStats();
+    clock_gettime(CLOCK_MONOTONIC, &hostStart);
+
+    // Initialise like main()
+    initStateMachine(&state, &context, &sensor);
+    initPressureReadings();
+    LCD_Init();
+    sensor.tempRefreshSamples = BMP180_TEMP_REFRESH_SAMPLES;
+    sensor.tempRefreshPeriod = BMP180_TEMP_REFRESH_PERIOD;
+    while (BMP180_Init(&sensor) != 0)
+        __delay_ms(BMP180_INIT_RETRY_PERIOD);
+    initAcquisition(&sensor);
+    initPower();
+    resetStateProfile();
+
+    while (getTimeMs() < endMs) {
+        loops++;
+        runAcquisition();
+        if (getAcquisitionSnapshot(&snapshot)
+                && snapshot.sequence != prevSequence) {
+            getBmp180SimTarget(getTimeMs(), &temperature, &pressure);
+            if (labs(snapshot.pressure - pressure) > maxPressDev)
+                maxPressDev = labs(snapshot.pressure - pressure);
+            if (abs(snapshot.temperature - temperature) > maxTempDev)
+                maxTempDev = abs(snapshot.temperature - temperature);
+            if (snapshot.sequence != (uint16_t) (prevSequence + 1))
+                sequenceGaps++;
+            prevSequence = snapshot.sequence;
+            samples++;
+        }
+        prevState = state;
+        runStateMachine(&state, &context);
+        if (!isAcquisitionReady() && !isStateMachineReady())
+            idleUntilInterrupt();
+        if ((prevState == STATE_DISPLAY_TEMPERATURE 
+                || prevState == STATE_DISPLAY_PRESSURE
+                || prevState == STATE_DISPLAY_ALTITUDE) && state != prevState) {
+            while (!LCD_IsQueueEmpty())
+                (void) getTickMs();
+            if (!isStateScreen(prevState, &context))
+                screenMismatches++;
+            screens++;
+        }
+        // Timer 0 isn't emulated; it requests a reading once per minute
+        if (getTimeMs() >= nextMinuteMs) {
+            timer0ISR();
+            nextMinuteMs += 60000UL;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &hostEnd);
+    hostSeconds = (hostEnd.tv_sec - hostStart.tv_sec)
+            + (hostEnd.tv_nsec - hostStart.tv_nsec) / 1e9;
+    printf("HOST BENCH - pipeline: %u samples, max. deviation %ld Pa "
+            "%ld x 0.1 C, %u min emulated in %.3f s (%.0fx real time)\n",
+            samples, (long) maxPressDev, (long) maxTempDev,
+            HOST_TEST_PIPELINE_MINUTES, hostSeconds,
+            HOST_TEST_PIPELINE_MINUTES * 60.0 / hostSeconds);
+    printf("HOST BENCH - pipeline: %.0f main loop iterations per second\n",
+            loops / (HOST_TEST_PIPELINE_MINUTES * 60.0));
+    printf("HOST BENCH - pipeline: %lu LCD bytes in %u flushes\n",
+            (unsigned long) (getLcdBytes() - lcdBytes),
+            LCD_GetBusStats()->flushes - lcdFlushes);
+
+    expectedSamples = HOST_TEST_PIPELINE_MINUTES * 60000UL 
+            / ACQ_SAMPLE_PERIOD_MS;
+    check("pipeline", samples > 0
+            && maxPressDev <= HOST_TEST_PIPELINE_TOLERANCE
+            && maxTempDev <= 1);
+    check("pipeline sample rate", sequenceGaps == 0
+            && samples >= expectedSamples - 1 && samples <= expectedSamples);
+    check("pipeline trend", numberOfValidReadings > 0);
+    check("pipeline timing", getBmp180SimStats()->earlyReads == 0);
+    check("pipeline screens", screens > 0 && screenMismatches == 0);
+    check("pipeline non-blocking", loops / (HOST_TEST_PIPELINE_MINUTES * 60UL)
+            >= HOST_TEST_MIN_LOOPS_PER_S);
+    check("pipeline idle", getPowerDutyCycle() < HOST_TEST_MAX_DUTY_CYCLE);
+    check("pipeline state profile", isStateProfileConsistent());
+
+    // Query the profiles over the console like a user would
+    setHostEusart1Input("isp");
+    for (uint8_t i = 0; i < 3; i++)
+        serviceConsole();
+}
+
+int main(void) {
+    
+    initHostClock();
+    initSsp2Emu();
+    check("attach", initBmp180Sim() && initHd44780Emu());
+    initTick();
+    I2C2_Initialize();
+    resetI2cProfile();
+
+    testInit();
+    testCompensation();
+    testAltitude();
+    testScoPolling();
+    testNoise();
+    testFaults();
+    testLcdFrame();
+    testLcdQueue();
+    testPipeline();
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0);
+    check("LCD timing", getHd44780EmuStats()->busyWrites == 0
+            && getHd44780EmuStats()->timingViolations == 0
+            && getHd44780EmuStats()->busViolations == 0);
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
@@ -0,0 +1,37 @@
+/**
+ * 
+ * File:                bmp180_reference.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module compiles the unmodified BMP180 driver a second time with the
+ * software division by B4, i.e. BMP180_DIVISION_FREE set to 0. Its public
+ * functions are renamed from BMP180_ to BMP180_REF_, so that it can be linked
+ * next to the division-free driver and serve as reference for the latter.
+ * 
+*/
+
+#define BMP180_DIVISION_FREE                0
+
+#define bmp180BusI2C1                       bmp180RefBusI2C1
+#define bmp180BusI2C2                       bmp180RefBusI2C2
+#define BMP180_Init                         BMP180_REF_Init
+#define BMP180_ReadRawTemperature           BMP180_REF_ReadRawTemperature
+#define BMP180_ReadRawPressure              BMP180_REF_ReadRawPressure
+#define BMP180_StartTemperatureConversion   BMP180_REF_StartTemperatureConversion
+#define BMP180_StartPressureConversion      BMP180_REF_StartPressureConversion
+#define BMP180_IsConversionComplete         BMP180_REF_IsConversionComplete
+#define BMP180_IsConversionDue              BMP180_REF_IsConversionDue
+#define BMP180_CollectRawTemperature        BMP180_REF_CollectRawTemperature
+#define BMP180_CollectRawPressure           BMP180_REF_CollectRawPressure
+#define BMP180_IsTemperatureRefreshDue      BMP180_REF_IsTemperatureRefreshDue
+#define BMP180_GetLastRawTemperature        BMP180_REF_GetLastRawTemperature
+#define BMP180_CalcTemperature              BMP180_REF_CalcTemperature
+#define BMP180_CalcPressure                 BMP180_REF_CalcPressure
+#define BMP180_CalcAltitude                 BMP180_REF_CalcAltitude
+#define BMP180_CalcAltitudeCm               BMP180_REF_CalcAltitudeCm
+
+#include "../bmp180.c"
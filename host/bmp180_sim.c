@@ -0,0 +1,790 @@
+/**
+ * 
+ * File:                bmp180_sim.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Sensor:              Bosch BMP180 barometric pressure sensor
+
+ * Description:
+ * ------------
+ * This module contains the BMP180 model. The register pointer is written by
+ * the first byte after the address and increments with every byte read or
+ * written. A conversion is completed lazily, i.e. on the next access of the
+ * sensor once its conversion time has elapsed, and its result is derived
+ * from the profile at the time of completion.
+ * 
+ * The compensation follows the data sheet rev 1.2 literally. The temperature
+ * rises monotonically with UT above AC6 and the pressure with UP above B3, so
+ * UT and UP are found by binary search. UP is derived from the noise-free UT
+ * of the current temperature, hence a stale UT of the driver shows up as a
+ * pressure error like on the real sensor.
+ * 
+*/
+
+
+#include "bmp180_sim.h"
+#include "host_clock.h"
+#include "ssp2_emu.h"
+
+#define BMP180_SIM_REG_COUNT            256
+#define BMP180_SIM_SOFT_RESET_VALUE     0xB6
+#define BMP180_SIM_OUT_MSB_RESET        0x80
+#define BMP180_SIM_CTRL_MEAS_MODE_MASK  0x3F // SCO bit and measurement control
+#define BMP180_SIM_CTRL_MEAS_OSS_POS    6
+#define BMP180_SIM_CONV_NS_TEMP         4500000UL
+#define BMP180_SIM_MAX_PERCENT          100
+#define BMP180_SIM_RAW_TEMP_MAX         0xFFFF
+#define BMP180_SIM_LCG_MULTIPLIER       1103515245UL
+#define BMP180_SIM_LCG_INCREMENT        12345UL
+
+// Max. pressure conversion times of the data sheet for oss = 0 to 3
+static const uint32_t pressureConvNs[] = {
+    4500000UL, 7500000UL, 13500000UL, 25500000UL
+};
+
+// Calibration coefficients of the example calculation of the data sheet
+static const BMP180_CAL_COEFF defaultCoeff = {
+    408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868
+};
+
+// Default profile: standard atmosphere at sea level
+static const BMP180_SIM_POINT defaultProfile = {0, 150, 101325};
+
+// Register file and conversion of one sensor on the emulated bus
+typedef struct {
+    SSP2_EMU_SLAVE slave;
+    uint8_t registers[BMP180_SIM_REG_COUNT];
+    uint8_t pointer;
+    bool pointerWritten;
+    BMP180_CONV_TYPE pendingConversion;
+    uint8_t pendingOss;
+    uint64_t completionNs;
+    BMP180_SIM_STATS stats;
+} BMP180_SIM_DEVICE;
+
+// Local variables
+static BMP180_SIM_DEVICE devices[BMP180_SIM_MAX_SENSORS];
+static uint8_t deviceCount;
+static BMP180_CAL_COEFF coeff;
+static const BMP180_SIM_POINT *pProfile;
+static uint8_t profileLength;
+static uint16_t temperatureNoise;
+static uint16_t pressureNoise;
+static uint32_t noiseState;
+static uint8_t conversionPercent;
+static BMP180_SIM_FAULT fault;
+
+// Local function prototypes
+static bool startSensor(void *pContext, bool read);
+static bool writeSensor(void *pContext, uint8_t data);
+static uint8_t readSensor(void *pContext);
+static void writeRegister(BMP180_SIM_DEVICE *pDevice, uint8_t reg,
+        uint8_t data);
+static void startConversion(BMP180_SIM_DEVICE *pDevice, uint8_t ctrlMeas);
+static void updateConversion(BMP180_SIM_DEVICE *pDevice);
+static void latchResult(BMP180_SIM_DEVICE *pDevice);
+static uint16_t getRawTemperature(uint32_t timeMs);
+static void resetRegisters(BMP180_SIM_DEVICE *pDevice);
+static bool isResultRegister(uint8_t reg);
+static int32_t calcB5(uint16_t rawTemperature);
+static int32_t calcB3(int32_t b6, uint8_t oss);
+static int32_t addNoise(int32_t value, uint16_t amplitude);
+
+
+/******************************************************************************* 
+ * Function to initialise the BMP180 model
+ ******************************************************************************/
+/*
+ * @brief This function resets the model to a sensor with the calibration of
+ * the data sheet example, a constant profile of 15.0 Celsius degree and
+ * 101325 Pa, no noise and no fault, and attaches it to the emulated bus at
+ * BMP180_I2C_ADDR. Sensors attached before are removed from the model. It
+ * has to be invoked after initSsp2Emu().
+ * 
+ * @param None
+ * 
+ * @return True if the sensor has been attached
+ * 
+*/
+bool initBmp180Sim(void) {
+    
+    coeff = defaultCoeff;
+    pProfile = &defaultProfile;
+    profileLength = 1;
+    temperatureNoise = 0;
+    pressureNoise = 0;
+    noiseState = 1;
+    conversionPercent = BMP180_SIM_MAX_PERCENT;
+    fault = BMP180_SIM_FAULT_NONE;
+    deviceCount = 0;
+
+    return attachBmp180Sim(attachSsp2Slave);
+}
+
+
+/******************************************************************************* 
+ * Function to attach a further sensor to the model
+ ******************************************************************************/
+/*
+ * @brief This function attaches another sensor at BMP180_I2C_ADDR to the bus
+ * of the given emulator, e.g. attachSsp1Slave() to run a sensor on each
+ * bus. Every sensor has its own registers, conversions and statistics, while
+ * the calibration, profile, noise and faults apply to all of them.
+ * 
+ * @param attachSlave -> function attaching a slave to the emulated bus
+ * 
+ * @return True if the sensor has been attached
+ * 
+*/
+bool attachBmp180Sim(bool (*attachSlave)(const SSP2_EMU_SLAVE *pSlave)) {
+    
+    BMP180_SIM_DEVICE *pDevice;
+
+    if (deviceCount >= BMP180_SIM_MAX_SENSORS)
+        return false;
+
+    pDevice = &devices[deviceCount];
+    *pDevice = (BMP180_SIM_DEVICE) {
+        {BMP180_I2C_ADDR, startSensor, writeSensor, readSensor, NULL, 0,
+                pDevice}
+    };
+    resetRegisters(pDevice);
+    if (!attachSlave(&pDevice->slave))
+        return false;
+    deviceCount++;
+    setBmp180SimCalibration(&coeff);
+
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to program the calibration EEPROM
+ ******************************************************************************/
+/*
+ * @brief This function stores the coefficients MSB first at 0xAA to 0xBF.
+ * Coefficients far from the data sheet example may break the inversion of
+ * the compensation.
+ * 
+ * @param pointer to the coefficients (BMP180_CAL_COEFF)
+ * 
+ * @return void
+ * 
+*/
+void setBmp180SimCalibration(const BMP180_CAL_COEFF *pCoeff) {
+    
+    const uint16_t words[BMP180_CAL_DATA_SIZE / 2] = {
+        (uint16_t) pCoeff->ac1, (uint16_t) pCoeff->ac2,
+        (uint16_t) pCoeff->ac3, pCoeff->ac4, pCoeff->ac5, pCoeff->ac6,
+        (uint16_t) pCoeff->b1, (uint16_t) pCoeff->b2, (uint16_t) pCoeff->mb,
+        (uint16_t) pCoeff->mc, (uint16_t) pCoeff->md
+    };
+
+    uint8_t *pRegisters;
+
+    coeff = *pCoeff;
+    for (uint8_t n = 0; n < deviceCount; n++) {
+        pRegisters = devices[n].registers;
+        for (uint8_t i = 0; i < BMP180_CAL_DATA_SIZE / 2; i++) {
+            pRegisters[BMP180_CAL_COEFF_AC1_MSB + 2 * i] =
+                    (uint8_t) (words[i] >> 8);
+            pRegisters[BMP180_CAL_COEFF_AC1_LSB + 2 * i] = (uint8_t) words[i];
+        }
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to set the profile of the temperature and pressure
+ ******************************************************************************/
+/*
+ * @brief This function sets the points the results are interpolated from.
+ * The points have to be sorted by time and remain valid while the model is
+ * used. Before the first and after the last point, the values are constant.
+ * 
+ * @param pointer to the points (BMP180_SIM_POINT), number of points
+ * 
+ * @return void
+ * 
+*/
+void setBmp180SimProfile(const BMP180_SIM_POINT *pPoints, uint8_t count) {
+    
+    if (pPoints == NULL || count == 0) {
+        pPoints = &defaultProfile;
+        count = 1;
+    }
+    pProfile = pPoints;
+    profileLength = count;
+}
+
+
+/******************************************************************************* 
+ * Function to set the noise of the raw values
+ ******************************************************************************/
+/*
+ * @brief This function sets the amplitude of the uniformly distributed noise,
+ * which is added to UT and UP, in LSB of the raw values. The noise sequence
+ * is reproducible for a given seed.
+ * 
+ * @param amplitude of UT and UP (uint16_t), seed (uint32_t)
+ * 
+ * @return void
+ * 
+*/
+void setBmp180SimNoise(uint16_t temperatureLsb, uint16_t pressureLsb,
+        uint32_t seed) {
+
+    temperatureNoise = temperatureLsb;
+    pressureNoise = pressureLsb;
+    noiseState = seed;
+}
+
+
+/******************************************************************************* 
+ * Function to scale the conversion times
+ ******************************************************************************/
+/*
+ * @brief The real sensor usually completes a conversion before the max. time
+ * of the data sheet. This function shortens the conversions to the given
+ * percentage of the max. time, e.g. to exercise the SCO polling.
+ * 
+ * @param percentage of the max. conversion time, 1 to 100 (uint8_t)
+ * 
+ * @return void
+ * 
+*/
+void setBmp180SimConversionScale(uint8_t percent) {
+    
+    if (percent == 0 || percent > BMP180_SIM_MAX_PERCENT)
+        percent = BMP180_SIM_MAX_PERCENT;
+    conversionPercent = percent;
+}
+
+
+/******************************************************************************* 
+ * Function to inject a fault
+ ******************************************************************************/
+/*
+ * @brief This function injects a fault of the sensor, which persists until
+ * BMP180_SIM_FAULT_NONE is set.
+ * 
+ * @param fault (BMP180_SIM_FAULT)
+ * 
+ * @return void
+ * 
+*/
+void setBmp180SimFault(BMP180_SIM_FAULT value) {
+    
+    fault = value;
+    for (uint8_t n = 0; n < deviceCount; n++)
+        devices[n].registers[BMP180_REG_CHIP_ID] =
+                (fault == BMP180_SIM_FAULT_CHIP_ID)
+                ? BMP180_SIM_CHIP_ID_BMP280 : BMP180_REG_CHIP_ID_VALUE;
+}
+
+
+/******************************************************************************* 
+ * Function to get the values of the profile
+ ******************************************************************************/
+/*
+ * @brief This function interpolates the profile at the given time.
+ * 
+ * @param time in ms (uint32_t), pointers to the temperature in 0.1 Celsius
+ * degree (int16_t) and the pressure in Pa (int32_t)
+ * 
+ * @return void
+ * 
+*/
+void getBmp180SimTarget(uint32_t timeMs, int16_t *pTemperature,
+        int32_t *pPressure) {
+
+    const BMP180_SIM_POINT *pPrev = &pProfile[0];
+    const BMP180_SIM_POINT *pNext;
+    int64_t elapsed, span;
+    uint8_t i;
+
+    for (i = 1; i < profileLength && pProfile[i].timeMs <= timeMs; i++)
+        pPrev = &pProfile[i];
+    if (i >= profileLength || timeMs <= pPrev->timeMs) {
+        *pTemperature = pPrev->temperature;
+        *pPressure = pPrev->pressure;
+        return;
+    }
+
+    pNext = &pProfile[i];
+    elapsed = timeMs - pPrev->timeMs;
+    span = pNext->timeMs - pPrev->timeMs;
+    *pTemperature = (int16_t) (pPrev->temperature
+            + (pNext->temperature - pPrev->temperature) * elapsed / span);
+    *pPressure = (int32_t) (pPrev->pressure
+            + (pNext->pressure - pPrev->pressure) * elapsed / span);
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics of the sensor
+ ******************************************************************************/
+/*
+ * @brief This function returns the statistics of the sensor attached by
+ * initBmp180Sim() since the last reset.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics
+ * 
+*/
+const BMP180_SIM_STATS *getBmp180SimStats(void) {
+    
+    return &devices[0].stats;
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics of an attached sensor
+ ******************************************************************************/
+/*
+ * @brief This function returns the statistics of an attached sensor since
+ * the last reset. The sensor attached by initBmp180Sim() has the index 0,
+ * further ones follow in the order they have been attached.
+ * 
+ * @param index of the sensor (uint8_t)
+ * 
+ * @return pointer to the statistics, NULL if no sensor has this index
+ * 
+*/
+const BMP180_SIM_STATS *getBmp180SimSensorStats(uint8_t index) {
+    
+    return (index < deviceCount) ? &devices[index].stats : NULL;
+}
+
+
+/******************************************************************************* 
+ * Function to reset the statistics of the sensor
+ ******************************************************************************/
+/*
+ * @brief This function clears the statistics of all sensors.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void resetBmp180SimStats(void) {
+    
+    for (uint8_t n = 0; n < deviceCount; n++)
+        devices[n].stats = (BMP180_SIM_STATS) {0};
+}
+
+
+/******************************************************************************* 
+ * Function to calculate the true temperature
+ ******************************************************************************/
+/*
+ * @brief This function calculates the temperature like the data sheet.
+ * 
+ * @param raw temperature UT (uint16_t)
+ * 
+ * @return temperature in 0.1 Celsius degree (int16_t)
+ * 
+*/
+int16_t calcBmp180SimTemperature(uint16_t rawTemperature) {
+    
+    return (int16_t) ((calcB5(rawTemperature) + 8) >> 4);
+}
+
+
+/******************************************************************************* 
+ * Function to calculate the true pressure
+ ******************************************************************************/
+/*
+ * @brief This function calculates the pressure like the data sheet.
+ * 
+ * @param raw pressure UP (uint32_t), raw temperature UT (uint16_t),
+ * oversampling setting (uint8_t)
+ * 
+ * @return pressure in Pa (int32_t)
+ * 
+*/
+int32_t calcBmp180SimPressure(uint32_t rawPressure, uint16_t rawTemperature,
+        uint8_t oss) {
+
+    int32_t b6, x1, x2, x3, b3, p;
+    uint32_t b4, b7;
+
+    b6 = calcB5(rawTemperature) - 4000;
+    b3 = calcB3(b6, oss);
+    x1 = (coeff.ac3 * b6) >> 13;
+    x2 = (coeff.b1 * ((b6 * b6) >> 12)) >> 16;
+    x3 = ((x1 + x2) + 2) >> 2;
+    b4 = (coeff.ac4 * (uint32_t) (x3 + 32768)) >> 15;
+    if (b4 == 0)
+        return 0;
+    b7 = ((uint32_t) rawPressure - b3) * (50000 >> oss);
+    if (b7 < 0x80000000)
+        p = (int32_t) ((b7 * 2) / b4);
+    else
+        p = (int32_t) ((b7 / b4) * 2);
+    x1 = (p >> 8) * (p >> 8);
+    x1 = (x1 * 3038) >> 16;
+    x2 = (-7357 * p) >> 16;
+
+    return p + ((x1 + x2 + 3791) >> 4);
+}
+
+
+/******************************************************************************* 
+ * Function to find the raw temperature of a temperature
+ ******************************************************************************/
+/*
+ * @brief This function returns the lowest UT, which is compensated to at
+ * least the given temperature.
+ * 
+ * @param temperature in 0.1 Celsius degree (int16_t)
+ * 
+ * @return raw temperature UT (uint16_t)
+ * 
+*/
+uint16_t calcBmp180SimRawTemperature(int16_t temperature) {
+    
+    uint32_t low = coeff.ac6;
+    uint32_t high = BMP180_SIM_RAW_TEMP_MAX;
+    uint32_t middle;
+
+    while (low < high) {
+        middle = (low + high) / 2;
+        if (calcBmp180SimTemperature((uint16_t) middle) < temperature)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return (uint16_t) low;
+}
+
+
+/******************************************************************************* 
+ * Function to find the raw pressure of a pressure
+ ******************************************************************************/
+/*
+ * @brief This function returns the lowest UP, which is compensated to at
+ * least the given pressure at the given raw temperature.
+ * 
+ * @param pressure in Pa (int32_t), raw temperature UT (uint16_t),
+ * oversampling setting (uint8_t)
+ * 
+ * @return raw pressure UP (uint32_t)
+ * 
+*/
+uint32_t calcBmp180SimRawPressure(int32_t pressure, uint16_t rawTemperature,
+        uint8_t oss) {
+
+    int32_t b3 = calcB3(calcB5(rawTemperature) - 4000, oss);
+    uint32_t low = (b3 > 0) ? (uint32_t) b3 : 0;
+    uint32_t high = (1UL << (16 + oss)) - 1;
+    uint32_t middle;
+
+    while (low < high) {
+        middle = (low + high) / 2;
+        if (calcBmp180SimPressure(middle, rawTemperature, oss) < pressure)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+
+/******************************************************************************* 
+ * Slave callbacks of the emulated bus
+ ******************************************************************************/
+/* The sensor acknowledges its address unless it is absent. A write transfer
+ * starts with the register pointer. */
+static bool startSensor(void *pContext, bool read) {
+    
+    BMP180_SIM_DEVICE *pDevice = pContext;
+
+    if (fault == BMP180_SIM_FAULT_ABSENT)
+        return false;
+
+    updateConversion(pDevice);
+    if (!read)
+        pDevice->pointerWritten = false;
+    else if (pDevice->pendingConversion != BMP180_CONV_NONE
+            && isResultRegister(pDevice->pointer))
+        pDevice->stats.earlyReads++;
+
+    return true;
+}
+
+static bool writeSensor(void *pContext, uint8_t data) {
+    
+    BMP180_SIM_DEVICE *pDevice = pContext;
+
+    if (fault == BMP180_SIM_FAULT_DATA_NACK)
+        return false;
+
+    if (!pDevice->pointerWritten) {
+        pDevice->pointer = data;
+        pDevice->pointerWritten = true;
+    } else {
+        writeRegister(pDevice, pDevice->pointer++, data);
+        pDevice->stats.registerWrites++;
+    }
+
+    return true;
+}
+
+static uint8_t readSensor(void *pContext) {
+    
+    BMP180_SIM_DEVICE *pDevice = pContext;
+
+    updateConversion(pDevice);
+    pDevice->stats.registerReads++;
+
+    return pDevice->registers[pDevice->pointer++];
+}
+
+
+/******************************************************************************* 
+ * Function to write a register
+ ******************************************************************************/
+/*
+ * @brief Only ctrl_meas and the soft reset register are writable.
+ * 
+ * @param pointer to the sensor, register address, data (uint8_t)
+ * 
+ * @return void
+ * 
+*/
+static void writeRegister(BMP180_SIM_DEVICE *pDevice, uint8_t reg,
+        uint8_t data) {
+    
+    switch (reg) {
+        case BMP180_REG_CTRL_MEAS:
+            startConversion(pDevice, data);
+            break;
+        case BMP180_REG_SOFT_RESET:
+            if (data == BMP180_SIM_SOFT_RESET_VALUE) {
+                resetRegisters(pDevice);
+                pDevice->stats.softResets++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to start a conversion
+ ******************************************************************************/
+/*
+ * @brief A conversion starts if the measurement control and SCO bits match
+ * the values of the data sheet; writing ctrl_meas during a conversion
+ * restarts it. Other values are stored only.
+ * 
+ * @param pointer to the sensor, value of ctrl_meas (uint8_t)
+ * 
+ * @return void
+ * 
+*/
+static void startConversion(BMP180_SIM_DEVICE *pDevice, uint8_t ctrlMeas) {
+    
+    uint8_t mode = ctrlMeas & BMP180_SIM_CTRL_MEAS_MODE_MASK;
+    uint64_t durationNs;
+
+    if (pDevice->pendingConversion != BMP180_CONV_NONE)
+        pDevice->stats.restartedConversions++; // aborted without a result
+    pDevice->registers[BMP180_REG_CTRL_MEAS] = ctrlMeas;
+    pDevice->pendingConversion = BMP180_CONV_NONE;
+
+    if (mode == BMP180_CTRL_MEAS_VAL_TEMP) {
+        pDevice->pendingConversion = BMP180_CONV_TEMPERATURE;
+        durationNs = BMP180_SIM_CONV_NS_TEMP;
+    } else if (mode == BMP180_CTRL_MEAS_VAL_OSS_0) {
+        pDevice->pendingConversion = BMP180_CONV_PRESSURE;
+        pDevice->pendingOss = ctrlMeas >> BMP180_SIM_CTRL_MEAS_OSS_POS;
+        durationNs = pressureConvNs[pDevice->pendingOss];
+    } else {
+        return;
+    }
+    pDevice->completionNs = getHostClockNs()
+            + durationNs * conversionPercent / BMP180_SIM_MAX_PERCENT;
+}
+
+
+/******************************************************************************* 
+ * Function to complete a conversion once its time has elapsed
+ ******************************************************************************/
+/*
+ * @brief With the SCO_STUCK fault, the conversion never completes.
+ * 
+ * @param pointer to the sensor
+ * 
+ * @return void
+ * 
+*/
+static void updateConversion(BMP180_SIM_DEVICE *pDevice) {
+    
+    if (pDevice->pendingConversion == BMP180_CONV_NONE
+            || fault == BMP180_SIM_FAULT_SCO_STUCK
+            || getHostClockNs() < pDevice->completionNs)
+        return;
+
+    latchResult(pDevice);
+    pDevice->registers[BMP180_REG_CTRL_MEAS] &= ~BMP180_CTRL_MEAS_SCO_BIT;
+    pDevice->pendingConversion = BMP180_CONV_NONE;
+}
+
+
+/******************************************************************************* 
+ * Function to latch the result of the completed conversion
+ ******************************************************************************/
+/*
+ * @brief UT is stored in 0xF6 and 0xF7, UP left-aligned in 0xF6 to 0xF8.
+ * 
+ * @param pointer to the sensor
+ * 
+ * @return void
+ * 
+*/
+static void latchResult(BMP180_SIM_DEVICE *pDevice) {
+    
+    uint8_t *pRegisters = pDevice->registers;
+    uint32_t timeMs = (uint32_t) (pDevice->completionNs / 1000000);
+    uint8_t oss = pDevice->pendingOss;
+    int16_t temperature;
+    int32_t pressure;
+    uint16_t rawTemperature;
+    int32_t rawValue;
+    int32_t maxRawValue;
+
+    getBmp180SimTarget(timeMs, &temperature, &pressure);
+    rawTemperature = getRawTemperature(timeMs);
+
+    if (pDevice->pendingConversion == BMP180_CONV_TEMPERATURE) {
+        rawValue = addNoise(rawTemperature, temperatureNoise);
+        if (rawValue > BMP180_SIM_RAW_TEMP_MAX)
+            rawValue = BMP180_SIM_RAW_TEMP_MAX;
+        pRegisters[BMP180_REG_OUT_MSB] = (uint8_t) (rawValue >> 8);
+        pRegisters[BMP180_REG_OUT_LSB] = (uint8_t) rawValue;
+        pDevice->stats.temperatureConversions++;
+    } else {
+        maxRawValue = (int32_t) (1UL << (16 + oss)) - 1;
+        rawValue = addNoise((int32_t) calcBmp180SimRawPressure(pressure,
+                rawTemperature, oss), pressureNoise);
+        if (rawValue > maxRawValue)
+            rawValue = maxRawValue;
+        rawValue <<= 8 - oss;
+        pRegisters[BMP180_REG_OUT_MSB] = (uint8_t) (rawValue >> 16);
+        pRegisters[BMP180_REG_OUT_LSB] = (uint8_t) (rawValue >> 8);
+        pRegisters[BMP180_REG_OUT_XLSB] = (uint8_t) rawValue;
+        pDevice->stats.pressureConversions++;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to get the raw temperature of the profile
+ ******************************************************************************/
+/*
+ * @brief UT is interpolated between the points of the profile instead of 
+ * being derived from the temperature, which is rounded to 0.1 degree. Thus,
+ * UT doesn't step between a temperature and the following pressure 
+ * conversion, which would shift the compensated pressure by some 10 Pa.
+ * 
+ * @param time in ms (uint32_t)
+ * 
+ * @return UT (uint16_t)
+ * 
+*/
+static uint16_t getRawTemperature(uint32_t timeMs) {
+
+    const BMP180_SIM_POINT *pPrev = &pProfile[0];
+    int32_t prevRaw, nextRaw;
+    int64_t elapsed, span;
+    uint8_t i;
+
+    for (i = 1; i < profileLength && pProfile[i].timeMs <= timeMs; i++)
+        pPrev = &pProfile[i];
+    prevRaw = calcBmp180SimRawTemperature(pPrev->temperature);
+    if (i >= profileLength || timeMs <= pPrev->timeMs)
+        return (uint16_t) prevRaw;
+
+    nextRaw = calcBmp180SimRawTemperature(pProfile[i].temperature);
+    elapsed = timeMs - pPrev->timeMs;
+    span = pProfile[i].timeMs - pPrev->timeMs;
+    return (uint16_t) (prevRaw + (nextRaw - prevRaw) * elapsed / span);
+}
+
+
+/******************************************************************************* 
+ * Function to reset the registers
+ ******************************************************************************/
+/*
+ * @brief This function restores the power-on values of the registers and
+ * aborts a running conversion. The calibration EEPROM is retained.
+ * 
+ * @param pointer to the sensor
+ * 
+ * @return void
+ * 
+*/
+static void resetRegisters(BMP180_SIM_DEVICE *pDevice) {
+    
+    uint8_t *pRegisters = pDevice->registers;
+
+    pRegisters[BMP180_REG_CHIP_ID] = (fault == BMP180_SIM_FAULT_CHIP_ID)
+            ? BMP180_SIM_CHIP_ID_BMP280 : BMP180_REG_CHIP_ID_VALUE;
+    pRegisters[BMP180_REG_CTRL_MEAS] = 0;
+    pRegisters[BMP180_REG_OUT_MSB] = BMP180_SIM_OUT_MSB_RESET;
+    pRegisters[BMP180_REG_OUT_LSB] = 0;
+    pRegisters[BMP180_REG_OUT_XLSB] = 0;
+    pDevice->pendingConversion = BMP180_CONV_NONE;
+}
+
+
+/******************************************************************************* 
+ * Helper functions
+ ******************************************************************************/
+static bool isResultRegister(uint8_t reg) {
+    
+    return reg >= BMP180_REG_OUT_MSB && reg <= BMP180_REG_OUT_XLSB;
+}
+
+/* B5 of the data sheet; the divisor can't become zero above AC6 */
+static int32_t calcB5(uint16_t rawTemperature) {
+    
+    int32_t x1 = (((int32_t) rawTemperature - coeff.ac6) * coeff.ac5) >> 15;
+    int32_t x2;
+
+    if (x1 + coeff.md == 0)
+        return x1;
+    x2 = ((int32_t) coeff.mc << 11) / (x1 + coeff.md);
+
+    return x1 + x2;
+}
+
+/* B3 of the data sheet, which divides by 4 instead of shifting */
+static int32_t calcB3(int32_t b6, uint8_t oss) {
+    
+    int32_t x1 = (coeff.b2 * ((b6 * b6) >> 12)) >> 11;
+    int32_t x2 = (coeff.ac2 * b6) >> 11;
+
+    return ((((int32_t) coeff.ac1 * 4 + x1 + x2) << oss) + 2) / 4;
+}
+
+/* Adds uniformly distributed noise of +/- amplitude by an LCG */
+static int32_t addNoise(int32_t value, uint16_t amplitude) {
+    
+    if (amplitude == 0)
+        return value;
+    noiseState = noiseState * BMP180_SIM_LCG_MULTIPLIER
+            + BMP180_SIM_LCG_INCREMENT;
+    value += (int32_t) ((noiseState >> 16) % (2UL * amplitude + 1))
+            - amplitude;
+
+    return (value < 0) ? 0 : value;
+}
@@ -0,0 +1,88 @@
+/*
+ * File:                bmp180_sim.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Sensor:              Bosch BMP180 barometric pressure sensor
+
+ * Description:
+ * ------------
+ * This module models the BMP180 at register level as a slave of the MSSP2
+ * emulator, so that the BMP180 driver, the I2C2 simple master and the state
+ * machine run unmodified on the host. The model holds the chip-id, the
+ * calibration EEPROM and the control register ctrl_meas. A write of ctrl_meas
+ * starts a conversion, which takes the max. conversion time of the data sheet
+ * for the selected oversampling setting (oss) in emulated time. The SCO bit
+ * remains set until then and the result registers are latched on completion.
+ * 
+ * The results follow a scripted profile of the temperature and pressure over
+ * the emulated time. UT and UP are found by inverting the compensation of the
+ * data sheet, which is implemented here independently of the driver. Noise
+ * can be added to the raw values and faults of the sensor can be injected.
+ * Further sensors can be attached to other buses, e.g. to the MSSP1
+ * emulator; they share the profile and the calibration, but convert
+ * independently.
+ * 
+ */
+
+#ifndef BMP180_SIM_H
+#define	BMP180_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../bmp180.h"
+#include "ssp2_emu.h"
+
+#define BMP180_SIM_CHIP_ID_BMP280       0x58 // reported by the CHIP_ID fault
+#define BMP180_SIM_MAX_SENSORS          2
+
+// Point of the scripted profile; the values are interpolated linearly
+typedef struct {
+    uint32_t timeMs;            // emulated time since initHostClock()
+    int16_t temperature;        // 0.1 Celsius degree
+    int32_t pressure;           // Pa
+} BMP180_SIM_POINT;
+
+// Faults of the sensor
+typedef enum {
+    BMP180_SIM_FAULT_NONE,
+    BMP180_SIM_FAULT_ABSENT,    // address not acknowledged
+    BMP180_SIM_FAULT_CHIP_ID,   // chip-id of another sensor
+    BMP180_SIM_FAULT_SCO_STUCK, // conversions never complete
+    BMP180_SIM_FAULT_DATA_NACK  // bytes written after the address NACKed
+} BMP180_SIM_FAULT;
+
+// Statistics of the sensor
+typedef struct {
+    uint32_t temperatureConversions;    // completed conversions
+    uint32_t pressureConversions;
+    uint32_t restartedConversions;      // ctrl_meas written while converting
+    uint32_t earlyReads;        // result read while a conversion is running
+    uint32_t registerReads;     // bytes read
+    uint32_t registerWrites;    // bytes written, excl. the register pointer
+    uint32_t softResets;
+} BMP180_SIM_STATS;
+
+bool initBmp180Sim(void);
+bool attachBmp180Sim(bool (*attachSlave)(const SSP2_EMU_SLAVE *pSlave));
+void setBmp180SimCalibration(const BMP180_CAL_COEFF *pCoeff);
+void setBmp180SimProfile(const BMP180_SIM_POINT *pPoints, uint8_t count);
+void setBmp180SimNoise(uint16_t temperatureLsb, uint16_t pressureLsb,
+        uint32_t seed);
+void setBmp180SimConversionScale(uint8_t percent);
+void setBmp180SimFault(BMP180_SIM_FAULT fault);
+void getBmp180SimTarget(uint32_t timeMs, int16_t *pTemperature,
+        int32_t *pPressure);
+const BMP180_SIM_STATS *getBmp180SimStats(void);
+const BMP180_SIM_STATS *getBmp180SimSensorStats(uint8_t index);
+void resetBmp180SimStats(void);
+
+// Compensation of the data sheet and its inverse
+int16_t calcBmp180SimTemperature(uint16_t rawTemperature);
+int32_t calcBmp180SimPressure(uint32_t rawPressure, uint16_t rawTemperature,
+        uint8_t oss);
+uint16_t calcBmp180SimRawTemperature(int16_t temperature);
+uint32_t calcBmp180SimRawPressure(int32_t pressure, uint16_t rawTemperature,
+        uint8_t oss);
+
+#endif	/* BMP180_SIM_H */
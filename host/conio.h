@@ -0,0 +1,19 @@
+/*
+ * File:                conio.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * Stand-in for the XC8 console header included by mcc.h. On the host,
+ * printf() writes to stdout, so nothing needs to be declared.
+ * 
+ */
+
+#ifndef HOST_CONIO_H
+#define	HOST_CONIO_H
+
+#include <stdio.h>
+
+#endif	/* HOST_CONIO_H */
@@ -0,0 +1,707 @@
+/**
+ * 
+ * File:                hd44780_emu.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Display:             LCD 16x2 - Hitachi HD44780
+
+ * Description:
+ * ------------
+ * This module contains the HD44780 emulator. The pins are sampled whenever
+ * the firmware accesses port D or delays, hence an edge is seen at the first
+ * sample after the write of the latch. The bus timing is checked against the
+ * data sheet with the resolution of these samples:
+ * 
+ *      enable pulse width (high)       PWEH    230 ns
+ *      enable cycle time               tcycE   500 ns
+ *      data set-up time                tDSW     80 ns
+ *      RS and RW stable while EN is high
+ * 
+ * The execution times are those of the data sheet at fOSC = 270 kHz:
+ * 
+ *      clear display, return home              1.52 ms
+ *      other instructions                      37 us
+ *      write or read data                      37 us + tADD 4 us
+ *      function set, 1st/2nd after power-on    4.1 ms / 100 us
+ * 
+*/
+
+
+#include <string.h>
+#include <xc.h>
+#include "hd44780_emu.h"
+#include "host_clock.h"
+
+#define HD44780_EMU_PIN_BL          0x01
+#define HD44780_EMU_PIN_RS          0x02
+#define HD44780_EMU_PIN_RW          0x04
+#define HD44780_EMU_PIN_EN          0x08
+#define HD44780_EMU_PINS_DATA       0xF0    // DB4 to DB7
+#define HD44780_EMU_DATA_SHIFT      4
+#define HD44780_EMU_DDRAM_SIZE      128     // incl. the unused addresses
+#define HD44780_EMU_ONE_LINE_LENGTH 80
+#define HD44780_EMU_BUSY_FLAG       0x80
+
+// Bus timing in ns
+#define HD44780_EMU_PW_EH_NS        230
+#define HD44780_EMU_CYCLE_NS        500
+#define HD44780_EMU_DATA_SETUP_NS   80
+
+// Execution times in ns
+#define HD44780_EMU_POWER_ON_NS     15000000
+#define HD44780_EMU_LONG_EXEC_NS    1520000
+#define HD44780_EMU_EXEC_NS         37000
+#define HD44780_EMU_ADD_NS          4000
+#define HD44780_EMU_RESET_1ST_NS    4100000
+#define HD44780_EMU_RESET_2ND_NS    100000
+
+// Instructions
+#define HD44780_EMU_CMD_SET_DDRAM   0x80
+#define HD44780_EMU_CMD_SET_CGRAM   0x40
+#define HD44780_EMU_CMD_FUNCTION    0x20
+#define HD44780_EMU_CMD_SHIFT       0x10
+#define HD44780_EMU_CMD_DISPLAY     0x08
+#define HD44780_EMU_CMD_ENTRY_MODE  0x04
+#define HD44780_EMU_CMD_HOME        0x02
+#define HD44780_EMU_CMD_CLEAR       0x01
+
+// Bits of the instructions
+#define HD44780_EMU_FUNCTION_DL     0x10
+#define HD44780_EMU_FUNCTION_N      0x08
+#define HD44780_EMU_SHIFT_SC        0x08
+#define HD44780_EMU_SHIFT_RL        0x04
+#define HD44780_EMU_DISPLAY_D       0x04
+#define HD44780_EMU_DISPLAY_C       0x02
+#define HD44780_EMU_DISPLAY_B       0x01
+#define HD44780_EMU_ENTRY_ID        0x02
+#define HD44780_EMU_ENTRY_S         0x01
+
+extern volatile LATDbits_t hostLatdbits;
+
+// Local variables
+static uint8_t ddram[HD44780_EMU_DDRAM_SIZE];
+static uint8_t cgram[HD44780_EMU_CGRAM_SIZE];
+static HD44780_EMU_STATE state;
+static uint64_t busyUntilNs;
+static uint8_t resetSteps;          // function sets since power-on
+static bool isLowerNibbleDue;       // 4-bit mode: 2nd transfer of a byte
+static uint8_t upperNibble;
+static bool enableLevel;
+static bool hasPulsed;
+static uint8_t latchedPins;         // pins while EN is high
+static uint64_t riseNs;
+static uint64_t dataChangeNs;
+static bool isContending;           // during this enable pulse
+static uint64_t sampleNs;           // time of the previous sample
+static HD44780_EMU_OP pendingOp;    // HD44780_EMU_OP_COUNT if none
+static uint64_t opStartNs;
+static HD44780_EMU_STATS stats;
+
+static const char *opNames[HD44780_EMU_OP_COUNT] = {
+    "clear display",
+    "return home",
+    "entry mode set",
+    "display control",
+    "cursor/display shift",
+    "function set",
+    "set CGRAM address",
+    "set DDRAM address",
+    "write data",
+    "read busy flag",
+    "read data"
+};
+
+// Local function prototypes
+static void sampleHd44780Pins(void);
+static uint8_t driveHd44780Pins(void);
+static void transferNibble(uint8_t pins, uint64_t now);
+static void executeWrite(uint8_t value, bool isData, uint64_t now);
+static void executeInstruction(uint8_t value, uint64_t now);
+static void completeRead(bool isData);
+static void stepAddress(bool increment);
+static void shiftDisplay(bool right);
+static void beginOperation(uint64_t now);
+static void reportViolation(uint32_t *pCounter, const char *pDescription);
+
+
+/******************************************************************************* 
+ * Function to initialise the HD44780 emulator
+ ******************************************************************************/
+/*
+ * @brief This function powers the emulated display on: the interface is 8
+ * bits wide, one line and the display are selected, the DDRAM is cleared and
+ * the controller stays busy for 15 ms. It has to be invoked after
+ * initHostClock(), as it connects the emulator to port D and registers the
+ * sampling of the pins as delay hook.
+ * 
+ * @param None
+ * 
+ * @return True if the emulator has been registered
+ * 
+*/
+bool initHd44780Emu(void) {
+    
+    memset(ddram, ' ', sizeof(ddram));
+    memset(cgram, 0, sizeof(cgram));
+    memset(&state, 0, sizeof(state));
+    state.isIncrement = true;
+    busyUntilNs = getHostClockNs() + HD44780_EMU_POWER_ON_NS;
+    resetSteps = 0;
+    isLowerNibbleDue = false;
+    enableLevel = false;
+    hasPulsed = false;
+    sampleNs = getHostClockNs();
+    resetHd44780EmuStats();
+    setHostPortdHooks(sampleHd44780Pins, driveHd44780Pins);
+
+    return addHostDelayHook(sampleHd44780Pins);
+}
+
+
+/******************************************************************************* 
+ * Function to capture the screen
+ ******************************************************************************/
+/*
+ * @brief This function copies the visible characters into a string per line.
+ * CGRAM characters are captured as HD44780_EMU_CGRAM_GLYPH and the screen is
+ * blank while the display is off. The cursor isn't captured.
+ * 
+ * @param screen, which receives the NUL-terminated lines
+ * 
+ * @return void
+ * 
+*/
+void getHd44780EmuScreen(
+        char screen[HD44780_EMU_LINES][HD44780_EMU_COLUMNS + 1]) {
+    
+    uint8_t address, code;
+
+    sampleHd44780Pins();
+
+    for (uint8_t line = 0; line < HD44780_EMU_LINES; line++) {
+        for (uint8_t column = 0; column < HD44780_EMU_COLUMNS; column++) {
+            if (state.isTwoLines)
+                address = line * HD44780_EMU_SECOND_LINE + (column
+                        + state.displayShift) % HD44780_EMU_LINE_LENGTH;
+            else
+                address = (column + state.displayShift)
+                        % HD44780_EMU_ONE_LINE_LENGTH;
+            code = ddram[address];
+            if (!state.isDisplayOn || (line > 0 && !state.isTwoLines))
+                code = ' ';
+            else if (code < 0x10)
+                code = HD44780_EMU_CGRAM_GLYPH;
+            screen[line][column] = (char) code;
+        }
+        screen[line][HD44780_EMU_COLUMNS] = '\0';
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to read the DDRAM
+ ******************************************************************************/
+/*
+ * @brief This function returns the DDRAM byte without affecting the state.
+ * 
+ * @param address (uint8_t)
+ * 
+ * @return DDRAM byte (uint8_t)
+ * 
+*/
+uint8_t readHd44780EmuDdram(uint8_t address) {
+    
+    sampleHd44780Pins();
+    return ddram[address % HD44780_EMU_DDRAM_SIZE];
+}
+
+
+/******************************************************************************* 
+ * Function to read the CGRAM
+ ******************************************************************************/
+/*
+ * @brief This function returns the CGRAM byte without affecting the state.
+ * 
+ * @param address (uint8_t)
+ * 
+ * @return CGRAM byte (uint8_t)
+ * 
+*/
+uint8_t readHd44780EmuCgram(uint8_t address) {
+    
+    sampleHd44780Pins();
+    return cgram[address % HD44780_EMU_CGRAM_SIZE];
+}
+
+
+/******************************************************************************* 
+ * Function to check the busy flag
+ ******************************************************************************/
+/*
+ * @brief This function returns whether an instruction is being executed.
+ * 
+ * @param None
+ * 
+ * @return True if busy
+ * 
+*/
+bool isHd44780EmuBusy(void) {
+    
+    sampleHd44780Pins();
+    return getHostClockNs() < busyUntilNs;
+}
+
+
+/******************************************************************************* 
+ * Function to get the state
+ ******************************************************************************/
+/*
+ * @brief This function returns the state of the controller.
+ * 
+ * @param None
+ * 
+ * @return pointer to the state (HD44780_EMU_STATE)
+ * 
+*/
+const HD44780_EMU_STATE *getHd44780EmuState(void) {
+    
+    sampleHd44780Pins();
+    return &state;
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics
+ ******************************************************************************/
+/*
+ * @brief This function returns the statistics since the last reset. The time
+ * of the last operation is added once the next one starts.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics (HD44780_EMU_STATS)
+ * 
+*/
+const HD44780_EMU_STATS *getHd44780EmuStats(void) {
+    
+    sampleHd44780Pins();
+    return &stats;
+}
+
+
+/******************************************************************************* 
+ * Function to reset the statistics
+ ******************************************************************************/
+/*
+ * @brief This function clears the statistics. An operation in progress isn't
+ * counted.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void resetHd44780EmuStats(void) {
+    
+    memset(&stats, 0, sizeof(stats));
+    stats.pLastViolation = "";
+    pendingOp = HD44780_EMU_OP_COUNT;
+}
+
+
+/******************************************************************************* 
+ * Function to get the name of an operation
+ ******************************************************************************/
+/*
+ * @brief This function returns the name of the operation for reports.
+ * 
+ * @param operation (HD44780_EMU_OP)
+ * 
+ * @return name (const char *)
+ * 
+*/
+const char *getHd44780EmuOpName(HD44780_EMU_OP op) {
+    
+    return (op < HD44780_EMU_OP_COUNT) ? opNames[op] : "?";
+}
+
+
+/******************************************************************************* 
+ * Function to sample the pins
+ ******************************************************************************/
+/*
+ * @brief This function detects the edges of EN. A rising edge starts an
+ * operation unless the second nibble of a byte is due; the pins are latched
+ * while EN is high and transferred at the falling edge. The firmware has
+ * written the pins right after the previous sample, which is taken as the
+ * time of a change.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void sampleHd44780Pins(void) {
+    
+    uint8_t pins = hostLatdbits.value;
+    bool enable = (pins & HD44780_EMU_PIN_EN) != 0;
+    uint64_t now = sampleNs; // pins written after the previous sample
+
+    sampleNs = getHostClockNs();
+    state.isBacklightOn = (pins & HD44780_EMU_PIN_BL) != 0;
+
+    if (enable && !enableLevel) {
+        if (hasPulsed && now - riseNs < HD44780_EMU_CYCLE_NS)
+            reportViolation(&stats.timingViolations, "enable cycle time");
+        hasPulsed = true;
+        riseNs = now;
+        dataChangeNs = now;
+        isContending = false;
+        if (!isLowerNibbleDue)
+            beginOperation(now);
+    } else if (enable) {
+        if ((pins ^ latchedPins) & (HD44780_EMU_PIN_RS | HD44780_EMU_PIN_RW))
+            reportViolation(&stats.timingViolations,
+                    "RS or RW changed while EN is high");
+        if ((pins ^ latchedPins) & HD44780_EMU_PINS_DATA)
+            dataChangeNs = now;
+    } else if (enableLevel) {
+        if (now - riseNs < HD44780_EMU_PW_EH_NS)
+            reportViolation(&stats.timingViolations, "enable pulse width");
+        if (!(latchedPins & HD44780_EMU_PIN_RW)
+                && now - dataChangeNs < HD44780_EMU_DATA_SETUP_NS)
+            reportViolation(&stats.timingViolations, "data set-up time");
+        transferNibble(latchedPins, now);
+    }
+
+    if (enable) {
+        latchedPins = pins;
+        if ((pins & HD44780_EMU_PIN_RW) && !isContending
+                && (TRISD & HD44780_EMU_PINS_DATA) != HD44780_EMU_PINS_DATA) {
+            isContending = true;
+            reportViolation(&stats.busViolations,
+                    "data pins driven by both sides");
+        }
+    }
+    enableLevel = enable;
+}
+
+
+/******************************************************************************* 
+ * Function to drive the data pins
+ ******************************************************************************/
+/*
+ * @brief This function returns the nibble output by the controller while EN
+ * is high in read mode: the busy flag and the address counter, or the RAM
+ * byte at the address counter. In 4-bit mode, the upper nibble is output by
+ * the first transfer.
+ * 
+ * @param None
+ * 
+ * @return level of the data pins (uint8_t)
+ * 
+*/
+static uint8_t driveHd44780Pins(void) {
+    
+    uint8_t pins = hostLatdbits.value;
+    uint8_t value;
+
+    if (!(pins & HD44780_EMU_PIN_EN) || !(pins & HD44780_EMU_PIN_RW))
+        return 0;
+
+    if (!(pins & HD44780_EMU_PIN_RS))
+        value = (getHostClockNs() < busyUntilNs ? HD44780_EMU_BUSY_FLAG : 0)
+                | state.addressCounter;
+    else if (state.isCgramSelected)
+        value = cgram[state.addressCounter % HD44780_EMU_CGRAM_SIZE];
+    else
+        value = ddram[state.addressCounter];
+
+    if (!state.is4Bit || !isLowerNibbleDue)
+        value >>= HD44780_EMU_DATA_SHIFT;
+
+    return (uint8_t) (value << HD44780_EMU_DATA_SHIFT) & HD44780_EMU_PINS_DATA;
+}
+
+
+/******************************************************************************* 
+ * Function to transfer a nibble
+ ******************************************************************************/
+/*
+ * @brief This function completes a transfer at the falling edge of EN. In
+ * 4-bit mode, two transfers make up a byte.
+ * 
+ * @param pins while EN was high, time of the falling edge
+ * 
+ * @return void
+ * 
+*/
+static void transferNibble(uint8_t pins, uint64_t now) {
+    
+    bool isData = (pins & HD44780_EMU_PIN_RS) != 0;
+    uint8_t nibble = (pins & HD44780_EMU_PINS_DATA) >> HD44780_EMU_DATA_SHIFT;
+    bool isFirst = !state.is4Bit || !isLowerNibbleDue;
+
+    if (state.is4Bit)
+        isLowerNibbleDue = !isLowerNibbleDue;
+
+    if (pins & HD44780_EMU_PIN_RW) {
+        if (!state.is4Bit || !isFirst)
+            completeRead(isData);
+        return;
+    }
+
+    if ((TRISD & HD44780_EMU_PINS_DATA) != 0)
+        reportViolation(&stats.busViolations, "data pins floating on write");
+    if (isFirst && now < busyUntilNs)
+        reportViolation(&stats.busyWrites, "written while busy");
+
+    if (!state.is4Bit)
+        executeWrite(nibble << HD44780_EMU_DATA_SHIFT, isData, now);
+    else if (isFirst)
+        upperNibble = nibble;
+    else
+        executeWrite((upperNibble << HD44780_EMU_DATA_SHIFT) | nibble, isData,
+                now);
+}
+
+
+/******************************************************************************* 
+ * Function to execute a byte written
+ ******************************************************************************/
+/*
+ * @brief This function stores a data byte at the address counter or executes
+ * an instruction, and sets the busy flag for its execution time.
+ * 
+ * @param byte, true if written to the data register, time
+ * 
+ * @return void
+ * 
+*/
+static void executeWrite(uint8_t value, bool isData, uint64_t now) {
+    
+    if (!isData) {
+        executeInstruction(value, now);
+        return;
+    }
+
+    if (state.isCgramSelected) {
+        cgram[state.addressCounter % HD44780_EMU_CGRAM_SIZE] = value;
+    } else {
+        ddram[state.addressCounter] = value;
+        if (state.isShiftOnWrite)
+            shiftDisplay(!state.isIncrement);
+    }
+    stepAddress(state.isIncrement);
+    busyUntilNs = now + HD44780_EMU_EXEC_NS + HD44780_EMU_ADD_NS;
+    pendingOp = HD44780_EMU_OP_WRITE_DATA;
+}
+
+
+/******************************************************************************* 
+ * Function to execute an instruction
+ ******************************************************************************/
+/*
+ * @brief This function decodes the instruction by its highest bit set.
+ * 
+ * @param instruction, time
+ * 
+ * @return void
+ * 
+*/
+static void executeInstruction(uint8_t value, uint64_t now) {
+    
+    uint64_t execNs = HD44780_EMU_EXEC_NS;
+
+    if (value & HD44780_EMU_CMD_SET_DDRAM) {
+        state.addressCounter = value & ~HD44780_EMU_CMD_SET_DDRAM;
+        state.isCgramSelected = false;
+        pendingOp = HD44780_EMU_OP_SET_DDRAM;
+    } else if (value & HD44780_EMU_CMD_SET_CGRAM) {
+        state.addressCounter = value & ~HD44780_EMU_CMD_SET_CGRAM;
+        state.isCgramSelected = true;
+        pendingOp = HD44780_EMU_OP_SET_CGRAM;
+    } else if (value & HD44780_EMU_CMD_FUNCTION) {
+        if (value & HD44780_EMU_FUNCTION_DL) {
+            if (resetSteps == 0)
+                execNs = HD44780_EMU_RESET_1ST_NS;
+            else if (resetSteps == 1)
+                execNs = HD44780_EMU_RESET_2ND_NS;
+            if (resetSteps < 2)
+                resetSteps++;
+            state.is4Bit = false;
+        } else if (!state.is4Bit) {
+            state.is4Bit = true;
+            isLowerNibbleDue = false;
+            resetSteps = 2; // interface initialised
+        }
+        state.isTwoLines = (value & HD44780_EMU_FUNCTION_N) != 0;
+        pendingOp = HD44780_EMU_OP_FUNCTION_SET;
+    } else if (value & HD44780_EMU_CMD_SHIFT) {
+        if (value & HD44780_EMU_SHIFT_SC)
+            shiftDisplay(value & HD44780_EMU_SHIFT_RL);
+        else
+            stepAddress(value & HD44780_EMU_SHIFT_RL);
+        pendingOp = HD44780_EMU_OP_SHIFT;
+    } else if (value & HD44780_EMU_CMD_DISPLAY) {
+        state.isDisplayOn = (value & HD44780_EMU_DISPLAY_D) != 0;
+        state.isCursorOn = (value & HD44780_EMU_DISPLAY_C) != 0;
+        state.isBlinkOn = (value & HD44780_EMU_DISPLAY_B) != 0;
+        pendingOp = HD44780_EMU_OP_DISPLAY_CTRL;
+    } else if (value & HD44780_EMU_CMD_ENTRY_MODE) {
+        state.isIncrement = (value & HD44780_EMU_ENTRY_ID) != 0;
+        state.isShiftOnWrite = (value & HD44780_EMU_ENTRY_S) != 0;
+        pendingOp = HD44780_EMU_OP_ENTRY_MODE;
+    } else if (value & (HD44780_EMU_CMD_HOME | HD44780_EMU_CMD_CLEAR)) {
+        if (value & HD44780_EMU_CMD_HOME) {
+            pendingOp = HD44780_EMU_OP_HOME;
+        } else {
+            memset(ddram, ' ', sizeof(ddram));
+            state.isIncrement = true;
+            pendingOp = HD44780_EMU_OP_CLEAR;
+        }
+        state.addressCounter = 0;
+        state.displayShift = 0;
+        state.isCgramSelected = false;
+        execNs = HD44780_EMU_LONG_EXEC_NS;
+    } else {
+        return; // not an instruction
+    }
+    busyUntilNs = now + execNs;
+}
+
+
+/******************************************************************************* 
+ * Function to complete a read
+ ******************************************************************************/
+/*
+ * @brief This function counts the read operation. Reading RAM data steps the
+ * address counter like a write.
+ * 
+ * @param True if read from the data register
+ * 
+ * @return void
+ * 
+*/
+static void completeRead(bool isData) {
+    
+    if (!isData) {
+        pendingOp = HD44780_EMU_OP_READ_BUSY;
+        return;
+    }
+    stepAddress(state.isIncrement);
+    busyUntilNs = getHostClockNs() + HD44780_EMU_ADD_NS;
+    pendingOp = HD44780_EMU_OP_READ_DATA;
+}
+
+
+/******************************************************************************* 
+ * Function to step the address counter
+ ******************************************************************************/
+/*
+ * @brief In two-line mode, the DDRAM addresses 0x27 and 0x40 as well as 0x67
+ * and 0x00 are adjacent. In one-line mode, the DDRAM ranges from 0x00 to 0x4F.
+ * The CGRAM address wraps at its size.
+ * 
+ * @param True to increment, false to decrement
+ * 
+ * @return void
+ * 
+*/
+static void stepAddress(bool increment) {
+    
+    uint8_t address = state.addressCounter;
+    uint8_t line = (address >= HD44780_EMU_SECOND_LINE) ? 1 : 0;
+    uint8_t column = address - line * HD44780_EMU_SECOND_LINE;
+
+    if (state.isCgramSelected) {
+        address += increment ? 1 : -1;
+        state.addressCounter = address % HD44780_EMU_CGRAM_SIZE;
+        return;
+    } else if (!state.isTwoLines) {
+        state.addressCounter = (address + (increment ? 1
+                : HD44780_EMU_ONE_LINE_LENGTH - 1))
+                % HD44780_EMU_ONE_LINE_LENGTH;
+        return;
+    }
+
+    if (increment && ++column >= HD44780_EMU_LINE_LENGTH) {
+        column = 0;
+        line ^= 1;
+    } else if (!increment && column-- == 0) {
+        column = HD44780_EMU_LINE_LENGTH - 1;
+        line ^= 1;
+    }
+    state.addressCounter = line * HD44780_EMU_SECOND_LINE + column;
+}
+
+
+/******************************************************************************* 
+ * Function to shift the display
+ ******************************************************************************/
+/*
+ * @brief Shifting the display to the right moves the characters to the right,
+ * i.e. the first column shows the DDRAM column to the left of it.
+ * 
+ * @param True to shift to the right, false to the left
+ * 
+ * @return void
+ * 
+*/
+static void shiftDisplay(bool right) {
+    
+    uint8_t length = state.isTwoLines ? HD44780_EMU_LINE_LENGTH
+            : HD44780_EMU_ONE_LINE_LENGTH;
+
+    state.displayShift = (state.displayShift + (right ? length - 1 : 1))
+            % length;
+}
+
+
+/******************************************************************************* 
+ * Function to begin an operation
+ ******************************************************************************/
+/*
+ * @brief This function adds the time of the previous operation to its
+ * statistics, if it has been decoded, and starts timing the next one.
+ * 
+ * @param time of the first enable pulse
+ * 
+ * @return void
+ * 
+*/
+static void beginOperation(uint64_t now) {
+    
+    HD44780_EMU_OP_STATS *pOp;
+    uint64_t duration = now - opStartNs;
+
+    if (pendingOp < HD44780_EMU_OP_COUNT) {
+        pOp = &stats.ops[pendingOp];
+        pOp->count++;
+        pOp->totalNs += duration;
+        if (duration > pOp->maxNs)
+            pOp->maxNs = duration;
+    }
+    pendingOp = HD44780_EMU_OP_COUNT;
+    opStartNs = now;
+}
+
+
+/******************************************************************************* 
+ * Function to report a violation
+ ******************************************************************************/
+/*
+ * @brief This function counts the violation and keeps its description.
+ * 
+ * @param counter, description
+ * 
+ * @return void
+ * 
+*/
+static void reportViolation(uint32_t *pCounter, const char *pDescription) {
+    
+    (*pCounter)++;
+    stats.pLastViolation = pDescription;
+    stats.lastViolationNs = getHostClockNs();
+}
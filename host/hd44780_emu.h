@@ -0,0 +1,101 @@
+/*
+ * File:                hd44780_emu.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Display:             LCD 16x2 - Hitachi HD44780
+
+ * Description:
+ * ------------
+ * This module emulates the HD44780 controller of the LCD connected to port D
+ * (BL = RD0, RS = RD1, RW = RD2, EN = RD3, DB4 to DB7 = RD4 to RD7). It samples
+ * the pins on each access of LATD and PORTD and after each delay, and decodes
+ * the transfers at the falling edge of EN. After reset, the interface is 8
+ * bits wide with DB0 to DB3 read as 0, until a function set selects 4 bits.
+ * 
+ * The model holds the DDRAM, the CGRAM, the address counter, the entry mode,
+ * the display shift and the display control. Each instruction keeps the busy
+ * flag set for its execution time of the data sheet (fOSC = 270 kHz), e.g.
+ * 1.52 ms for clear display and return home. Writes while busy, enable pulses
+ * violating the bus timing and bus contention are counted as violations, but
+ * executed anyway, so that the screen shows what the firmware intended.
+ * 
+ * The time of each operation is measured from its first enable pulse to the
+ * first one of the next operation, i.e. including the time the firmware needs
+ * until it starts the next one, e.g. polling the busy flag or waiting.
+ * 
+ */
+
+#ifndef HD44780_EMU_H
+#define	HD44780_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HD44780_EMU_LINES           2
+#define HD44780_EMU_COLUMNS         16
+#define HD44780_EMU_LINE_LENGTH     40      // DDRAM bytes per line
+#define HD44780_EMU_SECOND_LINE     0x40    // DDRAM address of the 2nd line
+#define HD44780_EMU_CGRAM_SIZE      64
+#define HD44780_EMU_CGRAM_GLYPH     '*'     // captured for CGRAM characters
+
+// Operations of the controller
+typedef enum {
+    HD44780_EMU_OP_CLEAR,
+    HD44780_EMU_OP_HOME,
+    HD44780_EMU_OP_ENTRY_MODE,
+    HD44780_EMU_OP_DISPLAY_CTRL,
+    HD44780_EMU_OP_SHIFT,
+    HD44780_EMU_OP_FUNCTION_SET,
+    HD44780_EMU_OP_SET_CGRAM,
+    HD44780_EMU_OP_SET_DDRAM,
+    HD44780_EMU_OP_WRITE_DATA,
+    HD44780_EMU_OP_READ_BUSY,
+    HD44780_EMU_OP_READ_DATA,
+    HD44780_EMU_OP_COUNT
+} HD44780_EMU_OP;
+
+// Time spent per operation
+typedef struct {
+    uint32_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+} HD44780_EMU_OP_STATS;
+
+// Statistics of the controller
+typedef struct {
+    HD44780_EMU_OP_STATS ops[HD44780_EMU_OP_COUNT];
+    uint32_t busyWrites;        // written while the busy flag is set
+    uint32_t timingViolations;  // enable pulse width or cycle, setup time
+    uint32_t busViolations;     // contention or floating data pins
+    const char *pLastViolation; // description of the last violation
+    uint64_t lastViolationNs;   // emulated time of the last violation
+} HD44780_EMU_STATS;
+
+// State of the controller
+typedef struct {
+    bool is4Bit;
+    bool isTwoLines;
+    bool isDisplayOn;
+    bool isCursorOn;
+    bool isBlinkOn;
+    bool isIncrement;           // entry mode I/D
+    bool isShiftOnWrite;        // entry mode S
+    bool isCgramSelected;       // address counter refers to CGRAM
+    uint8_t addressCounter;
+    uint8_t displayShift;       // DDRAM columns shifted to the left
+    bool isBacklightOn;
+} HD44780_EMU_STATE;
+
+bool initHd44780Emu(void);
+void getHd44780EmuScreen(
+        char screen[HD44780_EMU_LINES][HD44780_EMU_COLUMNS + 1]);
+uint8_t readHd44780EmuDdram(uint8_t address);
+uint8_t readHd44780EmuCgram(uint8_t address);
+bool isHd44780EmuBusy(void);
+const HD44780_EMU_STATE *getHd44780EmuState(void);
+const HD44780_EMU_STATS *getHd44780EmuStats(void);
+void resetHd44780EmuStats(void);
+const char *getHd44780EmuOpName(HD44780_EMU_OP op);
+
+#endif	/* HD44780_EMU_H */
@@ -0,0 +1,367 @@
+/**
+ * 
+ * File:                host_clock.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module contains the emulated time of the host build. It replaces the
+ * MCC timer 1 driver as far as the tick module needs it: the registered
+ * interrupt handler is invoked for every emulated millisecond. Timer 3 is
+ * incremented every emulated microsecond, as it runs from the start-up of
+ * the MCU. The
+ * timer 6 handler is invoked every period while its interrupt is enabled.
+ * NOP() takes one instruction cycle of emulated time.
+ * 
+*/
+
+
+#include <xc.h>
+#include "host_clock.h"
+#include "../mcc_generated_files/tmr1.h"
+#include "../mcc_generated_files/tmr3.h"
+#include "../mcc_generated_files/tmr6.h"
+
+#define HOST_CLOCK_IDLE_STEP_NS 10000   // time of a poll without emulators
+#define HOST_CLOCK_TIMER6_NS    50000   // period of timer 6 set by MCC
+#define HOST_CLOCK_MS_NS        1000000
+#define HOST_CLOCK_NOP_NS       250     // instruction cycle at 16 MHz
+
+extern volatile PIE4bits_t hostPie4bits;
+
+// Local variables
+static uint64_t clockNs;
+static uint64_t timer1Periods;  // boundaries handled
+static uint64_t timer6Periods;
+static uint16_t timer3;          // microsecond counter of timer 3
+static bool isInterrupting;
+static void (*timer1Handler)(void);
+static void (*timer6Handler)(void);
+static hostClockHook pollHooks[HOST_CLOCK_MAX_HOOKS];
+static uint8_t pollHookCount;
+static bool isPolling;
+static hostClockHook delayHooks[HOST_CLOCK_MAX_HOOKS];
+static uint8_t delayHookCount;
+static uint32_t interrupts;     // handlers invoked; wakes the CPU from sleep
+
+// Local function prototypes
+static void setHostClock(uint64_t ns);
+
+
+/******************************************************************************* 
+ * Function to initialise the emulated time
+ ******************************************************************************/
+/*
+ * @brief This function resets the emulated time and removes all hooks.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void initHostClock(void) {
+    
+    clockNs = 0;
+    timer1Periods = 0;
+    timer6Periods = 0;
+    timer3 = 0;
+    pollHookCount = 0;
+    delayHookCount = 0;
+}
+
+
+/******************************************************************************* 
+ * Function to advance the emulated time
+ ******************************************************************************/
+/*
+ * @brief This function advances the emulated time and the timers. The timer
+ * 1 handler is invoked for each millisecond boundary crossed, the timer 6 
+ * handler for each period boundary while its interrupt is enabled, in the
+ * order of the boundaries and at the time of the boundary. The handlers don't
+ * run the poll hooks. Time spent by the handlers, e.g. by NOP(), delays the
+ * following boundaries, but doesn't nest further handlers.
+ * 
+ * @param duration in ns (uint64_t)
+ * 
+ * @return void
+ * 
+*/
+void advanceHostClock(uint64_t ns) {
+    
+    uint64_t targetNs = clockNs + ns;
+    bool wasPolling = isPolling;
+    uint64_t nextMs, nextPeriod;
+
+    if (isInterrupting) {
+        setHostClock(targetNs); // boundaries handled by the interrupted call
+        return;
+    }
+    isInterrupting = true;
+    isPolling = true;
+    for (;;) {
+        nextMs = (timer1Periods + 1) * HOST_CLOCK_MS_NS;
+        nextPeriod = (timer6Periods + 1) * HOST_CLOCK_TIMER6_NS;
+        if (nextMs <= targetNs && nextMs <= nextPeriod) {
+            setHostClock(nextMs);
+            timer1Periods++;
+            interrupts++;
+            if (timer1Handler)
+                timer1Handler();
+        } else if (nextPeriod <= targetNs) {
+            setHostClock(nextPeriod);
+            timer6Periods++;
+            if (timer6Handler && hostPie4bits.TMR6IE) {
+                interrupts++;
+                timer6Handler();
+            }
+        } else {
+            break;
+        }
+    }
+    setHostClock(targetNs);
+    isPolling = wasPolling;
+    isInterrupting = false;
+}
+
+
+/******************************************************************************* 
+ * Function to set the emulated time
+ ******************************************************************************/
+/*
+ * @brief This function moves the emulated time forward to the given time, 
+ * unless the handlers have already passed it, and increments timer 3.
+ * 
+ * @param time in ns (uint64_t)
+ * 
+ * @return void
+ * 
+*/
+static void setHostClock(uint64_t ns) {
+    
+    if (ns <= clockNs)
+        return;
+    timer3 += (uint16_t) (ns / 1000 - clockNs / 1000);
+    clockNs = ns;
+}
+
+
+/******************************************************************************* 
+ * Function to get the emulated time
+ ******************************************************************************/
+/*
+ * @brief This function returns the emulated time since initialisation.
+ * 
+ * @param None
+ * 
+ * @return emulated time in ns (uint64_t)
+ * 
+*/
+uint64_t getHostClockNs(void) {
+    
+    return clockNs;
+}
+
+
+/******************************************************************************* 
+ * Function to add a poll hook
+ ******************************************************************************/
+/*
+ * @brief This function registers a hook, which is invoked whenever the
+ * firmware reads the tick. The hook is expected to advance the emulated time.
+ * 
+ * @param hook (hostClockHook)
+ * 
+ * @return True if the hook has been registered
+ * 
+*/
+bool addHostPollHook(hostClockHook hook) {
+    
+    if (pollHookCount >= HOST_CLOCK_MAX_HOOKS)
+        return false;
+    pollHooks[pollHookCount++] = hook;
+
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to add a delay hook
+ ******************************************************************************/
+/*
+ * @brief This function registers a hook, which is invoked after each delay.
+ * 
+ * @param hook (hostClockHook)
+ * 
+ * @return True if the hook has been registered
+ * 
+*/
+bool addHostDelayHook(hostClockHook hook) {
+    
+    if (delayHookCount >= HOST_CLOCK_MAX_HOOKS)
+        return false;
+    delayHooks[delayHookCount++] = hook;
+
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to access PIE4 and let the emulators progress
+ ******************************************************************************/
+/*
+ * @brief This function backs the PIE4bits macro of xc.h. It runs the poll
+ * hooks, or advances the emulated time by HOST_CLOCK_IDLE_STEP_NS if there
+ * are none, so that wait loops of the firmware terminate. The hooks aren't
+ * re-entered by interrupt handlers, which read the tick themselves.
+ * 
+ * @param None
+ * 
+ * @return pointer to the PIE4 register
+ * 
+*/
+volatile PIE4bits_t *pollHostPie4bits(void) {
+    
+    if (!isPolling) {
+        isPolling = true;
+        if (pollHookCount == 0)
+            advanceHostClock(HOST_CLOCK_IDLE_STEP_NS);
+        for (uint8_t i = 0; i < pollHookCount; i++)
+            pollHooks[i]();
+        isPolling = false;
+    }
+
+    return &hostPie4bits;
+}
+
+
+/******************************************************************************* 
+ * Function to delay in emulated time
+ ******************************************************************************/
+/*
+ * @brief This function replaces __delay_us() and __delay_ms(). It advances
+ * the emulated time and lets the emulators sample the port pins.
+ * 
+ * @param delay in us (uint32_t)
+ * 
+ * @return void
+ * 
+*/
+void hostDelayUs(uint32_t us) {
+    
+    advanceHostClock((uint64_t) us * 1000);
+    for (uint8_t i = 0; i < delayHookCount; i++)
+        delayHooks[i]();
+}
+
+
+/******************************************************************************* 
+ * Function to execute a NOP in emulated time
+ ******************************************************************************/
+/*
+ * @brief This function replaces NOP(). It advances the emulated time by one
+ * instruction cycle and lets the emulators sample the port pins.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void hostNop(void) {
+    
+    advanceHostClock(HOST_CLOCK_NOP_NS);
+    for (uint8_t i = 0; i < delayHookCount; i++)
+        delayHooks[i]();
+}
+
+
+/******************************************************************************* 
+ * Function to execute SLEEP in emulated time
+ ******************************************************************************/
+/*
+ * @brief This function replaces SLEEP(). Like the CPU in IDLE mode, it waits
+ * until an interrupt handler has been invoked, while the emulators progress
+ * by the poll hooks. Timer 1 wakes it after 1 ms at the latest.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void hostSleep(void) {
+    
+    uint32_t start = interrupts;
+
+    while (interrupts == start)
+        (void) pollHostPie4bits();
+}
+
+
+/******************************************************************************* 
+ * Function to wake the CPU
+ ******************************************************************************/
+/*
+ * @brief This function is invoked by an emulator after it has invoked an 
+ * interrupt handler, so that SLEEP() returns.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void wakeHostCpu(void) {
+    
+    interrupts++;
+}
+
+
+/******************************************************************************* 
+ * Function to register the timer 1 interrupt handler
+ ******************************************************************************/
+/*
+ * @brief This function replaces the one of the MCC timer 1 driver.
+ * 
+ * @param interrupt handler
+ * 
+ * @return void
+ * 
+*/
+void TMR1_SetInterruptHandler(void (* InterruptHandler)(void)) {
+    
+    timer1Handler = InterruptHandler;
+}
+
+
+/******************************************************************************* 
+ * Function to register the timer 6 interrupt handler
+ ******************************************************************************/
+/*
+ * @brief This function replaces the one of the MCC timer 6 driver.
+ * 
+ * @param interrupt handler
+ * 
+ * @return void
+ * 
+*/
+void TMR6_SetInterruptHandler(void (* InterruptHandler)(void)) {
+    
+    timer6Handler = InterruptHandler;
+}
+
+
+/******************************************************************************* 
+ * Function to read timer 3
+ ******************************************************************************/
+/*
+ * @brief This function replaces the one of the MCC timer 3 driver.
+ * 
+ * @param None
+ * 
+ * @return microseconds since initHostClock(), wrapping around (uint16_t)
+ * 
+*/
+uint16_t TMR3_ReadTimer(void) {
+    
+    return timer3;
+}
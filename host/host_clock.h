@@ -0,0 +1,40 @@
+/*
+ * File:                host_clock.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module provides the emulated time of the host build. Peripheral
+ * emulators advance it by the duration of their bus events and the delay
+ * macros of xc.h advance it instead of spinning. Thus, timeouts elapse in
+ * emulated time, independent of the speed of the host. Timer 1 and timer 3
+ * follow the emulated time, so that the tick module runs unmodified.
+ * 
+ * Emulators register poll hooks to progress while the firmware waits, i.e.
+ * whenever it reads the tick, and delay hooks to sample port pins driven by
+ * software after each delay. Emulators which invoke interrupt handlers wake
+ * the CPU from SLEEP().
+ * 
+ */
+
+#ifndef HOST_CLOCK_H
+#define	HOST_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HOST_CLOCK_MAX_HOOKS        4
+
+// Hook of an emulator invoked by the host clock
+typedef void (*hostClockHook)(void);
+
+void initHostClock(void);
+void advanceHostClock(uint64_t ns);
+uint64_t getHostClockNs(void);
+bool addHostPollHook(hostClockHook hook);
+bool addHostDelayHook(hostClockHook hook);
+void wakeHostCpu(void);
+
+#endif	/* HOST_CLOCK_H */
@@ -0,0 +1,52 @@
+/**
+ * 
+ * File:                host_eusart1.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module contains the scripted EUSART1 receiver of the host build.
+ * 
+*/
+
+
+#include <stddef.h>
+#include "host_eusart1.h"
+#include "../mcc_generated_files/eusart1.h"
+
+// Local variables
+static const char *pInput;
+
+
+/******************************************************************************* 
+ * Function to script the received characters
+ ******************************************************************************/
+/*
+ * @brief This function sets the text to be received. The text has to remain
+ * valid until it has been read; NULL stops receiving.
+ * 
+ * @param pointer to the text (const char *)
+ * 
+ * @return void
+ * 
+*/
+void setHostEusart1Input(const char *pText) {
+    
+    pInput = pText;
+}
+
+
+/******************************************************************************* 
+ * Functions replacing the ones of the MCC EUSART1 driver
+ ******************************************************************************/
+bool EUSART1_is_rx_ready(void) {
+    
+    return pInput != NULL && *pInput != '\0';
+}
+
+uint8_t EUSART1_Read(void) {
+    
+    return EUSART1_is_rx_ready() ? (uint8_t) *pInput++ : 0;
+}
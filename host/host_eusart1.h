@@ -0,0 +1,20 @@
+/*
+ * File:                host_eusart1.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module replaces the receiver of the MCC EUSART1 driver on the host.
+ * Commands of the console are scripted as a string, which is received one
+ * character per EUSART1_Read(). Transmitted text goes to stdout by printf().
+ * 
+ */
+
+#ifndef HOST_EUSART1_H
+#define	HOST_EUSART1_H
+
+void setHostEusart1Input(const char *pText);
+
+#endif	/* HOST_EUSART1_H */
@@ -0,0 +1,340 @@
+/**
+ * 
+ * File Name:           i2c2_master_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the MCC I2C2 master driver. The unmodified driver and tick
+ * module run against the MSSP2 emulator with a register file slave. The
+ * transfers used by the I2C2 simple master are checked for their result,
+ * bus events and timing, followed by the failure paths: address and data
+ * NACK, bus collision, timeout and bus recovery. Finally, the overhead of
+ * typical transactions is benchmarked. The exit code is the number of
+ * failed checks, so that it can be run on a CI machine.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -Ihost -o i2c2_master_host_test \
+ *      host/i2c2_master_host_test.c host/ssp2_emu.c host/host_clock.c \
+ *      host/xc_registers.c mcc_generated_files/i2c2_master.c tick.c
+ *  ./i2c2_master_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../mcc_generated_files/i2c2_master.h"
+#include "../tick.h"
+#include "host_clock.h"
+#include "ssp2_emu.h"
+
+#define HOST_TEST_SLAVE_ADDR        0x77
+#define HOST_TEST_UNUSED_ADDR       0x50
+#define HOST_TEST_SSP2ADD_100KHZ    0x27    // set by I2C2_Initialize()
+#define HOST_TEST_BENCHMARK_ROUNDS  1000
+#define HOST_TEST_MAX_POLLS         1000000UL
+#define HOST_TEST_RECOVERY_PULSES   10      // 9 + SCL low before the stop
+
+// Register file slave, which is addressed like the BMP180
+typedef struct {
+    uint8_t registers[256];
+    uint8_t pointer;
+    bool pointerWritten;
+    uint8_t written;            // data bytes written in this transfer
+    uint8_t nackAfter;          // NACK data bytes beyond this count; 0 = never
+    uint8_t stops;
+} REGISTER_SLAVE;
+
+// Buffer of the read following the repeated start
+typedef struct {
+    uint8_t *pData;
+    size_t length;
+} READ_BLOCK;
+
+static REGISTER_SLAVE registerSlave;
+static SSP2_EMU_SLAVE slave = {
+    .address = HOST_TEST_SLAVE_ADDR,
+    .pContext = &registerSlave
+};
+static uint8_t failures;
+
+
+static bool startRegisterSlave(void *pContext, bool read) {
+    
+    REGISTER_SLAVE *pSlave = pContext;
+
+    if (!read) {
+        pSlave->pointerWritten = false;
+        pSlave->written = 0;
+    }
+
+    return true;
+}
+
+static bool writeRegisterSlave(void *pContext, uint8_t data) {
+    
+    REGISTER_SLAVE *pSlave = pContext;
+
+    if (pSlave->nackAfter && pSlave->written >= pSlave->nackAfter)
+        return false;
+    if (!pSlave->pointerWritten) {
+        pSlave->pointer = data;
+        pSlave->pointerWritten = true;
+    } else {
+        pSlave->registers[pSlave->pointer++] = data;
+    }
+    pSlave->written++;
+
+    return true;
+}
+
+static uint8_t readRegisterSlave(void *pContext) {
+    
+    REGISTER_SLAVE *pSlave = pContext;
+
+    return pSlave->registers[pSlave->pointer++];
+}
+
+static void stopRegisterSlave(void *pContext) {
+    
+    ((REGISTER_SLAVE *) pContext)->stops++;
+}
+
+/* Polls I2C2_Close() like the simple master, while the emulator runs */
+static i2c2_error_t waitForClose(void) {
+    
+    i2c2_error_t e;
+    uint32_t polls = 0;
+
+    // The emulator steps whenever I2C2_Close() reads the tick
+    while (I2C2_BUSY == (e = I2C2_Close())) {
+        if (++polls > HOST_TEST_MAX_POLLS)
+            break; // not bounded by the driver's timeout
+    }
+
+    return e;
+}
+
+static i2c2_operations_t restartReadHandler(void *ptr) {
+    
+    READ_BLOCK *pBlock = ptr;
+
+    I2C2_SetBuffer(pBlock->pData, pBlock->length);
+    I2C2_SetDataCompleteCallback(NULL, NULL);
+
+    return I2C2_RESTART_READ;
+}
+
+/* Writes the register pointer followed by the data */
+static i2c2_error_t writeRegisters(uint8_t address, uint8_t reg,
+        const uint8_t *pData, uint8_t length) {
+
+    uint8_t buffer[length + 1];
+
+    buffer[0] = reg;
+    memcpy(&buffer[1], pData, length);
+    while (!I2C2_Open(address))
+        ; // the bus is released by each test
+    I2C2_SetBuffer(buffer, length + 1);
+    I2C2_SetAddressNackCallback(NULL, NULL);
+    I2C2_MasterWrite();
+
+    return waitForClose();
+}
+
+/* Writes the register pointer and reads after a repeated start */
+static i2c2_error_t readRegisters(uint8_t address, uint8_t reg,
+        uint8_t *pData, uint8_t length) {
+
+    READ_BLOCK block = {pData, length};
+
+    while (!I2C2_Open(address))
+        ;
+    I2C2_SetDataCompleteCallback(restartReadHandler, &block);
+    I2C2_SetBuffer(&reg, 1);
+    I2C2_SetAddressNackCallback(NULL, NULL);
+    I2C2_MasterWrite();
+
+    return waitForClose();
+}
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+static void testWrite(void) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data[] = {0x2E, 0x34};
+    i2c2_error_t e;
+
+    resetSsp2EmuStats();
+    e = writeRegisters(HOST_TEST_SLAVE_ADDR, 0xF4, data, sizeof(data));
+    check("write", e == I2C2_NOERR
+            && registerSlave.registers[0xF4] == 0x2E
+            && registerSlave.registers[0xF5] == 0x34);
+    check("write bus events", pStats->starts == 1 && pStats->restarts == 0
+            && pStats->stops == 1 && pStats->bytes == 4
+            && pStats->isrCalls == 6);
+}
+
+static void testRead(void) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data[22];
+    i2c2_error_t e;
+
+    registerSlave.registers[0xD0] = 0x55;
+    resetSsp2EmuStats();
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, data, 1);
+    check("read", e == I2C2_NOERR && data[0] == 0x55);
+    check("read bus events", pStats->starts == 1 && pStats->restarts == 1
+            && pStats->stops == 1 && pStats->bytes == 4
+            && pStats->isrCalls == 8);
+    // start 1 + 3 x 9 (bytes written) + restart 1.5 + 8 + NACK 1 + stop 1
+    check("read bus time", pStats->busTimeNs == 395000);
+
+    for (uint8_t i = 0; i < sizeof(data); i++)
+        registerSlave.registers[0xAA + i] = i * 7;
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xAA, data, sizeof(data));
+    check("block read", e == I2C2_NOERR && data[0] == 0 && data[21] == 147);
+}
+
+static void testNack(void) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data[2] = {0};
+    i2c2_error_t e;
+
+    resetSsp2EmuStats();
+    e = readRegisters(HOST_TEST_UNUSED_ADDR, 0xD0, data, 1);
+    check("address NACK", e == I2C2_FAIL && pStats->nacks == 1
+            && pStats->stops == 1);
+
+    // The NACK of a data byte is checked before the next one is sent
+    registerSlave.nackAfter = 1; // ACK the register pointer only
+    e = writeRegisters(HOST_TEST_SLAVE_ADDR, 0xF4, data, sizeof(data));
+    registerSlave.nackAfter = 0;
+    check("data NACK", e == I2C2_FAIL);
+
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, data, 1);
+    check("read after NACK", e == I2C2_NOERR && data[0] == 0x55);
+}
+
+static void testCollision(void) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data = 0;
+    i2c2_error_t e;
+
+    resetSsp2EmuStats();
+    setSsp2EmuFault(SSP2_EMU_FAULT_SDA_STUCK, 3);
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, &data, 1);
+    check("collision", e == I2C2_COLLISION && pStats->collisions == 1
+            && pStats->collisionIsrCalls == 1);
+
+    I2C2_RecoverBus(); // done by the simple master after a collision
+    check("collision recovery",
+            pStats->recoveryPulses == HOST_TEST_RECOVERY_PULSES
+            && pStats->recoveryStops == 1);
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, &data, 1);
+    check("read after collision", e == I2C2_NOERR && data == 0x55);
+}
+
+static void testTimeout(void) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data = 0;
+    uint16_t startTick;
+    uint16_t elapsed;
+    i2c2_error_t e;
+
+    // The slave stretches the clock of the byte read beyond the timeout
+    resetSsp2EmuStats();
+    registerSlave.stops = 0;
+    slave.stretchUs = 15000;
+    startTick = getTickMs();
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, &data, 1);
+    elapsed = getTickMs() - startTick;
+    slave.stretchUs = 0;
+    check("timeout", e == I2C2_TIMEDOUT
+            && elapsed >= I2C2_DEFAULT_TIMEOUT
+            && elapsed <= I2C2_DEFAULT_TIMEOUT + 2);
+    check("timeout recovery",
+            pStats->recoveryPulses == HOST_TEST_RECOVERY_PULSES
+            && pStats->recoveryStops == 1 && registerSlave.stops == 1);
+
+    // SCL is held low, so that not even the start condition completes
+    setSsp2EmuFault(SSP2_EMU_FAULT_SCL_STUCK, 0);
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, &data, 1);
+    setSsp2EmuFault(SSP2_EMU_FAULT_NONE, 0);
+    check("stuck SCL", e == I2C2_TIMEDOUT);
+
+    e = readRegisters(HOST_TEST_SLAVE_ADDR, 0xD0, &data, 1);
+    check("read after timeout", e == I2C2_NOERR && data == 0x55);
+}
+
+/* Reports the overhead of register reads of the given length */
+static void benchmarkRead(uint8_t length) {
+    
+    const SSP2_EMU_STATS *pStats = getSsp2EmuStats();
+    uint8_t data[22];
+    uint64_t startNs = getHostClockNs();
+    uint32_t errors = 0;
+
+    resetSsp2EmuStats();
+    for (uint16_t i = 0; i < HOST_TEST_BENCHMARK_ROUNDS; i++) {
+        if (readRegisters(HOST_TEST_SLAVE_ADDR, 0xAA, data, length)
+                != I2C2_NOERR)
+            errors++;
+    }
+
+    printf("HOST BENCH - read %2u bytes: %2lu ISRs, bus %4lu us, "
+            "total %4lu us, %3lu ns host CPU per ISR, %lu errors\n",
+            length,
+            (unsigned long) (pStats->isrCalls / HOST_TEST_BENCHMARK_ROUNDS),
+            (unsigned long) (pStats->busTimeNs / 1000
+                / HOST_TEST_BENCHMARK_ROUNDS),
+            (unsigned long) ((getHostClockNs() - startNs) / 1000
+                / HOST_TEST_BENCHMARK_ROUNDS),
+            (unsigned long) (pStats->isrHostNs / pStats->isrCalls),
+            (unsigned long) errors);
+}
+
+int main(void) {
+    
+    slave.start = startRegisterSlave;
+    slave.write = writeRegisterSlave;
+    slave.read = readRegisterSlave;
+    slave.stop = stopRegisterSlave;
+
+    initHostClock();
+    initSsp2Emu();
+    (void) attachSsp2Slave(&slave);
+    initTick();
+    I2C2_Initialize();
+    check("baud rate", SSP2ADD == HOST_TEST_SSP2ADD_100KHZ);
+
+    testWrite();
+    testRead();
+    testNack();
+    testCollision();
+    testTimeout();
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0);
+
+    benchmarkRead(1);
+    benchmarkRead(2);
+    benchmarkRead(3);
+    benchmarkRead(22);
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
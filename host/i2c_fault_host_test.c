@@ -0,0 +1,342 @@
+/**
+ * 
+ * File Name:           i2c_fault_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the bounded I2C2 operations. The unmodified I2C2 simple
+ * master, transfer queue and BMP180 driver run against the MSSP2 emulator,
+ * into which missing acknowledges, bus collisions by a stuck SDA line and a
+ * stuck SCL line are injected. Each failure path is checked for the result,
+ * the number of retries up to I2C_RETRY_LIMIT, the back-off of 1, 2 and 4 ms
+ * between the attempts, the SCL pulses and stop conditions clocked by
+ * I2C2_RecoverBus() and the time it stalls the caller. The exit code is the
+ * number of failed checks.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o i2c_fault_host_test \
+ *      host/i2c_fault_host_test.c host/bmp180_sim.c host/ssp2_emu.c \
+ *      host/host_clock.c host/xc_registers.c bmp180.c i2c_queue.c \
+ *      i2c_profile.c tick.c mcc_generated_files/i2c1_master.c \
+ *      mcc_generated_files/i2c2_master.c \
+ *      mcc_generated_files/drivers/i2c1_simple_master.c \
+ *      mcc_generated_files/drivers/i2c_simple_master.c
+ *  ./i2c_fault_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../bmp180.h"
+#include "../i2c_queue.h"
+#include "../tick.h"
+#include "../mcc_generated_files/drivers/i2c_simple_master.h"
+#include "host_clock.h"
+#include "ssp2_emu.h"
+#include "bmp180_sim.h"
+
+#define HOST_TEST_FLAKY_ADDR        0x50
+#define HOST_TEST_FLAKY_CHIP_ID     0x55
+#define HOST_TEST_ALWAYS            0xFF    // faults of every attempt
+#define HOST_TEST_ATTEMPTS          (I2C_RETRY_LIMIT + 1)
+#define HOST_TEST_RECOVERY_PULSES   10      // 9 + SCL low before the stop
+#define HOST_TEST_MAX_STALL_MS      100
+#define HOST_TEST_ATTEMPT_NS        200000  // address byte at 100 kHz
+#define HOST_TEST_MS_NS             1000000
+
+// Slave, which doesn't acknowledge its address for a number of attempts
+typedef struct {
+    uint8_t nacks;              // attempts to be NACKed, HOST_TEST_ALWAYS
+    uint8_t attempts;           // write transfers started by the master
+    uint64_t attemptNs[HOST_TEST_ATTEMPTS];
+    uint8_t pointer;
+} FLAKY_SLAVE;
+
+// Error statistics of the simple master during a call
+typedef struct {
+    i2c2_error_t error;
+    uint16_t retries;
+    uint16_t timeouts;
+    uint16_t collisions;
+    uint16_t nacks;
+    uint16_t recoveries;
+    uint32_t recoveryPulses;
+    uint32_t recoveryStops;
+    uint16_t stallMs;
+    uint8_t data;
+} FAULT_RESULT;
+
+static FLAKY_SLAVE flakySlave;
+static SSP2_EMU_SLAVE slave = {
+    .address = HOST_TEST_FLAKY_ADDR,
+    .pContext = &flakySlave
+};
+static uint16_t maxStallMs;
+static uint8_t failures;
+
+
+static bool startFlakySlave(void *pContext, bool read) {
+    
+    FLAKY_SLAVE *pSlave = pContext;
+
+    if (read)
+        return true;
+    if (pSlave->attempts < HOST_TEST_ATTEMPTS)
+        pSlave->attemptNs[pSlave->attempts] = getHostClockNs();
+    pSlave->attempts++;
+    if (pSlave->nacks == 0)
+        return true;
+    if (pSlave->nacks != HOST_TEST_ALWAYS)
+        pSlave->nacks--;
+
+    return false;
+}
+
+static bool writeFlakySlave(void *pContext, uint8_t data) {
+    
+    ((FLAKY_SLAVE *) pContext)->pointer = data;
+
+    return true;
+}
+
+static uint8_t readFlakySlave(void *pContext) {
+    
+    FLAKY_SLAVE *pSlave = pContext;
+
+    return (pSlave->pointer == BMP180_REG_CHIP_ID)
+            ? HOST_TEST_FLAKY_CHIP_ID : 0;
+}
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+/* Reads the chip-id by the simple master and collects the statistics */
+static void readChipId(uint8_t address, FAULT_RESULT *pResult) {
+    
+    i2c_error_stats_t before = *i2c_getErrorStats();
+    const i2c_error_stats_t *pAfter = i2c_getErrorStats();
+    const SSP2_EMU_STATS *pBus = getSsp2EmuStats();
+    uint16_t startTick;
+
+    resetSsp2EmuStats();
+    startTick = getTickMs();
+    pResult->data = i2c_read1ByteRegister(address, BMP180_REG_CHIP_ID);
+    pResult->stallMs = getTickMs() - startTick;
+    pResult->error = i2c_getLastError();
+    pResult->retries = pAfter->retries - before.retries;
+    pResult->timeouts = pAfter->timeouts - before.timeouts;
+    pResult->collisions = pAfter->collisions - before.collisions;
+    pResult->nacks = pAfter->nacks - before.nacks;
+    pResult->recoveries = pAfter->recoveries - before.recoveries;
+    pResult->recoveryPulses = pBus->recoveryPulses;
+    pResult->recoveryStops = pBus->recoveryStops;
+    if (pResult->stallMs > maxStallMs)
+        maxStallMs = pResult->stallMs;
+}
+
+static void testNack(void) {
+    
+    FAULT_RESULT result;
+    uint64_t gapNs, backOffNs;
+    bool backOff = true;
+
+    // A single NACK is retried after 1 ms
+    flakySlave = (FLAKY_SLAVE) {.nacks = 1};
+    readChipId(HOST_TEST_FLAKY_ADDR, &result);
+    check("NACK retried", result.error == I2C2_NOERR
+            && result.data == HOST_TEST_FLAKY_CHIP_ID
+            && result.retries == 1 && result.nacks == 1
+            && result.recoveries == 0 && flakySlave.attempts == 2);
+
+    /* A persistent NACK fails after I2C_RETRY_LIMIT retries. The time between
+     * two attempts is the back-off plus the attempt itself, which takes less
+     * than HOST_TEST_ATTEMPT_NS on the bus. */
+    flakySlave = (FLAKY_SLAVE) {.nacks = HOST_TEST_ALWAYS};
+    readChipId(HOST_TEST_FLAKY_ADDR, &result);
+    check("NACK persistent", result.error == I2C2_FAIL
+            && result.retries == I2C_RETRY_LIMIT
+            && result.nacks == HOST_TEST_ATTEMPTS
+            && result.recoveries == 0
+            && flakySlave.attempts == HOST_TEST_ATTEMPTS);
+
+    printf("HOST BENCH - NACK back-off:");
+    for (uint8_t i = 0; i < I2C_RETRY_LIMIT; i++) {
+        gapNs = flakySlave.attemptNs[i + 1] - flakySlave.attemptNs[i];
+        // The back-off starts at 1 ms and doubles up to I2C_RETRY_BACKOFF_MAX
+        backOffNs = (uint64_t) (1 << i) * HOST_TEST_MS_NS;
+        if (gapNs < backOffNs || gapNs > backOffNs + HOST_TEST_ATTEMPT_NS)
+            backOff = false;
+        printf(" %lu us", (unsigned long) (gapNs / 1000));
+    }
+    printf(" between the attempts\n");
+    check("NACK back-off", backOff);
+}
+
+static void testCollision(void) {
+    
+    FAULT_RESULT result;
+
+    // SDA is released by the recovery after the first collision
+    setSsp2EmuFault(SSP2_EMU_FAULT_SDA_STUCK, 3);
+    readChipId(BMP180_I2C_ADDR, &result);
+    check("collision retried", result.error == I2C2_NOERR
+            && result.data == BMP180_REG_CHIP_ID_VALUE
+            && result.retries == 1 && result.collisions == 1
+            && result.recoveries == 1);
+    check("collision recovery",
+            result.recoveryPulses == HOST_TEST_RECOVERY_PULSES
+            && result.recoveryStops == 1);
+
+    // SDA needs more than one recovery sequence to be released
+    setSsp2EmuFault(SSP2_EMU_FAULT_SDA_STUCK, HOST_TEST_RECOVERY_PULSES + 2);
+    readChipId(BMP180_I2C_ADDR, &result);
+    check("stuck SDA released", result.error == I2C2_NOERR
+            && result.data == BMP180_REG_CHIP_ID_VALUE
+            && result.retries == 2 && result.collisions == 2
+            && result.recoveries == 2
+            && result.recoveryPulses == 2 * HOST_TEST_RECOVERY_PULSES
+            && result.recoveryStops == 1);
+}
+
+static void testStuckSda(void) {
+    
+    const SSP2_EMU_STATS *pBus = getSsp2EmuStats();
+    FAULT_RESULT result;
+
+    // Every attempt collides and every recovery fails to release SDA
+    setSsp2EmuFault(SSP2_EMU_FAULT_SDA_STUCK, 0);
+    readChipId(BMP180_I2C_ADDR, &result);
+    check("stuck SDA", result.error == I2C2_COLLISION
+            && result.retries == I2C_RETRY_LIMIT
+            && result.collisions == HOST_TEST_ATTEMPTS
+            && result.recoveries == HOST_TEST_ATTEMPTS
+            && result.recoveryPulses
+                == HOST_TEST_ATTEMPTS * HOST_TEST_RECOVERY_PULSES
+            && result.recoveryStops == 0);
+    check("stuck SDA stall", result.stallMs >= 7
+            && result.stallMs <= HOST_TEST_MAX_STALL_MS);
+
+    /* The recovery can't generate a stop condition until SDA is released.
+     * Releasing SDA while SCL is high is a stop condition itself. */
+    resetSsp2EmuStats();
+    I2C2_RecoverBus();
+    check("recovery of stuck SDA",
+            pBus->recoveryPulses == HOST_TEST_RECOVERY_PULSES
+            && pBus->recoveryStops == 0);
+    setSsp2EmuFault(SSP2_EMU_FAULT_NONE, 0);
+    resetSsp2EmuStats();
+    I2C2_RecoverBus();
+    check("recovery of released SDA",
+            pBus->recoveryPulses == HOST_TEST_RECOVERY_PULSES
+            && pBus->recoveryStops == 2);
+    readChipId(BMP180_I2C_ADDR, &result);
+    check("read after stuck SDA", result.error == I2C2_NOERR
+            && result.data == BMP180_REG_CHIP_ID_VALUE
+            && result.retries == 0);
+}
+
+static void testStuckScl(void) {
+    
+    FAULT_RESULT result;
+
+    // Every attempt times out and is recovered by the I2C2 driver
+    setSsp2EmuFault(SSP2_EMU_FAULT_SCL_STUCK, 0);
+    readChipId(BMP180_I2C_ADDR, &result);
+    setSsp2EmuFault(SSP2_EMU_FAULT_NONE, 0);
+    check("stuck SCL", result.error == I2C2_TIMEDOUT
+            && result.retries == I2C_RETRY_LIMIT
+            && result.timeouts == HOST_TEST_ATTEMPTS
+            && result.recoveries == HOST_TEST_ATTEMPTS);
+    check("stuck SCL stall",
+            result.stallMs >= HOST_TEST_ATTEMPTS * I2C2_DEFAULT_TIMEOUT + 7
+            && result.stallMs <= HOST_TEST_MAX_STALL_MS);
+    readChipId(BMP180_I2C_ADDR, &result);
+    check("read after stuck SCL", result.error == I2C2_NOERR
+            && result.data == BMP180_REG_CHIP_ID_VALUE);
+}
+
+/* Stalls a queued transfer, which has to be failed by the timeout */
+static void testQueue(void) {
+    
+    static I2C_TRANSFER transfer;
+    static uint8_t chipIdReg = BMP180_REG_CHIP_ID;
+    static uint8_t chipId;
+    uint16_t startTick;
+    uint16_t stallMs;
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.type = I2C_TRANSFER_WRITE_READ;
+    transfer.address = BMP180_I2C_ADDR;
+    transfer.pWriteData = &chipIdReg;
+    transfer.writeLength = 1;
+    transfer.pReadData = &chipId;
+    transfer.readLength = 1;
+
+    initI2cQueue();
+    setSsp2EmuFault(SSP2_EMU_FAULT_SCL_STUCK, 0);
+    startTick = getTickMs();
+    (void) queueI2cTransfer(&transfer);
+    while ((transfer.status == I2C_TRANSFER_QUEUED
+            || transfer.status == I2C_TRANSFER_ACTIVE)
+            && !hasTickElapsed(startTick, HOST_TEST_MAX_STALL_MS))
+        serviceI2cQueue();
+    stallMs = getTickMs() - startTick;
+    setSsp2EmuFault(SSP2_EMU_FAULT_NONE, 0);
+    check("stuck SCL queued", transfer.status == I2C_TRANSFER_FAILED
+            && stallMs >= I2C2_DEFAULT_TIMEOUT
+            && stallMs <= I2C2_DEFAULT_TIMEOUT + 2);
+}
+
+/* Checks that the BMP180 API reports a bus which doesn't recover */
+static void testSensor(void) {
+    
+    static BMP180_PARAM sensor;
+
+    memset(&sensor, 0, sizeof(sensor));
+    setBmp180SimFault(BMP180_SIM_FAULT_ABSENT);
+    check("sensor absent", BMP180_Init(&sensor) == 2);
+    setBmp180SimFault(BMP180_SIM_FAULT_NONE);
+    check("sensor present", BMP180_Init(&sensor) == 0);
+    setSsp2EmuFault(SSP2_EMU_FAULT_SCL_STUCK, 0);
+    check("sensor stuck SCL", BMP180_StartPressureConversion(&sensor) == 2);
+    setSsp2EmuFault(SSP2_EMU_FAULT_NONE, 0);
+    check("sensor after stuck SCL",
+            BMP180_ReadRawPressure(&sensor) != BMP180_INVALID_DATA
+            && sensor.busStats.errors == 1);
+}
+
+int main(void) {
+    
+    slave.start = startFlakySlave;
+    slave.write = writeFlakySlave;
+    slave.read = readFlakySlave;
+
+    initHostClock();
+    initSsp2Emu();
+    check("attach", initBmp180Sim() && attachSsp2Slave(&slave));
+    initTick();
+    I2C2_Initialize();
+
+    testNack();
+    testCollision();
+    testStuckSda();
+    testStuckScl();
+    testQueue();
+    testSensor();
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0);
+
+    printf("HOST BENCH - max. stall of a simple master call: %u ms\n",
+            maxStallMs);
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
@@ -0,0 +1,300 @@
+/**
+ * 
+ * File Name:           i2c_queue_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the I2C2 transfer queue. The queue and the interrupt driven
+ * MCC I2C2 master run against the MSSP2 emulator with a register file slave,
+ * while the main loop of the test only services the queue. A single transfer,
+ * a burst filling the queue, a full queue, a missing acknowledge and a
+ * timeout are checked for the status of the transfers, the order of their
+ * completion and the depth, wait time and latency in the statistics of the
+ * queue. The exit code is the number of failed checks, so that it can be run
+ * on a CI machine.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o i2c_queue_host_test \
+ *      host/i2c_queue_host_test.c host/ssp2_emu.c host/host_clock.c \
+ *      host/xc_registers.c i2c_queue.c i2c_profile.c tick.c \
+ *      mcc_generated_files/i2c2_master.c
+ *  ./i2c_queue_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../i2c_queue.h"
+#include "../tick.h"
+#include "host_clock.h"
+#include "ssp2_emu.h"
+
+#define HOST_TEST_SLAVE_ADDR        0x77
+#define HOST_TEST_UNUSED_ADDR       0x50
+#define HOST_TEST_READ_LENGTH       6
+#define HOST_TEST_BURST             4
+#define HOST_TEST_MAX_POLLS         1000000UL
+#define HOST_TEST_MS_NS             1000000
+
+// Register file slave, which is addressed like the BMP180
+typedef struct {
+    uint8_t registers[256];
+    uint8_t pointer;
+    bool pointerWritten;
+} REGISTER_SLAVE;
+
+// Transfer of the test with its buffers
+typedef struct {
+    I2C_TRANSFER transfer;
+    uint8_t reg;
+    uint8_t data[HOST_TEST_READ_LENGTH];
+} TEST_TRANSFER;
+
+static REGISTER_SLAVE registerSlave;
+static SSP2_EMU_SLAVE slave = {
+    .address = HOST_TEST_SLAVE_ADDR,
+    .pContext = &registerSlave
+};
+static TEST_TRANSFER transfers[I2C_QUEUE_DEPTH + 1];
+static TEST_TRANSFER *completionOrder[I2C_QUEUE_DEPTH + 1];
+static uint8_t completions;
+static uint8_t failures;
+
+
+static bool startRegisterSlave(void *pContext, bool read) {
+    
+    if (!read)
+        ((REGISTER_SLAVE *) pContext)->pointerWritten = false;
+
+    return true;
+}
+
+static bool writeRegisterSlave(void *pContext, uint8_t data) {
+    
+    REGISTER_SLAVE *pSlave = pContext;
+
+    if (!pSlave->pointerWritten) {
+        pSlave->pointer = data;
+        pSlave->pointerWritten = true;
+    } else {
+        pSlave->registers[pSlave->pointer++] = data;
+    }
+
+    return true;
+}
+
+static uint8_t readRegisterSlave(void *pContext) {
+    
+    REGISTER_SLAVE *pSlave = pContext;
+
+    return pSlave->registers[pSlave->pointer++];
+}
+
+/* Completion callback; runs in the emulated MSSP2 interrupt */
+static void recordCompletion(I2C_TRANSFER *pTransfer) {
+    
+    if (completions < I2C_QUEUE_DEPTH + 1)
+        completionOrder[completions] = pTransfer->pContext;
+    completions++;
+}
+
+/* Prepares a write-then-read of the registers starting at reg */
+static I2C_TRANSFER *prepareRead(uint8_t index, uint8_t address,
+        uint8_t reg) {
+    
+    TEST_TRANSFER *pTest = &transfers[index];
+
+    memset(pTest, 0, sizeof(*pTest));
+    pTest->reg = reg;
+    pTest->transfer.type = I2C_TRANSFER_WRITE_READ;
+    pTest->transfer.address = address;
+    pTest->transfer.pWriteData = &pTest->reg;
+    pTest->transfer.writeLength = 1;
+    pTest->transfer.pReadData = pTest->data;
+    pTest->transfer.readLength = HOST_TEST_READ_LENGTH;
+    pTest->transfer.callback = recordCompletion;
+    pTest->transfer.pContext = pTest;
+
+    return &pTest->transfer;
+}
+
+/* Runs the main loop of the test until the given number of completions */
+static bool serviceUntil(uint8_t expected) {
+    
+    uint32_t polls = 0;
+
+    // The emulator steps whenever the queue checks the I2C2 timeout
+    while (completions < expected) {
+        serviceI2cQueue();
+        if (++polls > HOST_TEST_MAX_POLLS)
+            return false;
+    }
+
+    return true;
+}
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+static void resetQueue(void) {
+    
+    initI2cQueue();
+    completions = 0;
+    memset(completionOrder, 0, sizeof(completionOrder));
+}
+
+static void testSingle(void) {
+    
+    const I2C_QUEUE_STATS *pStats = getI2cQueueStats();
+    I2C_TRANSFER *pTransfer;
+
+    resetQueue();
+    pTransfer = prepareRead(0, HOST_TEST_SLAVE_ADDR, 0xAA);
+    check("queue single", queueI2cTransfer(pTransfer) == 0
+            && pTransfer->status == I2C_TRANSFER_ACTIVE
+            && getI2cQueueDepth() == 0);
+    check("single completes", serviceUntil(1)
+            && pTransfer->status == I2C_TRANSFER_DONE
+            && transfers[0].data[0] == 0xAA
+            && transfers[0].data[HOST_TEST_READ_LENGTH - 1] == 0xAF);
+    check("single stats", pStats->transfers == 1 && pStats->failures == 0
+            && pStats->rejected == 0 && pStats->maxDepth == 1
+            && pStats->maxWaitTime == 0 && pStats->totalWaitTime == 0
+            && pStats->maxLatency <= 1);
+}
+
+static void testBurst(void) {
+    
+    const I2C_QUEUE_STATS *pStats = getI2cQueueStats();
+    uint64_t startNs;
+    uint16_t burstMs;
+    bool ordered = true;
+    bool done = true;
+
+    // The first transfer starts right away, the others wait for the bus
+    resetQueue();
+    startNs = getHostClockNs();
+    for (uint8_t i = 0; i < HOST_TEST_BURST; i++)
+        (void) queueI2cTransfer(prepareRead(i, HOST_TEST_SLAVE_ADDR,
+                0x10 * i));
+    check("burst depth", getI2cQueueDepth() == HOST_TEST_BURST - 1
+            && pStats->maxDepth == HOST_TEST_BURST - 1);
+    check("burst completes", serviceUntil(HOST_TEST_BURST));
+    burstMs = (getHostClockNs() - startNs + HOST_TEST_MS_NS - 1)
+            / HOST_TEST_MS_NS;
+
+    for (uint8_t i = 0; i < HOST_TEST_BURST; i++) {
+        ordered = ordered && completionOrder[i] == &transfers[i];
+        done = done && transfers[i].transfer.status == I2C_TRANSFER_DONE
+                && transfers[i].data[0] == 0x10 * i;
+    }
+    check("burst order", ordered && done);
+    check("burst counters", pStats->transfers == HOST_TEST_BURST
+            && pStats->failures == 0 && getI2cQueueDepth() == 0);
+    // The last transfer waits for the others, thus the longest wait
+    check("burst wait time", pStats->maxWaitTime >= 1
+            && pStats->maxWaitTime < pStats->maxLatency
+            && pStats->totalWaitTime < pStats->totalLatency);
+    check("burst latency", pStats->maxLatency <= burstMs
+            && pStats->maxLatency + 1 >= burstMs);
+    printf("HOST BENCH - burst of %u reads: %u ms, wait max %u mean %lu ms,"
+            " latency max %u mean %lu ms\n", HOST_TEST_BURST, burstMs,
+            pStats->maxWaitTime,
+            (unsigned long) (pStats->totalWaitTime / pStats->transfers),
+            pStats->maxLatency,
+            (unsigned long) (pStats->totalLatency / pStats->transfers));
+}
+
+static void testFull(void) {
+    
+    const I2C_QUEUE_STATS *pStats = getI2cQueueStats();
+    uint8_t accepted = 0;
+
+    // One transfer is active, I2C_QUEUE_DEPTH - 1 can wait
+    resetQueue();
+    for (uint8_t i = 0; i < I2C_QUEUE_DEPTH + 1; i++) {
+        if (queueI2cTransfer(prepareRead(i, HOST_TEST_SLAVE_ADDR, i)) == 0)
+            accepted++;
+    }
+    check("full queue", accepted == I2C_QUEUE_DEPTH
+            && pStats->rejected == 1
+            && pStats->maxDepth == I2C_QUEUE_DEPTH - 1
+            && transfers[I2C_QUEUE_DEPTH].transfer.status
+                == I2C_TRANSFER_IDLE);
+    check("full queue drains", serviceUntil(I2C_QUEUE_DEPTH)
+            && pStats->transfers == I2C_QUEUE_DEPTH
+            && pStats->failures == 0);
+}
+
+static void testNack(void) {
+    
+    const I2C_QUEUE_STATS *pStats = getI2cQueueStats();
+
+    // The transfer following the failed one has to go ahead
+    resetQueue();
+    (void) queueI2cTransfer(prepareRead(0, HOST_TEST_UNUSED_ADDR, 0xD0));
+    (void) queueI2cTransfer(prepareRead(1, HOST_TEST_SLAVE_ADDR, 0xD0));
+    check("NACK completes", serviceUntil(2));
+    check("NACK status",
+            transfers[0].transfer.status == I2C_TRANSFER_FAILED
+            && transfers[1].transfer.status == I2C_TRANSFER_DONE
+            && transfers[1].data[0] == 0xD0);
+    check("NACK stats", pStats->transfers == 2 && pStats->failures == 1);
+}
+
+static void testTimeout(void) {
+    
+    const I2C_QUEUE_STATS *pStats = getI2cQueueStats();
+    const SSP2_EMU_STATS *pBus = getSsp2EmuStats();
+
+    // The slave stretches the clock beyond the timeout of the I2C2 master
+    resetQueue();
+    resetSsp2EmuStats();
+    slave.stretchUs = 15000;
+    (void) queueI2cTransfer(prepareRead(0, HOST_TEST_SLAVE_ADDR, 0xD0));
+    (void) queueI2cTransfer(prepareRead(1, HOST_TEST_SLAVE_ADDR, 0xD0));
+    check("timeout aborts", serviceUntil(1)
+            && transfers[0].transfer.status == I2C_TRANSFER_FAILED
+            && pBus->recoveryStops == 1);
+    slave.stretchUs = 0;
+    check("timeout next", serviceUntil(2)
+            && transfers[1].transfer.status == I2C_TRANSFER_DONE
+            && transfers[1].data[0] == 0xD0);
+    check("timeout stats", pStats->transfers == 2 && pStats->failures == 1
+            && pStats->maxLatency >= I2C2_DEFAULT_TIMEOUT);
+}
+
+int main(void) {
+    
+    slave.start = startRegisterSlave;
+    slave.write = writeRegisterSlave;
+    slave.read = readRegisterSlave;
+    for (uint16_t i = 0; i < sizeof(registerSlave.registers); i++)
+        registerSlave.registers[i] = i;
+
+    initHostClock();
+    initSsp2Emu();
+    (void) attachSsp2Slave(&slave);
+    initTick();
+    I2C2_Initialize();
+
+    testSingle();
+    testBurst();
+    testFull();
+    testNack();
+    testTimeout();
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0);
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
@@ -0,0 +1,298 @@
+/**
+ * 
+ * File Name:           lcd_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Display:             LCD 16x2 - Hitachi HD44780
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the LCD driver against the HD44780 emulator. The unmodified
+ * driver initialises the display, prints and shifts, and the screen captured
+ * by the emulator is compared with the expected one. Random frames drawn into
+ * the shadow framebuffer, mixed with direct writes, check that the mirror of
+ * the driver follows the display. The emulator has to detect injected timing
+ * violations, while the driver must not cause any. Finally, the throughput
+ * is benchmarked and the time per operation of the display is reported. The
+ * exit code is the number of failed checks, so that it can be run on a CI
+ * machine.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -Ihost -o lcd_host_test host/lcd_host_test.c \
+ *      host/hd44780_emu.c host/host_clock.c host/xc_registers.c lcd.c
+ *  ./lcd_host_test
+ * 
+ * Add -DLCD_USE_QUEUE=0 to benchmark the direct transfers instead of the
+ * command queue.
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <xc.h>
+#include "../lcd.h"
+#include "host_clock.h"
+#include "hd44780_emu.h"
+
+#define HOST_TEST_RANDOM_FRAMES         500
+#define HOST_TEST_RANDOM_SEED           4711
+#define HOST_TEST_BENCHMARK_LINES       100
+#define HOST_TEST_PIN_EN                0x08    // RD3
+#define HOST_TEST_PIN_RS                0x02    // RD1
+#define HOST_TEST_CLEAR_US              2000    // > execution time
+
+typedef char SCREEN[HD44780_EMU_LINES][HD44780_EMU_COLUMNS + 1];
+
+static uint32_t randomState = HOST_TEST_RANDOM_SEED;
+static uint8_t failures;
+
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+/* Linear congruential generator of the C standard, for reproducible runs */
+static uint16_t getRandom(uint16_t range) {
+    
+    randomState = randomState * 1103515245UL + 12345;
+
+    return (uint16_t) ((randomState >> 16) % range);
+}
+
+/* Waits until the queued bytes have been sent, incl. a pending clear */
+static void waitForLcd(void) {
+    
+    while (!LCD_IsQueueEmpty())
+        __delay_us(1);
+    __delay_us(HOST_TEST_CLEAR_US);
+}
+
+static uint32_t getViolations(void) {
+    
+    const HD44780_EMU_STATS *pStats = getHd44780EmuStats();
+
+    return pStats->busyWrites + pStats->timingViolations
+            + pStats->busViolations;
+}
+
+static bool isScreen(const char *pFirst, const char *pSecond) {
+    
+    SCREEN screen;
+
+    getHd44780EmuScreen(screen);
+    if (strcmp(screen[0], pFirst) == 0 && strcmp(screen[1], pSecond) == 0)
+        return true;
+    printf("HOST TEST - screen: \"%s\" \"%s\"\n", screen[0], screen[1]);
+
+    return false;
+}
+
+/* Writes a byte by the pins, bypassing the driver */
+static void writePins(uint8_t value, bool isData, uint32_t highUs) {
+    
+    uint8_t pins = (uint8_t) (LATD & 0x01) | (isData ? HOST_TEST_PIN_RS : 0);
+
+    for (uint8_t shift = 8; shift > 0; shift -= 4) {
+        LATD = pins | (uint8_t) (((value >> (shift - 4)) & 0x0F) << 4);
+        LATD |= HOST_TEST_PIN_EN;
+        if (highUs > 0)
+            __delay_us(highUs);
+        LATD &= ~HOST_TEST_PIN_EN;
+        __delay_us(1);
+    }
+}
+
+static void testInit(void) {
+    
+    const HD44780_EMU_STATE *pState = getHd44780EmuState();
+
+    LCD_Init();
+    waitForLcd();
+    check("init 4-bit two lines", pState->is4Bit && pState->isTwoLines);
+    check("init display control", pState->isDisplayOn
+            && !pState->isCursorOn && !pState->isBlinkOn);
+    check("init entry mode", pState->isIncrement && !pState->isShiftOnWrite
+            && pState->addressCounter == 0 && pState->displayShift == 0);
+    check("init screen", isScreen("                ", "                "));
+    check("init timing", getViolations() == 0);
+}
+
+static void testPrint(void) {
+    
+    LCD_SetCursor(LCD_FIRST_LINE, 0);
+    LCD_PrintString("Hello");
+    LCD_SetCursor(LCD_SECOND_LINE, 3);
+    LCD_PrintInteger(-42, INT_BASE_DECIMAL);
+    LCD_ShiftCursorRight();
+    LCD_PrintInteger(255, INT_BASE_HEX);
+    waitForLcd();
+    check("print", isScreen("Hello           ", "   -42 ff       "));
+
+    LCD_ShiftDisplayLeft();
+    LCD_ShiftDisplayLeft();
+    waitForLcd();
+    check("shift left", isScreen("llo             ", " -42 ff         ")
+            && getHd44780EmuState()->displayShift == 2);
+    LCD_ShiftDisplayRight();
+    LCD_ShiftDisplayRight();
+    LCD_ShiftDisplayRight();
+    waitForLcd();
+    check("shift right", isScreen(" Hello          ", "    -42 ff      "));
+
+    LCD_Clear();
+    waitForLcd();
+    check("clear", isScreen("                ", "                ")
+            && getHd44780EmuState()->displayShift == 0);
+    check("print timing", getViolations() == 0);
+}
+
+/* Draws random text into the framebuffer and the expected screen */
+static void drawRandomFrame(SCREEN expected) {
+    
+    char text[HD44780_EMU_COLUMNS + 1];
+    uint8_t line, column, length;
+
+    LCD_FrameClear();
+    memset(expected, ' ', sizeof(SCREEN));
+    for (uint8_t i = getRandom(4); i > 0; i--) {
+        line = (uint8_t) getRandom(HD44780_EMU_LINES);
+        column = (uint8_t) getRandom(HD44780_EMU_COLUMNS);
+        length = (uint8_t) getRandom(HD44780_EMU_COLUMNS) + 1;
+        for (uint8_t j = 0; j < length; j++) {
+            text[j] = (char) ('!' + getRandom('~' - '!'));
+            if (column + j < HD44780_EMU_COLUMNS)
+                expected[line][column + j] = text[j];
+        }
+        text[length] = '\0';
+        LCD_FrameSetCursor(line ? LCD_SECOND_LINE : LCD_FIRST_LINE, column);
+        LCD_FramePrintString(text);
+    }
+    expected[0][HD44780_EMU_COLUMNS] = '\0';
+    expected[1][HD44780_EMU_COLUMNS] = '\0';
+}
+
+static void testRandomFrames(void) {
+    
+    SCREEN expected;
+    uint16_t mismatches = 0;
+
+    for (uint16_t i = 0; i < HOST_TEST_RANDOM_FRAMES; i++) {
+        // Direct writes in between, which the mirror has to follow
+        switch (getRandom(6)) {
+            case 0:
+                LCD_ShiftDisplayLeft();
+                break;
+            case 1:
+                LCD_ShiftDisplayRight();
+                break;
+            case 2:
+                LCD_SetCursor(getRandom(2) ? LCD_SECOND_LINE : LCD_FIRST_LINE,
+                        (uint8_t) getRandom(HD44780_EMU_LINE_LENGTH));
+                LCD_PrintString("#*#");
+                break;
+            case 3:
+                LCD_ShiftCursorLeft();
+                break;
+            default:
+                break;
+        }
+        drawRandomFrame(expected);
+        LCD_Flush();
+        waitForLcd();
+        if (!isScreen(expected[0], expected[1]))
+            mismatches++;
+    }
+    check("random frames", mismatches == 0);
+    check("random frames timing", getViolations() == 0);
+}
+
+static void testViolations(void) {
+    
+    const HD44780_EMU_STATS *pStats = getHd44780EmuStats();
+    uint32_t busyWrites = pStats->busyWrites;
+    uint32_t timingViolations = pStats->timingViolations;
+    uint32_t busViolations = pStats->busViolations;
+
+    // Write data right after clear display, which is still executed
+    LCD_Clear();
+    while (!LCD_IsQueueEmpty())
+        __delay_us(1);
+    while (!isHd44780EmuBusy())
+        __delay_us(1);
+    writePins('X', true, 1);
+    check("violation busy", pStats->busyWrites == busyWrites + 1);
+
+    // Enable pulses shorter than the minimum width
+    __delay_us(HOST_TEST_CLEAR_US);
+    writePins('Y', true, 0);
+    check("violation pulse width",
+            pStats->timingViolations >= timingViolations + 2);
+
+    // Write while the data pins are inputs
+    __delay_us(HOST_TEST_CLEAR_US);
+    TRISD |= 0xF0;
+    writePins('Z', true, 1);
+    TRISD &= 0x0F;
+    check("violation floating", pStats->busViolations >= busViolations + 1);
+    check("violation executed anyway", readHd44780EmuDdram(0) == 'X'
+            && readHd44780EmuDdram(1) == 'Y');
+    printf("HOST TEST - last violation: %s\n", pStats->pLastViolation);
+
+    // Restore the display and the mirror of the driver
+    __delay_us(HOST_TEST_CLEAR_US);
+    LCD_Clear();
+    waitForLcd();
+}
+
+static void testBenchmark(void) {
+    
+    const HD44780_EMU_STATS *pStats = getHd44780EmuStats();
+    const HD44780_EMU_OP_STATS *pOp;
+    uint64_t startNs;
+    double seconds;
+
+    resetHd44780EmuStats();
+    startNs = getHostClockNs();
+    for (uint16_t i = 0; i < HOST_TEST_BENCHMARK_LINES; i++) {
+        LCD_SetCursor((i & 1) ? LCD_SECOND_LINE : LCD_FIRST_LINE, 0);
+        LCD_PrintString("0123456789ABCDEF");
+    }
+    while (!LCD_IsQueueEmpty())
+        __delay_us(1);
+    seconds = (getHostClockNs() - startNs) / 1e9;
+
+    printf("HOST BENCH - LCD %s: %u lines in %.1f ms (%.0f characters/s)\n",
+            LCD_USE_QUEUE ? "queued" : "direct", HOST_TEST_BENCHMARK_LINES,
+            seconds * 1e3, HOST_TEST_BENCHMARK_LINES * 16 / seconds);
+    for (uint8_t op = 0; op < HD44780_EMU_OP_COUNT; op++) {
+        pOp = &pStats->ops[op];
+        if (pOp->count == 0)
+            continue;
+        printf("HOST BENCH - %-20s %6lu x, mean %7.1f us, max. %7.1f us\n",
+                getHd44780EmuOpName(op), (unsigned long) pOp->count,
+                pOp->totalNs / 1e3 / pOp->count, pOp->maxNs / 1e3);
+    }
+    check("benchmark timing", getViolations() == 0);
+}
+
+int main(void) {
+    
+    initHostClock();
+    check("attach", initHd44780Emu());
+
+    testInit();
+    testPrint();
+    testRandomFrames();
+    testViolations();
+    testBenchmark();
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
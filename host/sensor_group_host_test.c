@@ -0,0 +1,175 @@
+/**
+ * 
+ * File Name:           sensor_group_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the sensor group. A BMP180 model is attached at
+ * BMP180_I2C_ADDR to each of the emulated I2C2 and I2C1 buses and the
+ * unmodified BMP180 driver, I2C simple masters and sensor group scheduler run
+ * for HOST_TEST_DURATION_MS of emulated time, first with the sensor on I2C2
+ * only and then with both sensors. For every oversampling setting, the
+ * interleaved conversions of two sensors have to reach at least
+ * HOST_TEST_MIN_SPEED_UP percent of the samples of a single sensor, both
+ * sensors have to contribute equally and the samples have to match the
+ * profile. The blocking transfers of one sensor can still delay the other,
+ * so the speed-up may stay slightly below 2. The exit code is the number of
+ * failed checks.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o sensor_group_host_test \
+ *      host/sensor_group_host_test.c host/bmp180_sim.c host/ssp1_emu.c \
+ *      host/ssp2_emu.c host/host_clock.c host/xc_registers.c \
+ *      sensor_group.c bmp180.c lcd.c lcd_app.c tick.c i2c_profile.c \
+ *      mcc_generated_files/i2c1_master.c mcc_generated_files/i2c2_master.c \
+ *      mcc_generated_files/drivers/i2c1_simple_master.c \
+ *      mcc_generated_files/drivers/i2c_simple_master.c -lm
+ *  ./sensor_group_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../bmp180.h"
+#include "../sensor_group.h"
+#include "../tick.h"
+#include "host_clock.h"
+#include "ssp1_emu.h"
+#include "bmp180_sim.h"
+
+#define HOST_TEST_DURATION_MS       2000
+#define HOST_TEST_PRESSURE          101325  // Pa of the default profile
+#define HOST_TEST_MIN_SPEED_UP      190     // percent of a single sensor
+#define HOST_TEST_MAX_IMBALANCE     1       // samples between the sensors
+
+// Result of a run of the sensor group
+typedef struct {
+    uint16_t samples[SENSOR_GROUP_MAX_SENSORS];
+    uint16_t total;
+    int32_t maxError;       // Pa of the latest samples
+} GROUP_RUN;
+
+static const BMP180_BUS *const sensorBus[SENSOR_GROUP_MAX_SENSORS] = {
+    &bmp180BusI2C2, &bmp180BusI2C1
+};
+static uint8_t failures;
+
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+/* Attaches the sensor models, initialises the drivers and runs the group of
+ * the given number of sensors for HOST_TEST_DURATION_MS. Each run starts
+ * from a fresh host clock, which also removes the hooks of the emulators. */
+static bool runGroup(uint8_t numSensors, BMP180_OVERSAMPLING oversampling,
+        GROUP_RUN *pRun) {
+    
+    static BMP180_PARAM sensor[SENSOR_GROUP_MAX_SENSORS];
+    static SENSOR_GROUP group;
+    uint16_t startTick;
+    int32_t error;
+
+    initHostClock();
+    initTick();
+    initSsp2Emu();
+    initSsp1Emu();
+    if (!initBmp180Sim())
+        return false;
+    if (numSensors > 1 && !attachBmp180Sim(attachSsp1Slave))
+        return false;
+    I2C2_Initialize();
+    I2C1_Initialize();
+
+    memset(sensor, 0, sizeof(sensor));
+    memset(pRun, 0, sizeof(*pRun));
+    initSensorGroup(&group);
+    for (uint8_t i = 0; i < numSensors; i++) {
+        sensor[i].bus = sensorBus[i];
+        sensor[i].oversampling = oversampling;
+        sensor[i].tempRefreshSamples = BMP180_TEMP_REFRESH_SAMPLES;
+        sensor[i].tempRefreshPeriod = BMP180_TEMP_REFRESH_PERIOD;
+        if (BMP180_Init(&sensor[i]) != 0
+                || addSensorToGroup(&group, &sensor[i]) != 0)
+            return false;
+    }
+
+    // The emulators step whenever the tick is read
+    startTick = getTickMs();
+    while (!hasTickElapsed(startTick, HOST_TEST_DURATION_MS))
+        runSensorGroup(&group);
+
+    for (uint8_t i = 0; i < group.numChannels; i++) {
+        pRun->samples[i] = group.channel[i].sampleCount;
+        pRun->total += group.channel[i].sampleCount;
+        error = group.channel[i].pressure - HOST_TEST_PRESSURE;
+        if (error < 0)
+            error = -error;
+        if (error > pRun->maxError)
+            pRun->maxError = error;
+    }
+
+    return true;
+}
+
+/* Compares the throughput of one and two sensors for an oversampling
+ * setting */
+static void testSpeedUp(BMP180_OVERSAMPLING oversampling) {
+    
+    GROUP_RUN single, pair;
+    uint16_t speedUp;
+    int16_t imbalance;
+    bool completed;
+    char name[32];
+
+    completed = runGroup(1, oversampling, &single)
+            && runGroup(SENSOR_GROUP_MAX_SENSORS, oversampling, &pair)
+            && single.total > 0;
+    snprintf(name, sizeof(name), "oss %u runs", oversampling);
+    check(name, completed);
+    if (!completed)
+        return;
+
+    speedUp = (uint32_t) pair.total * 100 / single.total;
+    imbalance = pair.samples[0] - pair.samples[1];
+    printf("HOST BENCH - oss %u: 1 sensor %u/s, %u sensors %u/s, "
+            "speed-up %u.%02u\n", oversampling,
+            single.total * 1000 / HOST_TEST_DURATION_MS,
+            SENSOR_GROUP_MAX_SENSORS,
+            pair.total * 1000 / HOST_TEST_DURATION_MS,
+            speedUp / 100, speedUp % 100);
+
+    snprintf(name, sizeof(name), "oss %u speed-up", oversampling);
+    check(name, speedUp >= HOST_TEST_MIN_SPEED_UP);
+    snprintf(name, sizeof(name), "oss %u balance", oversampling);
+    check(name, imbalance >= -HOST_TEST_MAX_IMBALANCE
+            && imbalance <= HOST_TEST_MAX_IMBALANCE);
+    snprintf(name, sizeof(name), "oss %u pressure", oversampling);
+    // One LSB of UP is about 5 Pa at oss = 0 and halves with each step
+    check(name, single.maxError <= (5 >> oversampling) + 1
+            && pair.maxError <= (5 >> oversampling) + 1);
+}
+
+int main(void) {
+    
+    for (uint8_t oss = BMP180_MODE_ULTRALOWPOWER;
+            oss <= BMP180_MODE_ULTRAHIGHRESOLUTION; oss++)
+        testSpeedUp(oss);
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0
+            && getSsp1EmuStats()->protocolErrors == 0);
+    check("sensor on I2C1", getBmp180SimSensorStats(1) != NULL
+            && getBmp180SimSensorStats(1)->pressureConversions > 0
+            && getBmp180SimSensorStats(1)->earlyReads == 0);
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
@@ -0,0 +1,54 @@
+/**
+ * 
+ * File:                ssp1_emu.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module compiles the MSSP2 emulator a second time for MSSP1. The
+ * registers, port pins and interrupt handlers it accesses are renamed to
+ * those of MSSP1 and the I2C1 driver, its public functions from Ssp2 to Ssp1.
+ * The state of the emulator is local to the module, so that both instances
+ * can be linked into one test and step independently.
+ * 
+*/
+
+
+#include <xc.h>
+#include "ssp1_emu.h"
+#include "../mcc_generated_files/i2c1_master.h"
+
+// Registers and pins of MSSP1
+#define SSP2BUF                 SSP1BUF
+#define SSP2ADD                 SSP1ADD
+#define SSP2STATbits            SSP1STATbits
+#define SSP2CON1bits            SSP1CON1bits
+#define SSP2CON2bits            SSP1CON2bits
+#define SSP2IF                  SSP1IF
+#define BCL2IF                  BCL1IF
+#define SSP2IE                  SSP1IE
+#define BCL2IE                  BCL1IE
+#define LATBbits                LATCbits
+#define LATB1                   LATC3
+#define LATB2                   LATC4
+#define TRISBbits               TRISCbits
+#define TRISB1                  TRISC3
+#define TRISB2                  TRISC4
+#define RB1PPS                  RC3PPS
+#define RB2PPS                  RC4PPS
+
+// Interrupt handlers of the I2C1 driver
+#define I2C2_ISR                I2C1_ISR
+#define I2C2_BusCollisionIsr    I2C1_BusCollisionIsr
+
+// Public functions
+#define initSsp2Emu             initSsp1Emu
+#define attachSsp2Slave         attachSsp1Slave
+#define setSsp2EmuFault         setSsp1EmuFault
+#define stepSsp2Emu             stepSsp1Emu
+#define getSsp2EmuStats         getSsp1EmuStats
+#define resetSsp2EmuStats       resetSsp1EmuStats
+
+#include "ssp2_emu.c"
@@ -0,0 +1,30 @@
+/*
+ * File:                ssp1_emu.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module emulates the MSSP1 peripheral in I2C master mode, so that the
+ * MCC I2C1 master driver runs unmodified on the host next to the I2C2 one.
+ * It is the MSSP2 emulator of ssp2_emu.c bound to the registers of MSSP1,
+ * i.e. SCL1 (RC3) and SDA1 (RC4), and to the interrupt handlers of the I2C1
+ * driver. Both buses have their own slaves, faults and statistics, the types
+ * are shared with ssp2_emu.h.
+ * 
+ */
+
+#ifndef SSP1_EMU_H
+#define	SSP1_EMU_H
+
+#include "ssp2_emu.h"
+
+void initSsp1Emu(void);
+bool attachSsp1Slave(const SSP2_EMU_SLAVE *pSlave);
+void setSsp1EmuFault(SSP2_EMU_FAULT fault, uint8_t releasePulses);
+void stepSsp1Emu(void);
+const SSP2_EMU_STATS *getSsp1EmuStats(void);
+void resetSsp1EmuStats(void);
+
+#endif	/* SSP1_EMU_H */
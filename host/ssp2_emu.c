@@ -0,0 +1,573 @@
+/**
+ * 
+ * File:                ssp2_emu.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module contains the MSSP2 emulator. One request of the driver is
+ * turned into a bus event at a time; further requests before its completion
+ * are ignored like by the MSSP2 and counted as protocol errors. The duration
+ * of an event is derived from SSP2ADD, i.e. a bit takes 4 * (SSP2ADD + 1)
+ * oscillator cycles:
+ * 
+ *      start, stop             1 bit
+ *      repeated start          1.5 bits
+ *      byte written            9 bits incl. ACK
+ *      byte read               8 bits + clock stretching of the slave
+ *      ACK/NACK                1 bit
+ * 
+ * During the bus recovery of the driver, SCL2 and SDA2 are driven by the
+ * port latches. The lines are sampled after each delay to count the clock
+ * pulses and to detect the stop condition.
+ * 
+*/
+
+
+#include <time.h>
+#include <xc.h>
+#include "ssp2_emu.h"
+#include "host_clock.h"
+#include "../mcc_generated_files/device_config.h"
+#include "../mcc_generated_files/i2c2_master.h"
+
+#define SSP2_EMU_BUF_CONSUMED       0x100   // upper byte of SSP2BUF
+#define SSP2_EMU_HALF_BITS_START    2
+#define SSP2_EMU_HALF_BITS_RESTART  3
+#define SSP2_EMU_HALF_BITS_STOP     2
+#define SSP2_EMU_HALF_BITS_TX       18
+#define SSP2_EMU_HALF_BITS_RX       16
+#define SSP2_EMU_HALF_BITS_ACK      2
+#define SSP2_EMU_PPS_PORT           0x00    // pin driven by its latch
+
+// Bus events
+typedef enum {
+    SSP2_EMU_EVENT_NONE,
+    SSP2_EMU_EVENT_START,
+    SSP2_EMU_EVENT_RESTART,
+    SSP2_EMU_EVENT_STOP,
+    SSP2_EMU_EVENT_TX,
+    SSP2_EMU_EVENT_RX,
+    SSP2_EMU_EVENT_ACK
+} SSP2_EMU_EVENT;
+
+// Local variables
+static const SSP2_EMU_SLAVE *slaves[SSP2_EMU_MAX_SLAVES];
+static uint8_t slaveCount;
+static const SSP2_EMU_SLAVE *pActiveSlave;  // slave addressed by the master
+static bool slaveReading;                   // direction of the active slave
+static bool addressPhase;                   // next byte is an address byte
+static SSP2_EMU_EVENT pendingEvent;
+static uint64_t eventDurationNs;
+static uint64_t completionNs;
+static SSP2_EMU_FAULT busFault;
+static uint8_t pulsesToRelease;
+static bool sclLevel;                       // lines driven by the port pins
+static bool sdaLevel;
+static SSP2_EMU_STATS stats;
+
+// Local function prototypes
+static void detectEvent(void);
+static void completeEvent(void);
+static void abortEvent(void);
+static void dispatchInterrupts(void);
+static void sampleSsp2Pins(void);
+static void endSlaveTransfer(void);
+static const SSP2_EMU_SLAVE *findSlave(uint8_t address);
+static uint64_t getHostCpuNs(void);
+
+
+/******************************************************************************* 
+ * Function to initialise the MSSP2 emulator
+ ******************************************************************************/
+/*
+ * @brief This function resets the MSSP2 registers, detaches all slaves and
+ * clears the statistics. It has to be invoked after initHostClock(), as it
+ * registers the emulator as poll hook and the sampling of the port pins as
+ * delay hook.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void initSsp2Emu(void) {
+    
+    SSP2BUF = SSP2_EMU_BUF_CONSUMED;
+    SSP2ADD = 0;
+    SSP2STAT = 0;
+    SSP2CON1 = 0;
+    SSP2CON2 = 0;
+    PIR3bits.SSP2IF = 0;
+    PIR3bits.BCL2IF = 0;
+    PIE3bits.SSP2IE = 0;
+    PIE3bits.BCL2IE = 0;
+
+    slaveCount = 0;
+    pActiveSlave = NULL;
+    addressPhase = true;
+    pendingEvent = SSP2_EMU_EVENT_NONE;
+    busFault = SSP2_EMU_FAULT_NONE;
+    sclLevel = true;
+    sdaLevel = true;
+    resetSsp2EmuStats();
+    (void) addHostPollHook(stepSsp2Emu);
+    (void) addHostDelayHook(sampleSsp2Pins);
+}
+
+
+/******************************************************************************* 
+ * Function to attach a slave to the emulated bus
+ ******************************************************************************/
+/*
+ * @brief This function plugs a slave into the bus. The descriptor has to
+ * remain valid while the emulator is used.
+ * 
+ * @param pointer to the slave (SSP2_EMU_SLAVE)
+ * 
+ * @return True if the slave has been attached
+ * 
+*/
+bool attachSsp2Slave(const SSP2_EMU_SLAVE *pSlave) {
+    
+    if (slaveCount >= SSP2_EMU_MAX_SLAVES || findSlave(pSlave->address))
+        return false;
+    slaves[slaveCount++] = pSlave;
+
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to inject a bus fault
+ ******************************************************************************/
+/*
+ * @brief This function injects a fault of the bus. A stuck SDA line is
+ * released after the given number of SCL pulses have been clocked by the
+ * port pins, or never if it is 0. A stuck SCL line is held until the fault
+ * is cleared by SSP2_EMU_FAULT_NONE.
+ * 
+ * @param fault (SSP2_EMU_FAULT), SCL pulses to release SDA (uint8_t)
+ * 
+ * @return void
+ * 
+*/
+void setSsp2EmuFault(SSP2_EMU_FAULT fault, uint8_t releasePulses) {
+    
+    busFault = fault;
+    pulsesToRelease = releasePulses;
+}
+
+
+/******************************************************************************* 
+ * Function to step the MSSP2 emulator
+ ******************************************************************************/
+/*
+ * @brief This function takes up the next request of the driver, advances the
+ * emulated time towards the completion of the pending bus event by at most
+ * SSP2_EMU_STEP_NS and dispatches the interrupts. It is invoked as poll hook
+ * whenever the firmware reads the tick, e.g. in the loop polling
+ * I2C2_Close(). An event, which should have completed during a delay of the
+ * firmware, completes at once.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void stepSsp2Emu(void) {
+    
+    uint64_t nowNs;
+
+    if (!SSP2CON1bits.SSPEN)
+        abortEvent();
+    else if (pendingEvent == SSP2_EMU_EVENT_NONE)
+        detectEvent();
+
+    nowNs = getHostClockNs();
+    if (pendingEvent == SSP2_EMU_EVENT_NONE
+            || busFault == SSP2_EMU_FAULT_SCL_STUCK) {
+        advanceHostClock(SSP2_EMU_STEP_NS);
+    } else if (completionNs > nowNs + SSP2_EMU_STEP_NS) {
+        advanceHostClock(SSP2_EMU_STEP_NS);
+    } else {
+        if (completionNs > nowNs)
+            advanceHostClock(completionNs - nowNs);
+        completeEvent();
+    }
+
+    dispatchInterrupts();
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics of the emulated bus
+ ******************************************************************************/
+/*
+ * @brief This function returns the statistics since the last reset.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics
+ * 
+*/
+const SSP2_EMU_STATS *getSsp2EmuStats(void) {
+    
+    return &stats;
+}
+
+
+/******************************************************************************* 
+ * Function to reset the statistics of the emulated bus
+ ******************************************************************************/
+/*
+ * @brief This function clears the statistics.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void resetSsp2EmuStats(void) {
+    
+    stats = (SSP2_EMU_STATS) {0};
+}
+
+
+/******************************************************************************* 
+ * Function to take up a request of the driver
+ ******************************************************************************/
+/*
+ * @brief This function turns a request of the driver into the pending bus
+ * event. SSP2BUF counts as written if the driver has cleared its upper byte.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void detectEvent(void) {
+    
+    SSP2_EMU_EVENT event = SSP2_EMU_EVENT_NONE;
+    uint8_t requests = 0;
+    uint8_t halfBits = 0;
+    uint16_t stretchUs = 0;
+
+    if (!(SSP2BUF & SSP2_EMU_BUF_CONSUMED)) {
+        requests++;
+        event = SSP2_EMU_EVENT_TX;
+        halfBits = SSP2_EMU_HALF_BITS_TX;
+    }
+    if (SSP2CON2bits.SEN) {
+        requests++;
+        event = SSP2_EMU_EVENT_START;
+        halfBits = SSP2_EMU_HALF_BITS_START;
+    }
+    if (SSP2CON2bits.RSEN) {
+        requests++;
+        event = SSP2_EMU_EVENT_RESTART;
+        halfBits = SSP2_EMU_HALF_BITS_RESTART;
+    }
+    if (SSP2CON2bits.PEN) {
+        requests++;
+        event = SSP2_EMU_EVENT_STOP;
+        halfBits = SSP2_EMU_HALF_BITS_STOP;
+    }
+    if (SSP2CON2bits.RCEN) {
+        requests++;
+        event = SSP2_EMU_EVENT_RX;
+        halfBits = SSP2_EMU_HALF_BITS_RX;
+    }
+    if (SSP2CON2bits.ACKEN) {
+        requests++;
+        event = SSP2_EMU_EVENT_ACK;
+        halfBits = SSP2_EMU_HALF_BITS_ACK;
+    }
+
+    if (requests == 0)
+        return;
+    if (requests > 1) {
+        stats.protocolErrors++;
+        SSP2CON1bits.WCOL = 1;
+    }
+    if (event == SSP2_EMU_EVENT_TX) {
+        SSP2BUF |= SSP2_EMU_BUF_CONSUMED;
+        SSP2STATbits.BF = 1;
+    } else if (event == SSP2_EMU_EVENT_RX && pActiveSlave) {
+        stretchUs = pActiveSlave->stretchUs;
+    }
+
+    pendingEvent = event;
+    eventDurationNs = (uint64_t) halfBits * 2 * (SSP2ADD + 1)
+            * 1000000000ULL / _XTAL_FREQ + (uint64_t) stretchUs * 1000;
+    completionNs = getHostClockNs() + eventDurationNs;
+}
+
+
+/******************************************************************************* 
+ * Function to complete the pending bus event
+ ******************************************************************************/
+/*
+ * @brief This function updates the registers like the MSSP2 at the end of the
+ * pending bus event, informs the slaves and raises the interrupt flag.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void completeEvent(void) {
+    
+    const SSP2_EMU_SLAVE *pSlave;
+    uint8_t data;
+    bool ack;
+
+    stats.busTimeNs += eventDurationNs;
+
+    switch (pendingEvent) {
+        case SSP2_EMU_EVENT_START:
+        case SSP2_EMU_EVENT_RESTART:
+            SSP2CON2bits.SEN = 0;
+            SSP2CON2bits.RSEN = 0;
+            if (busFault == SSP2_EMU_FAULT_SDA_STUCK) {
+                stats.collisions++;
+                PIR3bits.BCL2IF = 1;
+                pendingEvent = SSP2_EMU_EVENT_NONE;
+                return; // no MSSP2 interrupt after a collision
+            }
+            if (pendingEvent == SSP2_EMU_EVENT_START)
+                stats.starts++;
+            else
+                stats.restarts++;
+            pActiveSlave = NULL;
+            addressPhase = true;
+            SSP2STATbits.S = 1;
+            SSP2STATbits.P = 0;
+            break;
+
+        case SSP2_EMU_EVENT_STOP:
+            SSP2CON2bits.PEN = 0;
+            endSlaveTransfer();
+            stats.stops++;
+            SSP2STATbits.S = 0;
+            SSP2STATbits.P = 1;
+            break;
+
+        case SSP2_EMU_EVENT_TX:
+            data = (uint8_t) SSP2BUF;
+            if (addressPhase) {
+                addressPhase = false;
+                pSlave = findSlave(data >> 1);
+                ack = (pSlave != NULL);
+                if (pSlave && pSlave->start)
+                    ack = pSlave->start(pSlave->pContext, data & 0x01);
+                if (ack) {
+                    pActiveSlave = pSlave;
+                    slaveReading = data & 0x01;
+                }
+            } else if (pActiveSlave && !slaveReading) {
+                ack = pActiveSlave->write
+                        ? pActiveSlave->write(pActiveSlave->pContext, data)
+                        : true;
+            } else {
+                ack = false;
+            }
+            if (!ack)
+                stats.nacks++;
+            stats.bytes++;
+            SSP2CON2bits.ACKSTAT = !ack;
+            SSP2STATbits.BF = 0;
+            break;
+
+        case SSP2_EMU_EVENT_RX:
+            data = 0xFF; // released SDA if no slave is sending
+            if (pActiveSlave && slaveReading && pActiveSlave->read)
+                data = pActiveSlave->read(pActiveSlave->pContext);
+            stats.bytes++;
+            SSP2BUF = SSP2_EMU_BUF_CONSUMED | data;
+            SSP2STATbits.BF = 1;
+            SSP2CON2bits.RCEN = 0;
+            break;
+
+        case SSP2_EMU_EVENT_ACK:
+            SSP2CON2bits.ACKEN = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    pendingEvent = SSP2_EMU_EVENT_NONE;
+    PIR3bits.SSP2IF = 1;
+}
+
+
+/******************************************************************************* 
+ * Function to abort the pending bus event
+ ******************************************************************************/
+/*
+ * @brief This function drops the pending bus event once the MSSP2 has been
+ * disabled. The slave isn't informed, i.e. it keeps its state until a stop
+ * condition.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void abortEvent(void) {
+    
+    pendingEvent = SSP2_EMU_EVENT_NONE;
+    SSP2BUF |= SSP2_EMU_BUF_CONSUMED;
+    SSP2STATbits.BF = 0;
+    SSP2CON2 &= ~0x1F; // SEN, RSEN, PEN, RCEN and ACKEN
+}
+
+
+/******************************************************************************* 
+ * Function to dispatch the MSSP2 interrupts
+ ******************************************************************************/
+/*
+ * @brief This function invokes the interrupt handlers of the I2C2 driver in
+ * the order of the MCC interrupt manager as long as an enabled flag is set,
+ * since the driver raises the flag itself to continue the FSM. The host CPU
+ * time spent in the handlers is accumulated.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void dispatchInterrupts(void) {
+    
+    uint64_t startNs;
+
+    for (uint8_t i = 0; i < SSP2_EMU_MAX_ISR_NESTING; i++) {
+        // Read the CPU time only if a handler runs; it is a system call
+        if (!(PIE3bits.SSP2IE && PIR3bits.SSP2IF)
+                && !(PIE3bits.BCL2IE && PIR3bits.BCL2IF))
+            break;
+        startNs = getHostCpuNs();
+        if (PIE3bits.SSP2IE && PIR3bits.SSP2IF) {
+            I2C2_ISR();
+            stats.isrCalls++;
+        } else {
+            I2C2_BusCollisionIsr();
+            stats.collisionIsrCalls++;
+        }
+        stats.isrHostNs += getHostCpuNs() - startNs;
+        wakeHostCpu();
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to sample SCL2 and SDA2
+ ******************************************************************************/
+/*
+ * @brief This delay hook samples the lines while they are driven by the port
+ * latches (PPS output 0x00), i.e. open drain by TRIS. Falling edges of SCL
+ * are counted as recovery pulses and may release a stuck SDA line. A rising
+ * edge of SDA while SCL is high is a stop condition.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void sampleSsp2Pins(void) {
+    
+    bool scl = true;
+    bool sda = true;
+
+    if (!SSP2CON1bits.SSPEN)
+        abortEvent();
+
+    if (RB1PPS == SSP2_EMU_PPS_PORT)
+        scl = TRISBbits.TRISB1 || LATBbits.LATB1;
+    if (RB2PPS == SSP2_EMU_PPS_PORT)
+        sda = TRISBbits.TRISB2 || LATBbits.LATB2;
+    if (busFault == SSP2_EMU_FAULT_SCL_STUCK)
+        scl = false;
+    if (busFault == SSP2_EMU_FAULT_SDA_STUCK)
+        sda = false;
+
+    if (sclLevel && !scl && RB1PPS == SSP2_EMU_PPS_PORT) {
+        stats.recoveryPulses++;
+        if (busFault == SSP2_EMU_FAULT_SDA_STUCK && pulsesToRelease
+                && --pulsesToRelease == 0)
+            busFault = SSP2_EMU_FAULT_NONE;
+    }
+    if (scl && sclLevel && !sdaLevel && sda) {
+        stats.recoveryStops++;
+        endSlaveTransfer();
+    }
+
+    sclLevel = scl;
+    sdaLevel = sda;
+}
+
+
+/******************************************************************************* 
+ * Function to end the transfer of the active slave
+ ******************************************************************************/
+/*
+ * @brief This function informs the active slave about a stop condition.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+static void endSlaveTransfer(void) {
+    
+    if (pActiveSlave && pActiveSlave->stop)
+        pActiveSlave->stop(pActiveSlave->pContext);
+    pActiveSlave = NULL;
+    addressPhase = true;
+}
+
+
+/******************************************************************************* 
+ * Function to find a slave
+ ******************************************************************************/
+/*
+ * @brief This function returns the slave with the given 7-bit address.
+ * 
+ * @param address (uint8_t)
+ * 
+ * @return pointer to the slave or NULL if none has been attached
+ * 
+*/
+static const SSP2_EMU_SLAVE *findSlave(uint8_t address) {
+    
+    for (uint8_t i = 0; i < slaveCount; i++) {
+        if (slaves[i]->address == address)
+            return slaves[i];
+    }
+
+    return NULL;
+}
+
+
+/******************************************************************************* 
+ * Function to get the host CPU time
+ ******************************************************************************/
+/*
+ * @brief This function returns the CPU time of the host process.
+ * 
+ * @param None
+ * 
+ * @return CPU time in ns (uint64_t)
+ * 
+*/
+static uint64_t getHostCpuNs(void) {
+    
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
@@ -0,0 +1,75 @@
+/*
+ * File:                ssp2_emu.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module emulates the MSSP2 peripheral in I2C master mode at register
+ * level, so that the MCC I2C2 master driver runs unmodified on the host. The
+ * requests of the driver (SEN, RSEN, PEN, RCEN, ACKEN and writes of SSP2BUF)
+ * are turned into bus events, which take the time of the configured baud
+ * rate plus the clock stretching of the slave. On completion, the emulator
+ * updates SSP2BUF, SSP2STAT and SSP2CON2 and dispatches the MSSP2 and bus
+ * collision interrupts like the MCC interrupt manager does.
+ * 
+ * Slaves are plugged in by callbacks. Faults of the bus, i.e. a stuck clock
+ * or data line, can be injected to exercise the timeout and bus recovery of
+ * the driver.
+ * 
+ */
+
+#ifndef SSP2_EMU_H
+#define	SSP2_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSP2_EMU_MAX_SLAVES         4
+#define SSP2_EMU_STEP_NS            10000   // max. time advanced by a step
+#define SSP2_EMU_MAX_ISR_NESTING    8       // interrupts dispatched per step
+
+// A slave on the emulated bus; each callback may be NULL
+typedef struct {
+    uint8_t address;                                // 7-bit address
+    bool (*start)(void *pContext, bool read);       // address ACK after (re)start
+    bool (*write)(void *pContext, uint8_t data);    // returns the ACK
+    uint8_t (*read)(void *pContext);                // byte to the master
+    void (*stop)(void *pContext);
+    uint16_t stretchUs;                             // stretching per byte read
+    void *pContext;
+} SSP2_EMU_SLAVE;
+
+// Faults of the emulated bus
+typedef enum {
+    SSP2_EMU_FAULT_NONE,
+    SSP2_EMU_FAULT_SCL_STUCK,   // bus events don't complete until cleared
+    SSP2_EMU_FAULT_SDA_STUCK    // start causes a collision until released
+} SSP2_EMU_FAULT;
+
+// Statistics of the emulated bus
+typedef struct {
+    uint32_t starts;
+    uint32_t restarts;
+    uint32_t stops;
+    uint32_t bytes;             // bytes clocked incl. address bytes
+    uint32_t nacks;
+    uint32_t collisions;
+    uint32_t isrCalls;          // invocations of I2C2_ISR()
+    uint32_t collisionIsrCalls; // invocations of I2C2_BusCollisionIsr()
+    uint32_t protocolErrors;    // requests the MSSP2 would have ignored
+    uint32_t recoveryPulses;    // SCL pulses clocked by the port pins
+    uint32_t recoveryStops;     // stop conditions generated by the port pins
+    uint64_t busTimeNs;         // time the bus was driven by the MSSP2
+    uint64_t isrHostNs;         // host CPU time spent in the interrupts
+} SSP2_EMU_STATS;
+
+void initSsp2Emu(void);
+bool attachSsp2Slave(const SSP2_EMU_SLAVE *pSlave);
+void setSsp2EmuFault(SSP2_EMU_FAULT fault, uint8_t releasePulses);
+void stepSsp2Emu(void);
+const SSP2_EMU_STATS *getSsp2EmuStats(void);
+void resetSsp2EmuStats(void);
+
+#endif	/* SSP2_EMU_H */
@@ -0,0 +1,232 @@
+/**
+ * 
+ * File Name:           vario_host_test.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+ * Program version:     1.0
+
+ * Description:
+ * ------------
+ * Host test of the variometer filter. A pressure trace of a stationary phase
+ * followed by a climb is recorded at VARIO_SAMPLE_RATE_HZ and oss = 0 by the
+ * unmodified BMP180 driver from the BMP180 model, once with the noise of the
+ * sensor and once without. Both traces are replayed through the ring buffer,
+ * the altitude kernel and updateVarioFilter(). The noisy trace has to show
+ * the altitude noise assumed by vario.h and the filter has to reduce its
+ * speed noise to HOST_TEST_MAX_SPEED_NOISE, while the noise-free trace has to
+ * settle to the climb rate within HOST_TEST_MAX_SETTLING_MS. The exit code is
+ * the number of failed checks.
+ * 
+ * Build and run from the project directory:
+ * 
+ *  gcc -std=gnu99 -Wall -D__DEBUG -Ihost -o vario_host_test \
+ *      host/vario_host_test.c host/bmp180_sim.c host/ssp2_emu.c \
+ *      host/host_clock.c host/xc_registers.c bmp180.c vario.c lcd.c \
+ *      lcd_app.c tick.c i2c_profile.c mcc_generated_files/i2c1_master.c \
+ *      mcc_generated_files/i2c2_master.c \
+ *      mcc_generated_files/drivers/i2c1_simple_master.c \
+ *      mcc_generated_files/drivers/i2c_simple_master.c -lm
+ *  ./vario_host_test
+ * 
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "../bmp180.h"
+#include "../vario.h"
+#include "../tick.h"
+#include "host_clock.h"
+#include "ssp2_emu.h"
+#include "bmp180_sim.h"
+
+#define HOST_TEST_STATIC_SAMPLES    1000    // 10 s at 100 Hz
+#define HOST_TEST_CLIMB_SAMPLES     500
+#define HOST_TEST_TRACE_SAMPLES     (HOST_TEST_STATIC_SAMPLES \
+                                    + HOST_TEST_CLIMB_SAMPLES)
+#define HOST_TEST_START_PRESSURE    97772   // Pa, 300 m
+#define HOST_TEST_CLIMB_PRESSURE    12      // Pa per s, ~1 m/s at 300 m
+#define HOST_TEST_TEMPERATURE       200     // 0.1 Celsius degree
+#define HOST_TEST_NOISE_PRESSURE    3       // LSB of UP at oss = 0, ~3 Pa each
+#define HOST_TEST_NOISE_SEED        4711
+#define HOST_TEST_MIN_ALT_NOISE     0.3     // m rms of the raw altitude
+#define HOST_TEST_MAX_ALT_NOISE     0.7
+#define HOST_TEST_MAX_SPEED_NOISE   0.5     // m/s rms of the filter
+#define HOST_TEST_MAX_SETTLING_MS   500     // to 90 % of the climb rate
+#define HOST_TEST_NS_PER_MS         1000000ULL
+
+static int32_t trace[HOST_TEST_TRACE_SAMPLES];
+static BMP180_SIM_POINT profile[3];
+static uint8_t failures;
+
+
+static void check(const char *name, bool passed) {
+    
+    if (!passed)
+        failures++;
+    printf("HOST TEST - %s: %s\n", name, passed ? "ok" : "FAILED");
+}
+
+/* Waits for the conversion in progress; the tick lets the emulators run */
+static void waitForConversion(BMP180_PARAM *pSensor) {
+    
+    while (!BMP180_IsConversionComplete(pSensor))
+        ;
+}
+
+/* Records the true pressure at the sample rate of the variometer */
+static bool recordTrace(BMP180_PARAM *pSensor, uint16_t noise) {
+    
+    uint64_t startNs;
+    uint64_t sampleNs;
+    uint32_t startMs;
+    uint32_t climbMs = HOST_TEST_STATIC_SAMPLES * VARIO_SAMPLE_PERIOD_MS;
+    uint32_t endMs = HOST_TEST_TRACE_SAMPLES * VARIO_SAMPLE_PERIOD_MS;
+    uint16_t ut;
+    uint32_t up;
+
+    // The temperature is constant, so a single conversion is sufficient
+    profile[0] = (BMP180_SIM_POINT) {0, HOST_TEST_TEMPERATURE,
+            HOST_TEST_START_PRESSURE};
+    setBmp180SimProfile(profile, 1);
+    if (BMP180_StartTemperatureConversion(pSensor) != 0)
+        return false;
+    waitForConversion(pSensor);
+    ut = BMP180_CollectRawTemperature(pSensor);
+
+    startNs = getHostClockNs();
+    startMs = startNs / HOST_TEST_NS_PER_MS;
+    profile[0].timeMs = startMs;
+    profile[1] = (BMP180_SIM_POINT) {startMs + climbMs,
+            HOST_TEST_TEMPERATURE, HOST_TEST_START_PRESSURE};
+    profile[2] = (BMP180_SIM_POINT) {startMs + endMs, HOST_TEST_TEMPERATURE,
+            HOST_TEST_START_PRESSURE - (int32_t) (endMs - climbMs)
+            * HOST_TEST_CLIMB_PRESSURE / 1000};
+    setBmp180SimProfile(profile, 3);
+    setBmp180SimNoise(0, noise, HOST_TEST_NOISE_SEED);
+
+    for (uint16_t i = 0; i < HOST_TEST_TRACE_SAMPLES; i++) {
+        sampleNs = startNs + (uint64_t) i * VARIO_SAMPLE_PERIOD_MS
+                * HOST_TEST_NS_PER_MS;
+        if (getHostClockNs() < sampleNs)
+            advanceHostClock(sampleNs - getHostClockNs());
+        if (BMP180_StartPressureConversion(pSensor) != 0)
+            return false;
+        waitForConversion(pSensor);
+        up = BMP180_CollectRawPressure(pSensor);
+        if (ut == BMP180_INVALID_DATA || up == BMP180_INVALID_DATA)
+            return false;
+        trace[i] = BMP180_CalcPressure(pSensor, up, ut);
+    }
+    setBmp180SimNoise(0, 0, 0);
+
+    return true;
+}
+
+/* Returns the speed estimated by the filter in m/s, without rounding */
+static double getSpeed(const VARIO_FILTER *pFilter) {
+    
+    return pFilter->speed * VARIO_SAMPLE_RATE_HZ / 100.0
+            / (1L << VARIO_FILTER_FRACTION_BITS);
+}
+
+/* Replays the trace through the ring buffer and the filter. The speed noise
+ * is taken in the second half of the stationary phase, the settling time is
+ * the time until the speed reaches 90 % of the climb rate. */
+static void replayTrace(double climbRate, double *pSpeedNoise,
+        uint16_t *pSettlingMs) {
+    
+    VARIO_FILTER filter;
+    VARIO_SAMPLE sample;
+    double speed;
+    double sumSquares = 0;
+    uint16_t samples = 0;
+
+    *pSettlingMs = UINT16_MAX;
+    resetVarioFilter(&filter);
+    for (uint16_t i = 0; i < HOST_TEST_TRACE_SAMPLES; i++) {
+        sample.pressure = trace[i];
+        sample.tick = i * VARIO_SAMPLE_PERIOD_MS;
+        (void) pushVarioSample(&sample);
+        while (popVarioSample(&sample))
+            updateVarioFilter(&filter, BMP180_CalcAltitudeCm(sample.pressure));
+
+        speed = getSpeed(&filter);
+        if (i >= HOST_TEST_STATIC_SAMPLES / 2
+                && i < HOST_TEST_STATIC_SAMPLES) {
+            sumSquares += speed * speed;
+            samples++;
+        }
+        if (i >= HOST_TEST_STATIC_SAMPLES && *pSettlingMs == UINT16_MAX
+                && speed >= 0.9 * climbRate)
+            *pSettlingMs = (i - HOST_TEST_STATIC_SAMPLES + 1)
+                    * VARIO_SAMPLE_PERIOD_MS;
+    }
+    *pSpeedNoise = sqrt(sumSquares / samples);
+}
+
+/* Returns the climb rate of the trace in m/s */
+static double getClimbRate(void) {
+    
+    int32_t climbCm = BMP180_CalcAltitudeCm(trace[HOST_TEST_TRACE_SAMPLES - 1])
+            - BMP180_CalcAltitudeCm(trace[HOST_TEST_STATIC_SAMPLES - 1]);
+
+    return climbCm / 100.0 * VARIO_SAMPLE_RATE_HZ / HOST_TEST_CLIMB_SAMPLES;
+}
+
+/* Returns the rms deviation of the altitude of the stationary phase */
+static double getAltitudeNoise(void) {
+    
+    double sum = 0, sumSquares = 0, altitude, mean;
+
+    for (uint16_t i = 0; i < HOST_TEST_STATIC_SAMPLES; i++) {
+        altitude = BMP180_CalcAltitudeCm(trace[i]) / 100.0;
+        sum += altitude;
+        sumSquares += altitude * altitude;
+    }
+    mean = sum / HOST_TEST_STATIC_SAMPLES;
+
+    return sqrt(sumSquares / HOST_TEST_STATIC_SAMPLES - mean * mean);
+}
+
+int main(void) {
+    
+    BMP180_PARAM sensor = {0};
+    double altitudeNoise, speedNoise, cleanSpeedNoise, climbRate;
+    uint16_t settlingMs, noisySettlingMs;
+    bool recorded;
+
+    initHostClock();
+    initSsp2Emu();
+    check("attach", initBmp180Sim());
+    initTick();
+    I2C2_Initialize();
+    sensor.oversampling = BMP180_MODE_ULTRALOWPOWER;
+    check("init", BMP180_Init(&sensor) == 0);
+
+    recorded = recordTrace(&sensor, 0);
+    check("record clean trace", recorded);
+    climbRate = getClimbRate();
+    replayTrace(climbRate, &cleanSpeedNoise, &settlingMs);
+
+    recorded = recordTrace(&sensor, HOST_TEST_NOISE_PRESSURE);
+    check("record noisy trace", recorded);
+    altitudeNoise = getAltitudeNoise();
+    replayTrace(climbRate, &speedNoise, &noisySettlingMs);
+
+    printf("HOST BENCH - climb %.2f m/s settles in %u ms (%u ms with noise)"
+            "\n", climbRate, settlingMs, noisySettlingMs);
+    printf("HOST BENCH - altitude noise %.2f m rms, speed noise %.3f m/s "
+            "rms (%.3f m/s without noise)\n", altitudeNoise, speedNoise,
+            cleanSpeedNoise);
+    check("altitude noise", altitudeNoise >= HOST_TEST_MIN_ALT_NOISE
+            && altitudeNoise <= HOST_TEST_MAX_ALT_NOISE);
+    check("speed noise", speedNoise <= HOST_TEST_MAX_SPEED_NOISE);
+    check("speed noise without noise", cleanSpeedNoise < 0.01);
+    check("settling", settlingMs <= HOST_TEST_MAX_SETTLING_MS);
+    check("protocol", getSsp2EmuStats()->protocolErrors == 0);
+
+    printf("HOST TEST - failures: %u\n", failures);
+
+    return failures;
+}
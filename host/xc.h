@@ -0,0 +1,324 @@
+/*
+ * File:                xc.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * Stand-in for the XC8 device header, which is picked up instead of the
+ * compiler's one by the host build (-Ihost). It declares only the special
+ * function registers used by the modules compiled on the host, as plain
+ * variables with the bit layout of the PIC18F47Q10 datasheet. The peripheral
+ * behaviour is modelled by the emulators, e.g. ssp2_emu.c for MSSP2.
+ * 
+ * SSP1BUF and SSP2BUF are declared 16 bits wide, so that the emulator can
+ * tell whether the driver has written them: the emulator sets the upper byte
+ * when it loads or consumes the buffer and a write of the driver clears it.
+ * Reads of the driver are truncated to the received byte.
+ * 
+ * The host CPU doesn't run concurrently with the emulated peripherals. They
+ * progress whenever the firmware reads the tick, which masks the timer 1
+ * interrupt by PIE4bits. Hence, PIE4bits is an accessor, which runs the poll
+ * hooks of the host clock. Every wait loop of the firmware reads the tick.
+ * 
+ * LATDbits and PORTD are accessors as well, so that an emulator of the LCD,
+ * e.g. hd44780_emu.c, samples the pins on each access. It sees the state left
+ * by the previous access, like a logic analyser sampling between instructions.
+ * NOP() advances the emulated time by one instruction cycle. SLEEP() idles
+ * until the next interrupt, i.e. it lets the emulators progress until a
+ * timer or an emulated peripheral has invoked an interrupt handler.
+ * 
+ */
+
+#ifndef HOST_XC_H
+#define	HOST_XC_H
+
+#include <stdint.h>
+
+// Delays advance the emulated time instead of spinning
+void hostDelayUs(uint32_t us);
+void hostNop(void);
+void hostSleep(void);
+#define __delay_us(x)           hostDelayUs(x)
+#define __delay_ms(x)           hostDelayUs((uint32_t)(x) * 1000UL)
+#define __interrupt(...)
+#define NOP()                   hostNop()
+#define CLRWDT()
+#define SLEEP()                 hostSleep()
+
+// MSSP1
+extern volatile uint16_t SSP1BUF;
+extern volatile uint8_t SSP1ADD;
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t BF:1;
+        uint8_t UA:1;
+        uint8_t R_nW:1;
+        uint8_t S:1;
+        uint8_t P:1;
+        uint8_t D_nA:1;
+        uint8_t CKE:1;
+        uint8_t SMP:1;
+    };
+} SSP1STATbits_t;
+extern volatile SSP1STATbits_t SSP1STATbits;
+#define SSP1STAT                SSP1STATbits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SSPM:4;
+        uint8_t CKP:1;
+        uint8_t SSPEN:1;
+        uint8_t SSPOV:1;
+        uint8_t WCOL:1;
+    };
+} SSP1CON1bits_t;
+extern volatile SSP1CON1bits_t SSP1CON1bits;
+#define SSP1CON1                SSP1CON1bits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SEN:1;
+        uint8_t RSEN:1;
+        uint8_t PEN:1;
+        uint8_t RCEN:1;
+        uint8_t ACKEN:1;
+        uint8_t ACKDT:1;
+        uint8_t ACKSTAT:1;
+        uint8_t GCEN:1;
+    };
+} SSP1CON2bits_t;
+extern volatile SSP1CON2bits_t SSP1CON2bits;
+#define SSP1CON2                SSP1CON2bits.value
+
+// MSSP2
+extern volatile uint16_t SSP2BUF;
+extern volatile uint8_t SSP2ADD;
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t BF:1;
+        uint8_t UA:1;
+        uint8_t R_nW:1;
+        uint8_t S:1;
+        uint8_t P:1;
+        uint8_t D_nA:1;
+        uint8_t CKE:1;
+        uint8_t SMP:1;
+    };
+} SSP2STATbits_t;
+extern volatile SSP2STATbits_t SSP2STATbits;
+#define SSP2STAT                SSP2STATbits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SSPM:4;
+        uint8_t CKP:1;
+        uint8_t SSPEN:1;
+        uint8_t SSPOV:1;
+        uint8_t WCOL:1;
+    };
+} SSP2CON1bits_t;
+extern volatile SSP2CON1bits_t SSP2CON1bits;
+#define SSP2CON1                SSP2CON1bits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SEN:1;
+        uint8_t RSEN:1;
+        uint8_t PEN:1;
+        uint8_t RCEN:1;
+        uint8_t ACKEN:1;
+        uint8_t ACKDT:1;
+        uint8_t ACKSTAT:1;
+        uint8_t GCEN:1;
+    };
+} SSP2CON2bits_t;
+extern volatile SSP2CON2bits_t SSP2CON2bits;
+#define SSP2CON2                SSP2CON2bits.value
+
+// Interrupt flags and enables of MSSP1/2 and EUSART1/2
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SSP1IF:1;
+        uint8_t BCL1IF:1;
+        uint8_t SSP2IF:1;
+        uint8_t BCL2IF:1;
+        uint8_t TX1IF:1;
+        uint8_t RC1IF:1;
+        uint8_t TX2IF:1;
+        uint8_t RC2IF:1;
+    };
+} PIR3bits_t;
+extern volatile PIR3bits_t PIR3bits;
+#define PIR3                    PIR3bits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t SSP1IE:1;
+        uint8_t BCL1IE:1;
+        uint8_t SSP2IE:1;
+        uint8_t BCL2IE:1;
+        uint8_t TX1IE:1;
+        uint8_t RC1IE:1;
+        uint8_t TX2IE:1;
+        uint8_t RC2IE:1;
+    };
+} PIE3bits_t;
+extern volatile PIE3bits_t PIE3bits;
+#define PIE3                    PIE3bits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t TMR1IE:1;
+        uint8_t TMR2IE:1;
+        uint8_t TMR3IE:1;
+        uint8_t TMR4IE:1;
+        uint8_t TMR5IE:1;
+        uint8_t TMR6IE:1;
+        uint8_t :2;
+    };
+} PIE4bits_t;
+volatile PIE4bits_t *pollHostPie4bits(void);
+#define PIE4bits                (*pollHostPie4bits())
+#define PIE4                    PIE4bits.value
+
+// Port B, which carries SCL2 (RB1) and SDA2 (RB2)
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t LATB0:1;
+        uint8_t LATB1:1;
+        uint8_t LATB2:1;
+        uint8_t LATB3:1;
+        uint8_t LATB4:1;
+        uint8_t LATB5:1;
+        uint8_t LATB6:1;
+        uint8_t LATB7:1;
+    };
+} LATBbits_t;
+extern volatile LATBbits_t LATBbits;
+#define LATB                    LATBbits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t TRISB0:1;
+        uint8_t TRISB1:1;
+        uint8_t TRISB2:1;
+        uint8_t TRISB3:1;
+        uint8_t TRISB4:1;
+        uint8_t TRISB5:1;
+        uint8_t TRISB6:1;
+        uint8_t TRISB7:1;
+    };
+} TRISBbits_t;
+extern volatile TRISBbits_t TRISBbits;
+#define TRISB                   TRISBbits.value
+
+extern volatile uint8_t RB1PPS;
+extern volatile uint8_t RB2PPS;
+
+// Port C, which carries SCL1 (RC3) and SDA1 (RC4)
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t LATC0:1;
+        uint8_t LATC1:1;
+        uint8_t LATC2:1;
+        uint8_t LATC3:1;
+        uint8_t LATC4:1;
+        uint8_t LATC5:1;
+        uint8_t LATC6:1;
+        uint8_t LATC7:1;
+    };
+} LATCbits_t;
+extern volatile LATCbits_t LATCbits;
+#define LATC                    LATCbits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t TRISC0:1;
+        uint8_t TRISC1:1;
+        uint8_t TRISC2:1;
+        uint8_t TRISC3:1;
+        uint8_t TRISC4:1;
+        uint8_t TRISC5:1;
+        uint8_t TRISC6:1;
+        uint8_t TRISC7:1;
+    };
+} TRISCbits_t;
+extern volatile TRISCbits_t TRISCbits;
+#define TRISC                   TRISCbits.value
+
+extern volatile uint8_t RC3PPS;
+extern volatile uint8_t RC4PPS;
+
+// Port D, which carries the LCD
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t LATD0:1;
+        uint8_t LATD1:1;
+        uint8_t LATD2:1;
+        uint8_t LATD3:1;
+        uint8_t LATD4:1;
+        uint8_t LATD5:1;
+        uint8_t LATD6:1;
+        uint8_t LATD7:1;
+    };
+} LATDbits_t;
+volatile LATDbits_t *accessHostLatdbits(void);
+#define LATDbits                (*accessHostLatdbits())
+#define LATD                    LATDbits.value
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t TRISD0:1;
+        uint8_t TRISD1:1;
+        uint8_t TRISD2:1;
+        uint8_t TRISD3:1;
+        uint8_t TRISD4:1;
+        uint8_t TRISD5:1;
+        uint8_t TRISD6:1;
+        uint8_t TRISD7:1;
+    };
+} TRISDbits_t;
+extern volatile TRISDbits_t TRISDbits;
+#define TRISD                   TRISDbits.value
+
+uint8_t readHostPortd(void);
+#define PORTD                   readHostPortd()
+
+// Hooks of an emulator connected to port D
+void setHostPortdHooks(void (*sample)(void), uint8_t (*read)(void));
+
+// CPU doze control
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t DOZE:3;
+        uint8_t :1;
+        uint8_t DOE:1;
+        uint8_t ROI:1;
+        uint8_t DOZEN:1;
+        uint8_t IDLEN:1;
+    };
+} CPUDOZEbits_t;
+extern volatile CPUDOZEbits_t CPUDOZEbits;
+#define CPUDOZE                 CPUDOZEbits.value
+
+#endif	/* HOST_XC_H */
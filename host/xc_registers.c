@@ -0,0 +1,129 @@
+/**
+ * 
+ * File:                xc_registers.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              Linux host (gcc), emulating the PIC18F47Q10
+
+ * Description:
+ * ------------
+ * This module defines the special function registers declared by the host
+ * stand-in of xc.h. They are zero after start-up, i.e. the reset values
+ * the drivers depend on have to be set by the emulators.
+ * 
+ * The accessors of port D let an emulator sample the pins and drive the
+ * inputs, see setHostPortdHooks().
+ * 
+*/
+
+
+#include <xc.h>
+
+// MSSP1
+volatile uint16_t SSP1BUF;
+volatile uint8_t SSP1ADD;
+volatile SSP1STATbits_t SSP1STATbits;
+volatile SSP1CON1bits_t SSP1CON1bits;
+volatile SSP1CON2bits_t SSP1CON2bits;
+
+// MSSP2
+volatile uint16_t SSP2BUF;
+volatile uint8_t SSP2ADD;
+volatile SSP2STATbits_t SSP2STATbits;
+volatile SSP2CON1bits_t SSP2CON1bits;
+volatile SSP2CON2bits_t SSP2CON2bits;
+
+// Interrupts
+volatile PIR3bits_t PIR3bits;
+volatile PIE3bits_t PIE3bits;
+volatile PIE4bits_t hostPie4bits; // accessed by pollHostPie4bits()
+
+// Port B
+volatile LATBbits_t LATBbits;
+volatile TRISBbits_t TRISBbits;
+volatile uint8_t RB1PPS;
+volatile uint8_t RB2PPS;
+
+// Port C
+volatile LATCbits_t LATCbits;
+volatile TRISCbits_t TRISCbits;
+volatile uint8_t RC3PPS;
+volatile uint8_t RC4PPS;
+
+// Port D
+volatile LATDbits_t hostLatdbits; // accessed by accessHostLatdbits()
+volatile TRISDbits_t TRISDbits;
+
+// CPU doze control
+volatile CPUDOZEbits_t CPUDOZEbits;
+
+// Hooks of the emulator connected to port D
+static void (*portdSampleHook)(void);
+static uint8_t (*portdReadHook)(void);
+
+
+/******************************************************************************* 
+ * Function to set the hooks of port D
+ ******************************************************************************/
+/*
+ * @brief This function connects an emulator to port D. The sample hook is
+ * invoked before each access of LATD and PORTD, the read hook returns the
+ * level driven by the emulator, which is read from the input pins.
+ * 
+ * @param sample hook, read hook; NULL to disconnect
+ * 
+ * @return void
+ * 
+*/
+void setHostPortdHooks(void (*sample)(void), uint8_t (*read)(void)) {
+    
+    portdSampleHook = sample;
+    portdReadHook = read;
+}
+
+
+/******************************************************************************* 
+ * Function to access LATD
+ ******************************************************************************/
+/*
+ * @brief This function backs the LATDbits macro of xc.h. It lets the emulator
+ * sample the pins before the firmware reads or writes the latch.
+ * 
+ * @param None
+ * 
+ * @return pointer to the LATD register
+ * 
+*/
+volatile LATDbits_t *accessHostLatdbits(void) {
+    
+    if (portdSampleHook)
+        portdSampleHook();
+
+    return &hostLatdbits;
+}
+
+
+/******************************************************************************* 
+ * Function to read PORTD
+ ******************************************************************************/
+/*
+ * @brief This function backs the PORTD macro of xc.h. Output pins read the
+ * latch, input pins the level driven by the emulator, or 0 without one.
+ * 
+ * @param None
+ * 
+ * @return level of the pins (uint8_t)
+ * 
+*/
+uint8_t readHostPortd(void) {
+    
+    uint8_t inputs = 0;
+    
+    if (portdSampleHook)
+        portdSampleHook();
+    if (portdReadHook)
+        inputs = portdReadHook();
+
+    return (hostLatdbits.value & ~TRISDbits.value) 
+            | (inputs & TRISDbits.value);
+}
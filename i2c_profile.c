@@ -0,0 +1,256 @@
+/**
+ * 
+ * File:                i2c_profile.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+
+ * Description:
+ * ------------
+ * This module contains the I2C2 bus profiler. Operations are accumulated
+ * per call site; the wait times are sorted into a histogram of logarithmic
+ * bins, i.e. bin 0 counts waits below 128 us, bin n waits from 2^(6+n) to
+ * 2^(7+n) us and the last bin all longer waits.
+ * 
+ * Operations are recorded by the main loop and, for queued transfers, by the
+ * MSSP2 interrupt. Since the simple master doesn't run while a queued
+ * transfer holds the bus, both don't record at the same time.
+*/
+
+
+#include <string.h>
+#include "i2c_profile.h"
+
+#if I2C_PROFILE_ENABLED
+
+// Local variables
+static I2C_SITE_PROFILE siteProfiles[I2C_SITE_COUNT];
+static I2C_CALL_SITE currentSite;
+
+static const char *const siteNames[I2C_SITE_COUNT] = {
+    "other",
+    "bmp180 chip-id",
+    "bmp180 calib",
+    "bmp180 start",
+    "bmp180 poll",
+    "bmp180 result",
+    "queue"
+};
+
+// Local function prototypes
+static uint8_t getHistogramBin(uint16_t waitTime);
+
+
+/******************************************************************************* 
+ * Function to reset the I2C profile
+ ******************************************************************************/
+/*
+ * @brief This function clears the profiles of all call sites.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void resetI2cProfile(void) {
+    
+    memset(siteProfiles, 0, sizeof(siteProfiles));
+    for (uint8_t i = 0; i < I2C_SITE_COUNT; i++)
+        siteProfiles[i].minWait = 0xFFFF;
+    currentSite = I2C_SITE_OTHER;
+}
+
+
+/******************************************************************************* 
+ * Function to set the call site of the next I2C operation
+ ******************************************************************************/
+/*
+ * @brief This function assigns the next operation of the I2C2 simple master
+ * to the given call site. Use I2C_PROFILE_SITE() to compile it out along with
+ * the profiler.
+ * 
+ * @param call site (I2C_CALL_SITE)
+ * 
+ * @return void
+ * 
+*/
+void setI2cCallSite(I2C_CALL_SITE site) {
+    
+    currentSite = site;
+}
+
+
+/******************************************************************************* 
+ * Function to get the call site of the next I2C operation
+ ******************************************************************************/
+/*
+ * @brief This function returns the call site set by setI2cCallSite() and
+ * resets it, so that an operation without a call site is profiled as other.
+ * 
+ * @param None
+ * 
+ * @return call site (I2C_CALL_SITE)
+ * 
+*/
+I2C_CALL_SITE getI2cCallSite(void) {
+    
+    I2C_CALL_SITE site = currentSite;
+
+    currentSite = I2C_SITE_OTHER;
+
+    return site;
+}
+
+
+/******************************************************************************* 
+ * Function to record an I2C operation
+ ******************************************************************************/
+/*
+ * @brief This function adds an operation including its retries to the
+ * profile of the call site.
+ * 
+ * @param call site (I2C_CALL_SITE), pointer to the operation record
+ * 
+ * @return void
+ * 
+*/
+void recordI2cOperation(I2C_CALL_SITE site,
+        const I2C_OPERATION_RECORD *pRecord) {
+
+    I2C_SITE_PROFILE *pProfile;
+
+    if (site >= I2C_SITE_COUNT)
+        site = I2C_SITE_OTHER;
+    pProfile = &siteProfiles[site];
+
+    pProfile->transactions++;
+    pProfile->bytes += pRecord->bytes;
+    pProfile->nacks += pRecord->nacks;
+    pProfile->collisions += pRecord->collisions;
+    pProfile->timeouts += pRecord->timeouts;
+    pProfile->retries += pRecord->retries;
+    if (pRecord->waitTime < pProfile->minWait)
+        pProfile->minWait = pRecord->waitTime;
+    if (pRecord->waitTime > pProfile->maxWait)
+        pProfile->maxWait = pRecord->waitTime;
+    pProfile->totalWait += pRecord->waitTime;
+    pProfile->histogram[getHistogramBin(pRecord->waitTime)]++;
+}
+
+
+/******************************************************************************* 
+ * Function to get the profile of a call site
+ ******************************************************************************/
+/*
+ * @brief This function returns the profile of a call site collected since
+ * the last reset.
+ * 
+ * @param call site (I2C_CALL_SITE)
+ * 
+ * @return pointer to the profile
+ * 
+*/
+const I2C_SITE_PROFILE *getI2cSiteProfile(I2C_CALL_SITE site) {
+    
+    if (site >= I2C_SITE_COUNT)
+        site = I2C_SITE_OTHER;
+
+    return &siteProfiles[site];
+}
+
+
+/******************************************************************************* 
+ * Function to print the I2C profile
+ ******************************************************************************/
+/*
+ * @brief This function prints the profile of each call site with at least
+ * one operation over EUSART1, followed by the histogram of its wait times.
+ * Printing blocks for up to 100 ms at 115200 baud, so it is done on request.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void printI2cProfile(void) {
+    
+    const I2C_SITE_PROFILE *pProfile;
+
+    printf("I2C PROFILE - site: transactions, bytes, nack, bcl, tmo, retry, "
+            "wait min/mean/max [us]\n");
+    for (uint8_t i = 0; i < I2C_SITE_COUNT; i++) {
+        pProfile = &siteProfiles[i];
+        if (pProfile->transactions == 0)
+            continue;
+        printf("%s: %u, %lu, %u, %u, %u, %u, %u/%lu/%u\n", siteNames[i],
+                pProfile->transactions, (unsigned long) pProfile->bytes,
+                pProfile->nacks, pProfile->collisions, pProfile->timeouts,
+                pProfile->retries, pProfile->minWait,
+                (unsigned long) (pProfile->totalWait
+                    / pProfile->transactions),
+                pProfile->maxWait);
+        printf("  histogram:");
+        for (uint8_t bin = 0; bin < I2C_PROFILE_HISTOGRAM_BINS; bin++)
+            printf(" %u", pProfile->histogram[bin]);
+        printf("\n");
+    }
+    printf("----------------------------------\n");
+}
+
+
+/******************************************************************************* 
+ * Function to handle a profile command
+ ******************************************************************************/
+/*
+ * @brief This function prints the profile on I2C_PROFILE_CMD_PRINT and
+ * clears it on I2C_PROFILE_CMD_RESET.
+ * 
+ * @param command received over EUSART1 (uint8_t)
+ * 
+ * @return True if the command has been handled
+ * 
+*/
+_Bool handleI2cProfileCommand(uint8_t command) {
+    
+    switch (command) {
+        case I2C_PROFILE_CMD_PRINT:
+            printI2cProfile();
+            return true;
+        case I2C_PROFILE_CMD_RESET:
+            resetI2cProfile();
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to get the histogram bin of a wait time
+ ******************************************************************************/
+/*
+ * @brief This function returns the logarithmic bin of a wait time, i.e. the
+ * number of significant bits above I2C_PROFILE_HISTOGRAM_SHIFT.
+ * 
+ * @param wait time in us (uint16_t)
+ * 
+ * @return index of the bin (uint8_t)
+ * 
+*/
+static uint8_t getHistogramBin(uint16_t waitTime) {
+    
+    uint8_t bin = 0;
+
+    waitTime >>= I2C_PROFILE_HISTOGRAM_SHIFT;
+    while (waitTime != 0 && bin < I2C_PROFILE_HISTOGRAM_BINS - 1) {
+        waitTime >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+#endif
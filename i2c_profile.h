@@ -0,0 +1,97 @@
+/*
+ * File:                i2c_profile.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+
+ * Description:
+ * ------------
+ * This module profiles the utilisation of the I2C2 bus per call site. The
+ * I2C2 simple master and the transfer queue report each operation with its
+ * bytes, failures, retries and the time the caller has waited for it, which
+ * is measured with the microsecond counter of the tick module. The profile
+ * is printed over EUSART1 on request.
+ * 
+ */
+
+#ifndef I2C_PROFILE_H
+#define	I2C_PROFILE_H
+
+#include "mcc_generated_files/mcc.h"
+
+// The profiler is part of debug builds only; MPLAB X defines __DEBUG for them
+#ifdef __DEBUG
+    #define I2C_PROFILE_ENABLED     1
+#else
+    #define I2C_PROFILE_ENABLED     0
+#endif
+#define I2C_PROFILE_HISTOGRAM_BINS  8
+#define I2C_PROFILE_HISTOGRAM_SHIFT 7   // upper limit of the first bin 128 us
+
+// Commands received over EUSART1
+#define I2C_PROFILE_CMD_PRINT       'i'
+#define I2C_PROFILE_CMD_RESET       'I'
+
+// Call sites of I2C operations; the site is reset to OTHER after each one
+typedef enum {
+    I2C_SITE_OTHER,
+    I2C_SITE_BMP180_CHIP_ID,
+    I2C_SITE_BMP180_CALIBRATION,
+    I2C_SITE_BMP180_START,          // write of the control register
+    I2C_SITE_BMP180_POLL,           // read of the SCO bit
+    I2C_SITE_BMP180_RESULT,         // read of the result registers
+    I2C_SITE_QUEUE,                 // transfers of the I2C2 transfer queue
+    I2C_SITE_COUNT
+} I2C_CALL_SITE;
+
+// Result of one I2C operation including its retries
+typedef struct {
+    uint16_t bytes;                 // bytes clocked incl. address bytes
+    uint16_t waitTime;              // [us], saturated at 65535 us
+    uint8_t retries;
+    uint8_t nacks;
+    uint8_t collisions;
+    uint8_t timeouts;
+} I2C_OPERATION_RECORD;
+
+// Profile of a call site; the mean wait time is totalWait / transactions
+typedef struct {
+    uint16_t transactions;
+    uint32_t bytes;
+    uint16_t nacks;
+    uint16_t collisions;
+    uint16_t timeouts;
+    uint16_t retries;
+    uint16_t minWait;               // [us]
+    uint16_t maxWait;               // [us]
+    uint32_t totalWait;             // [us]
+    uint16_t histogram[I2C_PROFILE_HISTOGRAM_BINS]; // log2 bins of the wait
+} I2C_SITE_PROFILE;
+
+#if I2C_PROFILE_ENABLED
+    #define I2C_PROFILE_SITE(site)  setI2cCallSite(site)
+#else
+    #define I2C_PROFILE_SITE(site)
+#endif
+
+void resetI2cProfile(void);
+void setI2cCallSite(I2C_CALL_SITE site);
+I2C_CALL_SITE getI2cCallSite(void);
+void recordI2cOperation(I2C_CALL_SITE site,
+        const I2C_OPERATION_RECORD *pRecord);
+const I2C_SITE_PROFILE *getI2cSiteProfile(I2C_CALL_SITE site);
+void printI2cProfile(void);
+_Bool handleI2cProfileCommand(uint8_t command);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* I2C_PROFILE_H */
@@ -0,0 +1,330 @@
+/**
+ * 
+ * File:                i2c_queue.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the I2C2 transfer queue. The queue holds pointers to 
+ * transfer descriptors. The first transfer is started by the caller, each 
+ * following transfer is started by the operation complete handler of the 
+ * I2C2 master, which runs in the MSSP2 interrupt once the previous transfer 
+ * has released the bus.
+ * 
+ * Transfers are queued by the main loop only, which is the only writer of the
+ * head index. The tail index is advanced by startNextTransfer(), which runs
+ * in two contexts: in the main loop by serviceI2cQueue() and in the MSSP2
+ * interrupt by completeTransfer(). Both start a transfer only while
+ * pActiveTransfer is NULL, and only one context can find it NULL at a time:
+ * the main loop starts a transfer only if none is active, so no interrupt of
+ * the queue is pending, and the interrupt clears pActiveTransfer and starts
+ * the next transfer without being interrupted by the main loop. If a transfer
+ * times out, completeTransfer() runs in the main loop with SSP2IE masked by
+ * I2C2_CheckTimeout(). Hence the indices don't need to be protected.
+*/
+
+
+#include <string.h>
+#include "i2c_queue.h"
+#include "i2c_profile.h"
+#include "tick.h"
+
+// Local variables
+static I2C_TRANSFER *transferQueue[I2C_QUEUE_DEPTH];
+static volatile uint8_t queueHead;  // index of the next transfer to be queued
+static volatile uint8_t queueTail;  // index of the next transfer to be started
+static I2C_TRANSFER * volatile pActiveTransfer;
+static I2C_QUEUE_STATS queueStats;
+#if I2C_PROFILE_ENABLED
+static uint16_t transferStartTime; // microsecond counter at the start
+#endif
+
+// Local function prototypes
+static void startNextTransfer(void);
+static void completeTransfer(void);
+static i2c2_operations_t restartReadHandler(void *pTransfer);
+static i2c2_operations_t nackHandler(void *pTransfer);
+
+
+/******************************************************************************* 
+ * Function to initialise the I2C transfer queue
+ ******************************************************************************/
+/*
+ * @brief This function empties the queue, resets the statistics and registers
+ * the operation complete handler with the I2C2 master.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void initI2cQueue(void) {
+    
+    queueHead = 0;
+    queueTail = 0;
+    pActiveTransfer = 0;
+    memset(&queueStats, 0, sizeof(queueStats));
+    I2C2_SetOperationCompleteHandler(&completeTransfer);
+}
+
+
+/******************************************************************************* 
+ * Function to queue an I2C transfer
+ ******************************************************************************/
+/*
+ * @brief This function appends a transfer to the queue and starts it right 
+ * away if the bus is idle. The descriptor and its data buffers have to 
+ * remain valid until the status changes to I2C_TRANSFER_DONE or 
+ * I2C_TRANSFER_FAILED. The lengths have to be at least one byte.
+ * 
+ * @param pTransfer -> pointer to the transfer descriptor
+ * 
+ * @return the result of queuing the transfer
+ * @retval 0 -> success
+ * @retval 1 -> failed; the queue is full
+ * 
+*/
+uint8_t queueI2cTransfer(I2C_TRANSFER *pTransfer) {
+    
+    uint8_t nextHead = (queueHead + 1) & (I2C_QUEUE_DEPTH - 1);
+    uint8_t depth;
+    
+    if (nextHead == queueTail) {
+        queueStats.rejected++;
+        return 1; // Error 1; queue is full
+    }
+    
+    pTransfer->status = I2C_TRANSFER_QUEUED;
+    pTransfer->queuedTick = getTickMs();
+    transferQueue[queueHead] = pTransfer;
+    queueHead = nextHead;
+    
+    depth = getI2cQueueDepth();
+    if (depth > queueStats.maxDepth)
+        queueStats.maxDepth = depth;
+    
+    serviceI2cQueue();
+    
+    return 0;
+}
+
+
+/******************************************************************************* 
+ * Function to service the I2C transfer queue
+ ******************************************************************************/
+/*
+ * @brief This function starts the next transfer if no queued transfer is
+ * active. This is only required if the bus was occupied by one of the 
+ * blocking functions of the I2C simple master while transfers were queued,
+ * hence it should be invoked from the main loop. Moreover, an active transfer
+ * which has exceeded the I2C2 timeout is aborted and fails, so that a stuck
+ * bus can't block the queue.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void serviceI2cQueue(void) {
+    
+    if (pActiveTransfer != 0)
+        (void) I2C2_CheckTimeout(); // completes the transfer if aborted
+    if (pActiveTransfer == 0 && queueTail != queueHead)
+        startNextTransfer();
+}
+
+
+/******************************************************************************* 
+ * Function to get the number of transfers waiting in the queue
+ ******************************************************************************/
+/*
+ * @brief This function returns the number of queued transfers, which have
+ * not been started yet.
+ * 
+ * @param None
+ * 
+ * @return number of waiting transfers (uint8_t)
+ * 
+*/
+uint8_t getI2cQueueDepth(void) {
+    
+    return (queueHead - queueTail) & (I2C_QUEUE_DEPTH - 1);
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics of the I2C transfer queue
+ ******************************************************************************/
+/*
+ * @brief This function returns the statistics collected since initialising
+ * the queue. The mean wait time and latency are given by the totals divided
+ * by the number of completed transfers.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics
+ * 
+*/
+const I2C_QUEUE_STATS *getI2cQueueStats(void) {
+    
+    return &queueStats;
+}
+
+
+/******************************************************************************* 
+ * Function to start the oldest queued transfer
+ ******************************************************************************/
+/*
+ * @brief This function opens the bus for the oldest queued transfer and 
+ * starts it. The transfer remains queued if the bus is in use by a blocking 
+ * function of the I2C simple master.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+static void startNextTransfer(void) {
+    
+    I2C_TRANSFER *pTransfer = transferQueue[queueTail];
+    uint16_t waitTime;
+    
+    if (I2C2_Open(pTransfer->address) != I2C2_NOERR)
+        return; // bus is in use; retried by serviceI2cQueue()
+    queueTail = (queueTail + 1) & (I2C_QUEUE_DEPTH - 1);
+    pActiveTransfer = pTransfer;
+    pTransfer->status = I2C_TRANSFER_ACTIVE;
+    
+    waitTime = getTickMs() - pTransfer->queuedTick;
+    if (waitTime > queueStats.maxWaitTime)
+        queueStats.maxWaitTime = waitTime;
+    queueStats.totalWaitTime += waitTime;
+#if I2C_PROFILE_ENABLED
+    transferStartTime = getTimerUs();
+#endif
+    
+    I2C2_SetAddressNackCallback(nackHandler, pTransfer);
+    I2C2_SetDataNackCallback(nackHandler, pTransfer);
+    switch (pTransfer->type) {
+        case I2C_TRANSFER_WRITE:
+            I2C2_SetBuffer(pTransfer->pWriteData, pTransfer->writeLength);
+            I2C2_MasterWrite();
+            break;
+        case I2C_TRANSFER_WRITE_READ:
+            I2C2_SetBuffer(pTransfer->pWriteData, pTransfer->writeLength);
+            I2C2_SetDataCompleteCallback(restartReadHandler, pTransfer);
+            I2C2_MasterWrite();
+            break;
+        case I2C_TRANSFER_READ:
+            I2C2_SetBuffer(pTransfer->pReadData, pTransfer->readLength);
+            I2C2_MasterRead();
+            break;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to complete the active transfer
+ ******************************************************************************/
+/*
+ * @brief This function is registered as operation complete handler of the 
+ * I2C2 master and thus runs in the MSSP2 interrupt, or in the main loop if
+ * the transfer was aborted by the timeout. It releases the bus, reports the
+ * completion of the active transfer to its callback and starts the next 
+ * queued transfer.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+static void completeTransfer(void) {
+    
+    I2C_TRANSFER *pTransfer = pActiveTransfer;
+    uint16_t latency;
+    i2c2_error_t error;
+#if I2C_PROFILE_ENABLED
+    I2C_OPERATION_RECORD record = {0};
+#endif
+    
+    if (pTransfer == 0)
+        return; // operation of a blocking function of the I2C simple master
+    
+    error = I2C2_Close();
+    if (error != I2C2_NOERR)
+        pTransfer->status = I2C_TRANSFER_FAILED; // NACK, timeout or collision
+    pActiveTransfer = 0;
+#if I2C_PROFILE_ENABLED
+    record.bytes = I2C2_GetByteCount();
+    record.waitTime = getTimerUs() - transferStartTime;
+    record.nacks = (error == I2C2_FAIL);
+    record.collisions = (error == I2C2_COLLISION);
+    record.timeouts = (error == I2C2_TIMEDOUT);
+    recordI2cOperation(I2C_SITE_QUEUE, &record);
+#endif
+    
+    if (pTransfer->status == I2C_TRANSFER_ACTIVE) {
+        pTransfer->status = I2C_TRANSFER_DONE;
+    } else {
+        queueStats.failures++;
+    }
+    queueStats.transfers++;
+    latency = getTickMs() - pTransfer->queuedTick;
+    if (latency > queueStats.maxLatency)
+        queueStats.maxLatency = latency;
+    queueStats.totalLatency += latency;
+    
+    if (pTransfer->callback)
+        pTransfer->callback(pTransfer);
+    
+    if (queueTail != queueHead)
+        startNextTransfer();
+}
+
+
+/******************************************************************************* 
+ * Function to continue a write-then-read transfer with the read
+ ******************************************************************************/
+/*
+ * @brief This data complete callback of the I2C2 master switches to the read
+ * buffer once the write data has been sent and requests a repeated start.
+ * 
+ * @param pTransfer -> pointer to the transfer descriptor
+ * 
+ * @return I2C2_RESTART_READ
+ * 
+*/
+static i2c2_operations_t restartReadHandler(void *pTransfer) {
+    
+    I2C_TRANSFER *pThis = pTransfer;
+    
+    I2C2_SetBuffer(pThis->pReadData, pThis->readLength);
+    I2C2_SetDataCompleteCallback(NULL, NULL);
+    
+    return I2C2_RESTART_READ;
+}
+
+
+/******************************************************************************* 
+ * Function to handle a missing acknowledge
+ ******************************************************************************/
+/*
+ * @brief This address and data NACK callback of the I2C2 master marks the 
+ * transfer as failed and stops it.
+ * 
+ * @param pTransfer -> pointer to the transfer descriptor
+ * 
+ * @return I2C2_STOP
+ * 
+*/
+static i2c2_operations_t nackHandler(void *pTransfer) {
+    
+    ((I2C_TRANSFER *) pTransfer)->status = I2C_TRANSFER_FAILED;
+    
+    return I2C2_STOP;
+}
@@ -0,0 +1,91 @@
+/* 
+ * File:                i2c_queue.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module implements a queue of I2C2 transfers on top of the interrupt 
+ * driven MCC I2C2 master. Transfers are described by descriptors owned by
+ * the caller, are started one after another from the MSSP2 interrupt and 
+ * report their completion by a callback. Thus, the application can queue
+ * sensor reads and carry on instead of waiting for the bus. The firmware
+ * doesn't queue any transfers yet, the BMP180 driver still reads through the
+ * blocking simple master. Hence, the queue is not initialised and serviced
+ * by the main loop.
+ *    
+ */
+
+#ifndef I2C_QUEUE_H
+#define	I2C_QUEUE_H
+
+#include "mcc_generated_files/mcc.h"
+
+#define I2C_QUEUE_DEPTH                 8   // has to be a power of two
+
+// Types of I2C transfers
+typedef enum {
+    I2C_TRANSFER_WRITE,         // write writeLength bytes
+    I2C_TRANSFER_WRITE_READ,    // write, repeated start, read readLength bytes
+    I2C_TRANSFER_READ           // read readLength bytes
+} I2C_TRANSFER_TYPE;
+
+// Status of an I2C transfer
+typedef enum {
+    I2C_TRANSFER_IDLE,
+    I2C_TRANSFER_QUEUED,
+    I2C_TRANSFER_ACTIVE,
+    I2C_TRANSFER_DONE,
+    I2C_TRANSFER_FAILED         // not acknowledged, collision or timeout
+} I2C_TRANSFER_STATUS;
+
+typedef struct i2c_transfer_t I2C_TRANSFER;
+
+// Completion callback, invoked from the interrupt context
+typedef void (*i2cTransferCallback)(I2C_TRANSFER *pTransfer);
+
+// Descriptor of an I2C transfer; has to remain valid until completion
+struct i2c_transfer_t {
+    I2C_TRANSFER_TYPE type;
+    uint8_t address;
+    uint8_t *pWriteData;
+    uint8_t writeLength;
+    uint8_t *pReadData;
+    uint8_t readLength;
+    i2cTransferCallback callback;   // optional, may be NULL
+    void *pContext;                 // for use by the callback
+    volatile I2C_TRANSFER_STATUS status;
+    uint16_t queuedTick;
+};
+
+// Statistics of the queue; latency and wait time in ms
+typedef struct {
+    uint16_t transfers;         // completed transfers
+    uint16_t failures;          // failed transfers
+    uint16_t rejected;          // transfers not queued due to a full queue
+    uint8_t maxDepth;           // max. number of transfers waiting
+    uint16_t maxWaitTime;       // max. time from queuing to the start
+    uint32_t totalWaitTime;
+    uint16_t maxLatency;        // max. time from queuing to the completion
+    uint32_t totalLatency;
+} I2C_QUEUE_STATS;
+
+void initI2cQueue(void);
+uint8_t queueI2cTransfer(I2C_TRANSFER *pTransfer);
+void serviceI2cQueue(void);
+uint8_t getI2cQueueDepth(void);
+const I2C_QUEUE_STATS *getI2cQueueStats(void);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* I2C_QUEUE_H */
@@ -18,6 +18,9 @@
  * controller is realised via a 4-bit interface, thus transmitting one data byte
  * as two sequential 4-bit transfers. For the 4-bit interface, only four bus 
  * lines (DB4 to DB7) are used for transfer.
+ * 
+ * After initialisation, the bytes are queued and sent by the timer 6 interrupt
+ * if LCD_USE_QUEUE is set, so that printing doesn't wait for the display.
 */
 
 #include "mcc_generated_files/mcc.h"
@@ -30,8 +33,77 @@ static void LCD_ReverseString(char str[], uint16_t length);
 static void LCD_ReadDataNibble(uint8_t *pReturnValue);
 static uint8_t LCD_ReadDataByte(void);
 static _Bool LCD_IsIdle(void);
+static void LCD_TrackWrite(char input, LCD_REG_TYPE regType);
+static void LCD_StepAddress(_Bool increment);
+static uint8_t LCD_FormatInteger(int16_t number, uint8_t intBase, 
+        char *buffer);
+static _Bool LCD_IsCellChanged(uint8_t line, uint8_t column);
+static void LCD_Enqueue(char input, LCD_REG_TYPE regType);
+static void LCD_PulseNibble(uint8_t nibble);
+
+// DDRAM addresses and instructions used to mirror the display
+#define LCD_DDRAM_SECOND_LINE   0x40
+#define LCD_DDRAM_LINE_LENGTH   40
+#define LCD_CMD_SET_DDRAM       0x80
+#define LCD_CMD_SET_CGRAM       0x40
+#define LCD_CMD_FUNCTION_SET    0x20
+#define LCD_CMD_SHIFT           0x10
+#define LCD_CMD_SHIFT_DISPLAY   0x08
+#define LCD_CMD_SHIFT_RIGHT     0x04
+#define LCD_CMD_DISPLAY_CTRL    0x08
+#define LCD_CMD_ENTRY_MODE      0x04
+#define LCD_CMD_RETURN_HOME     0x02
+#define LCD_CMD_CLEAR           0x01
+
+// Writes the nibble to DB4 to DB7
+#if LCD_DATA_MASKED_WRITE
+#define LCD_SET_DATA_NIBBLE(nibble) (LCD_DATA_LAT = (LCD_DATA_LAT \
+        & DATA_TRIS_OUTPUT_PATTERN) | (((nibble) << LCD_DATA_SHIFT) \
+        & DATA_PORT_INPUT_PATTERN))
+#else
+#define LCD_SET_DATA_NIBBLE(nibble) do { \
+        LCD_DB4 = ((nibble) & 0x01) ? 1 : 0; \
+        LCD_DB5 = ((nibble) & 0x02) ? 1 : 0; \
+        LCD_DB6 = ((nibble) & 0x04) ? 1 : 0; \
+        LCD_DB7 = ((nibble) & 0x08) ? 1 : 0; \
+    } while (0)
+#endif
+
+// Timer 6 periods to wait after clear display and return home
+#define LCD_LONG_EXEC_TICKS     ((LCD_LONG_EXEC_TIME_US + LCD_QUEUE_TICK_US - 1)\
+        / LCD_QUEUE_TICK_US)
+
+// Entry of the command queue
+typedef struct {
+    char value;
+    LCD_REG_TYPE regType;
+} LCD_QUEUE_ENTRY;
 
 static _Bool checkBusyBit;
+static _Bool isQueueEnabled;
+
+/* Command queue, written by LCD_Enqueue() and drained by LCD_TimerISR(). Each
+ * index is written by one side only, thus no lock is needed. */
+static LCD_QUEUE_ENTRY queue[LCD_QUEUE_SIZE];
+static volatile uint8_t queueHead;
+static volatile uint8_t queueTail;
+static uint8_t holdTicks;
+
+/* Mirror of the visible DDRAM cells and the address counter of the display,
+ * which follow every byte written. The entry mode set by LCD_Init() is 
+ * assumed, i.e. the address increments without shifting the display. */
+static char displayedCells[LCD_FRAME_LINES][LCD_FRAME_COLUMNS];
+static _Bool isMirrorValid;
+static _Bool isCgramSelected;
+static uint8_t ddramAddress;
+static uint8_t displayShift;
+
+// Shadow framebuffer the application draws into
+static char frameCells[LCD_FRAME_LINES][LCD_FRAME_COLUMNS];
+static uint8_t frameLine;
+static uint8_t frameColumn;
+
+static LCD_BUS_STATS busStats;
 
 
 /******************************************************************************* 
@@ -53,16 +125,12 @@ static _Bool checkBusyBit;
 */
 static void LCD_TransferNibbleBits(char input) {
     
-    // Use the ternary operator to decode the nibble bits to be sent
-    LCD_DB4 = (input & 0x01) ? 1 : 0;
-    LCD_DB5 = (input & 0x02) ? 1 : 0;
-    LCD_DB6 = (input & 0x04) ? 1 : 0;
-    LCD_DB7 = (input & 0x08) ? 1 : 0;
+    LCD_SET_DATA_NIBBLE((uint8_t) input & 0x0F);
 
     LCD_EN = 1; // Start writing data
-    __delay_us(RW_TRIGGER_DELAY);
+    __delay_us(LCD_EN_HIGH_US);
     LCD_EN = 0;
-    __delay_us(RW_TRIGGER_DELAY);
+    __delay_us(LCD_EN_LOW_US);
     
 }
 
@@ -82,17 +150,150 @@ static void LCD_TransferNibbleBits(char input) {
 */
 static void LCD_Write(char input, LCD_REG_TYPE regType) {
     
-    // RS = 0 --> instruction register, RS = 1 --> data register
-    LCD_RS = (regType == LCD_REG_CMD) ? 0 : 1; 
-    __delay_us(100);
+    if (isQueueEnabled) {
+        LCD_Enqueue(input, regType);
+        LCD_TrackWrite(input, regType);
+        return;
+    }
     
     while (!LCD_IsIdle()); // wait while LCD is still busy
+    
+    // RS = 0 --> instruction register, RS = 1 --> data register
+    LCD_RS = (regType == LCD_REG_CMD) ? 0 : 1; 
     LCD_TransferNibbleBits((input & 0xF0) >> 4); // transmit upper nibble first
     LCD_TransferNibbleBits(input & 0x0F); // transmit lower nibble second
+    LCD_TrackWrite(input, regType);
      
 }
 
 
+/******************************************************************************* 
+ * Function to append a byte to the command queue
+ ******************************************************************************/
+/*
+ * @brief This routine stores the byte in the queue and enables the timer 6
+ * interrupt, which sends it. If the queue is full, it waits for the ISR to
+ * free an entry.
+ * 
+ * @param input (char), register type
+ * 
+ * @return void 
+ * 
+*/
+static void LCD_Enqueue(char input, LCD_REG_TYPE regType) {
+    
+    uint8_t next = (queueHead + 1) & (LCD_QUEUE_SIZE - 1);
+    uint8_t depth;
+    
+    if (next == queueTail) {
+        busStats.queueStalls++;
+        while (next == queueTail)
+            PIE4bits.TMR6IE = 1; // keep draining
+    }
+    
+    queue[queueHead].value = input;
+    queue[queueHead].regType = regType;
+    queueHead = next; // publish the entry to the ISR
+    PIE4bits.TMR6IE = 1;
+    
+    depth = (queueHead - queueTail) & (LCD_QUEUE_SIZE - 1);
+    if (depth > busStats.queuePeak)
+        busStats.queuePeak = depth;
+}
+
+
+/******************************************************************************* 
+ * Function to mirror a byte written to the LCD
+ ******************************************************************************/
+/*
+ * @brief This routine counts the byte and applies it to the mirror of the 
+ * display: data bytes are stored at the address counter, which is then 
+ * incremented, and the instructions affecting the address counter, the 
+ * display shift or the DDRAM are decoded. Data written to CGRAM doesn't
+ * change the mirror.
+ * 
+ * @param input (char), register type
+ * 
+ * @return void 
+ * 
+*/
+static void LCD_TrackWrite(char input, LCD_REG_TYPE regType) {
+    
+    uint8_t value = (uint8_t) input;
+    uint8_t line, column;
+    
+    if (regType == LCD_REG_DATA) {
+        busStats.dataBytes++;
+        if (isCgramSelected)
+            return;
+        line = (ddramAddress >= LCD_DDRAM_SECOND_LINE) ? 1 : 0;
+        column = ddramAddress - (line ? LCD_DDRAM_SECOND_LINE : 0);
+        if (column < LCD_FRAME_COLUMNS)
+            displayedCells[line][column] = input;
+        LCD_StepAddress(true);
+        return;
+    }
+    
+    busStats.commandBytes++;
+    if (value & LCD_CMD_SET_DDRAM) {
+        ddramAddress = value & ~LCD_CMD_SET_DDRAM;
+        isCgramSelected = false;
+    } else if (value & LCD_CMD_SET_CGRAM) {
+        isCgramSelected = true;
+    } else if (value & LCD_CMD_FUNCTION_SET) {
+        ; // doesn't affect the mirror
+    } else if (value & LCD_CMD_SHIFT) {
+        if (!(value & LCD_CMD_SHIFT_DISPLAY))
+            LCD_StepAddress(value & LCD_CMD_SHIFT_RIGHT);
+        else if (value & LCD_CMD_SHIFT_RIGHT)
+            displayShift = (displayShift + 1) % LCD_DDRAM_LINE_LENGTH;
+        else
+            displayShift = (displayShift + LCD_DDRAM_LINE_LENGTH - 1) 
+                    % LCD_DDRAM_LINE_LENGTH;
+    } else if (value & (LCD_CMD_DISPLAY_CTRL | LCD_CMD_ENTRY_MODE)) {
+        ; // doesn't affect the mirror
+    } else if (value & LCD_CMD_RETURN_HOME) {
+        ddramAddress = 0;
+        displayShift = 0;
+        isCgramSelected = false;
+    } else if (value & LCD_CMD_CLEAR) {
+        memset(displayedCells, ' ', sizeof(displayedCells));
+        isMirrorValid = true;
+        ddramAddress = 0;
+        displayShift = 0;
+        isCgramSelected = false;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to step the mirrored address counter
+ ******************************************************************************/
+/*
+ * @brief In two-line mode, the DDRAM addresses 0x27 and 0x40 as well as 0x67 
+ * and 0x00 are adjacent.
+ * 
+ * @param True to increment, false to decrement
+ * 
+ * @return void 
+ * 
+*/
+static void LCD_StepAddress(_Bool increment) {
+    
+    uint8_t line = (ddramAddress >= LCD_DDRAM_SECOND_LINE) ? 1 : 0;
+    uint8_t column = ddramAddress - (line ? LCD_DDRAM_SECOND_LINE : 0);
+    
+    if (increment && ++column >= LCD_DDRAM_LINE_LENGTH) {
+        column = 0;
+        line ^= 1;
+    } else if (!increment && column-- == 0) {
+        column = LCD_DDRAM_LINE_LENGTH - 1;
+        line ^= 1;
+    }
+    ddramAddress = (line ? LCD_DDRAM_SECOND_LINE : 0) + column;
+}
+
+
 /******************************************************************************* 
  * Function to check whether LCD is busy
  ******************************************************************************/
@@ -108,11 +309,18 @@ static void LCD_Write(char input, LCD_REG_TYPE regType) {
 */
 static _Bool LCD_IsIdle(void) {
 
-    const uint16_t MAX_RETRY_COUNT = 500;
+    const uint16_t MAX_RETRY_COUNT = 1000; // about 5 ms
     uint16_t i;
     uint8_t receivedData;
     
-    if (CHECK_BUSY_BIT) {
+    if (isQueueEnabled) {
+        return true; // the ISR paces the queued bytes, the bus is its own
+    } else if (checkBusyBit) {
+        // Switch the bus to reading the busy flag once for all retries
+        LCD_RS = 0; // Select instruction register
+        LCD_RW = 1; // Select read mode
+        LCD_DATA_TRIS |= DATA_PORT_INPUT_PATTERN; // set data lines to input
+        
         /* To avoid a hangup in case of the LCD not responding, abort waiting
          * for the busy check bit after a certain number of retry cycles. 
          * In this case we'll still continue, just a bit slower than normally */
@@ -121,6 +329,9 @@ static _Bool LCD_IsIdle(void) {
             if ((receivedData & 0x80) == 0) // check busy bit (DB7)
                 break;
         }
+        
+        LCD_DATA_TRIS &= DATA_TRIS_OUTPUT_PATTERN; // set data lines to output
+        LCD_RW = 0; // Return to default mode of writing data to the LCD
     } else {
         __delay_ms(1); // If busy bit isn't enabled then wait a little bit
     } 
@@ -142,6 +353,13 @@ static _Bool LCD_IsIdle(void) {
 */
 void LCD_Init(void) {
 
+    // Discard queued bytes and initialise the display directly
+    PIE4bits.TMR6IE = 0;
+    isQueueEnabled = false;
+    checkBusyBit = false;
+    queueHead = queueTail;
+    holdTicks = 0;
+    
     LATD = LATD & 0x0F; // Reset data bit interface pins
     LCD_RS = 0; // Select instruction register
     LCD_RW = 0; // Select write mode
@@ -163,6 +381,7 @@ void LCD_Init(void) {
     LCD_Write((0b00001000 | 1 << DISPLAY_CTRL_D_POS | 0 << DISPLAY_CTRL_C_POS |
             0 << DISPLAY_CTRL_B_POS), LCD_REG_CMD);
     LCD_Clear();
+    LCD_FrameClear();
     /* Entry mode set:
      * (I/D = 1) Increment DDRAM address by 1; moves the cursor to the right,
      * (S = 0) no display shift */
@@ -171,6 +390,9 @@ void LCD_Init(void) {
     
     /* Now at this point, the busy bit DB7 can be checked */ 
     checkBusyBit = CHECK_BUSY_BIT;
+    
+    TMR6_SetInterruptHandler(&LCD_TimerISR);
+    isQueueEnabled = LCD_USE_QUEUE;
 }
 
 
@@ -188,9 +410,9 @@ void LCD_Init(void) {
 */
 void LCD_Clear(void) {
     
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(0x01, LCD_REG_CMD);
-    __delay_ms(5);
+    if (!isQueueEnabled && !checkBusyBit)
+        __delay_ms(5);
 }
 
 
@@ -207,7 +429,6 @@ void LCD_Clear(void) {
 */
 void LCD_PrintCharacter(char input) {
   
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(input, LCD_REG_DATA);
 }
 
@@ -265,9 +486,7 @@ void LCD_SetCursor(LCD_CURSOR_LINE line, uint8_t offset) {
         default:
             ; // line not defined
         }
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(value, LCD_REG_CMD);
-    __delay_ms(5);
 }
 
 /******************************************************************************* 
@@ -287,7 +506,6 @@ void LCD_SetCursor(LCD_CURSOR_LINE line, uint8_t offset) {
 */
 void LCD_ShiftDisplayRight(void) {
     
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(0x1C, LCD_REG_CMD);
 }
 
@@ -309,7 +527,6 @@ void LCD_ShiftDisplayRight(void) {
 */
 void LCD_ShiftDisplayLeft(void) {
     
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(0x18, LCD_REG_CMD);    
 }
 
@@ -328,7 +545,6 @@ void LCD_ShiftDisplayLeft(void) {
 */
 void LCD_ShiftCursorRight(void) {
     
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(0x14, LCD_REG_CMD);
 }
 
@@ -347,7 +563,6 @@ void LCD_ShiftCursorRight(void) {
 */
 void LCD_ShiftCursorLeft(void) {
     
-    while (!LCD_IsIdle()); // wait while LCD is still busy
     LCD_Write(0x10, LCD_REG_CMD);
     return;
 }
@@ -367,6 +582,28 @@ void LCD_ShiftCursorLeft(void) {
 void LCD_PrintInteger(int16_t number, uint8_t intBase) {
 
     char buffer[20] = "";
+    
+    (void) LCD_FormatInteger(number, intBase, buffer);
+    LCD_PrintString(buffer); // Print the string on the display   
+}
+
+
+/******************************************************************************* 
+ * Function to convert an integer value into a string
+ ******************************************************************************/
+/*
+ * @brief This function converts an integer value into a null terminated 
+ * string. Negative numbers have a sign for the base 10 only.
+ * 
+ * @param number, base (decimal, hexadecimal, octal), buffer of at least 
+ * 18 characters
+ * 
+ * @return length of the string (uint8_t)
+ * 
+*/
+static uint8_t LCD_FormatInteger(int16_t number, uint8_t intBase, 
+        char *buffer) {
+
     uint8_t i = 0;
     uint8_t reminder;
     int16_t num = number;
@@ -376,8 +613,7 @@ void LCD_PrintInteger(int16_t number, uint8_t intBase) {
     if (number == 0) {
         buffer[i++] = '0';
         buffer[i] = '\0'; // add null terminating character
-        LCD_PrintString(buffer); // Print the string on the display
-        return;
+        return i;
     }
     
     // Handle negative numbers with a base of 10
@@ -402,8 +638,255 @@ void LCD_PrintInteger(int16_t number, uint8_t intBase) {
     
     buffer[i] = '\0'; // Append a null terminating character
     LCD_ReverseString(buffer, i);
-    LCD_PrintString(buffer); // Print the string on the display   
-    return;
+    return i;
+}
+
+
+/******************************************************************************* 
+ * Function to clear the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FrameClear(void) {
+    
+    memset(frameCells, ' ', sizeof(frameCells));
+    frameLine = 0;
+    frameColumn = 0;
+}
+
+
+/******************************************************************************* 
+ * Function to set the cursor position in the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FrameSetCursor(LCD_CURSOR_LINE line, uint8_t offset) {
+    
+    frameLine = (line == LCD_SECOND_LINE) ? 1 : 0;
+    frameColumn = offset;
+}
+
+
+/******************************************************************************* 
+ * Function to shift the cursor of the shadow framebuffer to the right
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FrameShiftCursorRight(void) {
+    
+    if (frameColumn < 0xFF)
+        frameColumn++;
+}
+
+
+/******************************************************************************* 
+ * Function to print a character into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FramePrintCharacter(char input) {
+    
+    if (frameColumn < LCD_FRAME_COLUMNS)
+        frameCells[frameLine][frameColumn] = input;
+    LCD_FrameShiftCursorRight();
+}
+
+
+/******************************************************************************* 
+ * Function to print a string into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FramePrintString(const char *input) {
+    
+    while (*input != '\0')
+        LCD_FramePrintCharacter(*input++);
+}
+
+
+/******************************************************************************* 
+ * Function to print an integer value into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_FramePrintInteger(int16_t number, uint8_t intBase) {
+    
+    char buffer[20] = "";
+    
+    (void) LCD_FormatInteger(number, intBase, buffer);
+    LCD_FramePrintString(buffer);
+}
+
+
+/******************************************************************************* 
+ * Function to send the shadow framebuffer to the display
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_Flush(void) {
+    
+    uint32_t startBytes = busStats.commandBytes + busStats.dataBytes;
+    uint8_t line, column, end, i;
+    
+    // The mirror only covers the unshifted display
+    if (displayShift != 0)
+        LCD_Clear();
+    
+    for (line = 0; line < LCD_FRAME_LINES; line++) {
+        column = 0;
+        while (column < LCD_FRAME_COLUMNS) {
+            if (!LCD_IsCellChanged(line, column)) {
+                column++;
+                continue;
+            }
+            
+            // Extend the run across gaps of at most LCD_FLUSH_MAX_GAP cells
+            end = column;
+            for (i = column + 1; i < LCD_FRAME_COLUMNS 
+                    && i - end <= LCD_FLUSH_MAX_GAP + 1; i++) {
+                if (LCD_IsCellChanged(line, i))
+                    end = i;
+            }
+            
+            if (ddramAddress != (line ? LCD_DDRAM_SECOND_LINE : 0) + column)
+                LCD_SetCursor((LCD_CURSOR_LINE) line, column);
+            while (column <= end)
+                LCD_PrintCharacter(frameCells[line][column++]);
+        }
+    }
+    isMirrorValid = true; // every cell has been compared or written
+    
+    busStats.flushes++;
+    busStats.lastFlushBytes = (uint16_t) (busStats.commandBytes 
+            + busStats.dataBytes - startBytes);
+}
+
+
+/******************************************************************************* 
+ * Function to check whether a cell of the shadow framebuffer has changed
+ ******************************************************************************/
+/*
+ * @brief Before the display has been cleared, its content is unknown, thus
+ * every cell is considered changed.
+ * 
+ * @param line, column
+ * 
+ * @return True if the cell differs from the display
+ * 
+*/
+static _Bool LCD_IsCellChanged(uint8_t line, uint8_t column) {
+    
+    return !isMirrorValid 
+            || frameCells[line][column] != displayedCells[line][column];
+}
+
+
+/******************************************************************************* 
+ * Function to check whether the command queue is empty
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool LCD_IsQueueEmpty(void) {
+    
+    return queueHead == queueTail;
+}
+
+
+/******************************************************************************* 
+ * Interrupt service routine draining the command queue
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void LCD_TimerISR(void) {
+    
+    uint8_t tail = queueTail;
+    uint8_t value;
+    
+    if (holdTicks > 0) {
+        holdTicks--;
+        return;
+    }
+    if (tail == queueHead) {
+        PIE4bits.TMR6IE = 0; // the next queued byte enables it again
+        return;
+    }
+    
+    // RS = 0 --> instruction register, RS = 1 --> data register
+    value = (uint8_t) queue[tail].value;
+    LCD_RS = (queue[tail].regType == LCD_REG_CMD) ? 0 : 1;
+    LCD_PulseNibble(value >> 4); // transmit upper nibble first
+    LCD_PulseNibble(value & 0x0F); // transmit lower nibble second
+    if (queue[tail].regType == LCD_REG_CMD 
+            && value <= (LCD_CMD_RETURN_HOME | LCD_CMD_CLEAR))
+        holdTicks = LCD_LONG_EXEC_TICKS; // clear display or return home
+    queueTail = (tail + 1) & (LCD_QUEUE_SIZE - 1); // free the entry
+}
+
+
+/******************************************************************************* 
+ * Function to send one nibble from the ISR
+ ******************************************************************************/
+/*
+ * @brief Unlike LCD_TransferNibbleBits(), the enable pulse isn't stretched by
+ * delays: two NOPs keep E high for 750 ns at 16 MHz, which exceeds the 
+ * minimum of 230 ns of the HD44780. Returning and writing the next nibble
+ * keeps E low for longer than the rest of the enable cycle time. The masked
+ * write of LCD_DATA_LAT isn't interrupted, as it runs in the ISR.
+ * 
+ * @param nibble (uint8_t)
+ * 
+ * @return void 
+ * 
+*/
+static void LCD_PulseNibble(uint8_t nibble) {
+    
+    LCD_SET_DATA_NIBBLE(nibble);
+    
+    LCD_EN = 1;
+    NOP();
+    NOP();
+    LCD_EN = 0;
+}
+
+
+/******************************************************************************* 
+ * Function to get the bus statistics of the display
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+const LCD_BUS_STATS *LCD_GetBusStats(void) {
+    
+    return &busStats;
 }
 
 
@@ -439,10 +922,10 @@ static void LCD_ReverseString(char str[], uint16_t length) {
 static void LCD_ReadDataNibble(uint8_t *pReturnValue) {
     
     LCD_EN = 1; // Start reading/writing data
-    __delay_us(RW_TRIGGER_DELAY);
-    *pReturnValue = LCD_DATA_PORT & DATA_PORT_INPUT_PATTERN;
+    __delay_us(LCD_EN_HIGH_US); // covers the data delay time
+    *pReturnValue = (LCD_DATA_PORT & DATA_PORT_INPUT_PATTERN) >> LCD_DATA_SHIFT;
     LCD_EN = 0;
-    __delay_us(RW_TRIGGER_DELAY);
+    __delay_us(LCD_EN_LOW_US);
     return;
 }
 
@@ -451,7 +934,8 @@ static void LCD_ReadDataNibble(uint8_t *pReturnValue) {
  * Function to print an integer value on the LCD display
  ******************************************************************************/
 /*
- * @brief This routine reads a data byte from/to the bus-interface.
+ * @brief This routine reads a data byte from/to the bus-interface. The bus
+ * has to be switched to reading before, see LCD_IsIdle().
  * 
  * @param None
  * 
@@ -460,15 +944,8 @@ static void LCD_ReadDataNibble(uint8_t *pReturnValue) {
 */
 static uint8_t LCD_ReadDataByte(void) {
     
-    _Bool rsStateHistory;
     uint8_t data, tempData;     
 
-    rsStateHistory = LCD_RS; // Save RS state before changing it
-    LCD_RS = 0; // Select instruction register
-    LCD_RW = 1; // Select read mode
-    LCD_DATA_TRIS |= ~DATA_TRIS_OUTPUT_PATTERN; // set data lines to input       
-    __delay_us(10);
-
     /* Note that two cycles are needed for the busy flag check as well for
      * the data transfer */; 
     LCD_ReadDataNibble(&tempData); // Read higher nibble
@@ -476,10 +953,6 @@ static uint8_t LCD_ReadDataByte(void) {
     LCD_ReadDataNibble(&tempData); // Read lower nibble
     data |= (tempData & 0x0F);
 
-    LCD_DATA_TRIS &= DATA_TRIS_OUTPUT_PATTERN; // set data lines to output
-    LCD_RW = 0; // Return to default mode of writing data to the LCD
-    LCD_RS = rsStateHistory; // Restore RS state  
-
     return data;
 }
 
@@ -56,12 +56,19 @@ extern "C" {
 #define LCD_DB5         LATDbits.LATD5
 #define LCD_DB6         LATDbits.LATD6
 #define LCD_DB7         LATDbits.LATD7
+#define LCD_DATA_LAT    LATD  // LAT register for data pins
 #define LCD_DATA_TRIS   TRISD // TRIS register for data pins
 #define LCD_DATA_PORT   PORTD // PORT register for data pins
+/* DB4 to DB7 are contiguous bits of the data port, starting at LCD_DATA_SHIFT.
+ * If so, a nibble is written to LCD_DATA_LAT at once. Set LCD_DATA_MASKED_WRITE
+ * to 0 if the data pins are mapped otherwise, to write LCD_DB4 to LCD_DB7 one 
+ * by one. */
+#define LCD_DATA_SHIFT  4
+#define LCD_DATA_MASKED_WRITE 1
     
 // Definition of bit TRIS and PORT register pattern for data pins 
-#define DATA_TRIS_OUTPUT_PATTERN 0x0F // TRIS data port pattern (0 = output)
-#define DATA_PORT_INPUT_PATTERN 0xF0 // 1 = data pins used on data port    
+#define DATA_PORT_INPUT_PATTERN (0x0F << LCD_DATA_SHIFT) // 1 = data pins
+#define DATA_TRIS_OUTPUT_PATTERN (~DATA_PORT_INPUT_PATTERN & 0xFF) // 0 = output
 
 /****************************************************************************** 
 * LCD instruction register macros 
@@ -93,10 +100,34 @@ extern "C" {
 #define INT_BASE_OCTAL 8 // Base 8 for octal
 #define INT_BASE_HEX 16 // Base 16 for hexadecimal
 
-// Default time delay (us) for triggering read/write instructions
-#define RW_TRIGGER_DELAY 20  
+/* Enable pulse timing (us), rounded up to whole microseconds from the 
+ * minimums of the HD44780 at 5 V: enable pulse width 230 ns, enable cycle time
+ * 500 ns and data delay time 160 ns */
+#define LCD_EN_HIGH_US 1
+#define LCD_EN_LOW_US 1
 // If CHECK_BUSY_BIT is set to 1, the busy bit DB7 will be checked
 #define CHECK_BUSY_BIT 1
+
+// Size of the shadow framebuffer, i.e. of the visible area of the display
+#define LCD_FRAME_LINES 2
+#define LCD_FRAME_COLUMNS 16
+/* Unchanged cells between two changed ones, which are rewritten by a flush
+ * instead of setting the cursor. Rewriting a single cell costs the same byte
+ * as the set cursor command, but no additional wait */
+#define LCD_FLUSH_MAX_GAP 1
+
+/* If LCD_USE_QUEUE is set to 1, bytes written after LCD_Init() are queued and
+ * sent by the timer 6 interrupt, one byte per period. The interrupt is only
+ * enabled while the queue holds bytes. It can be overridden by the compiler
+ * options, e.g. to benchmark the direct transfers on the host. */
+#ifndef LCD_USE_QUEUE
+#define LCD_USE_QUEUE 1
+#endif
+#define LCD_QUEUE_SIZE 64 // entries, power of two
+// Period of the timer 6 interrupt (us) as configured by MCC
+#define LCD_QUEUE_TICK_US 50
+// Execution time of the clear display and return home instructions (us)
+#define LCD_LONG_EXEC_TIME_US 1640
     
 // Type definitions    
 typedef enum {
@@ -108,6 +139,17 @@ typedef enum {
     LCD_REG_CMD,
     LCD_REG_DATA       
 } LCD_REG_TYPE;
+
+/* Bytes written to the display. The bytes of the last flush are the cost of
+ * the last frame drawn into the shadow framebuffer. */
+typedef struct {
+    uint32_t commandBytes;
+    uint32_t dataBytes;
+    uint16_t flushes;
+    uint16_t lastFlushBytes;
+    uint16_t queueStalls;       // writes waiting for a free queue entry
+    uint8_t queuePeak;          // max. number of queued bytes
+} LCD_BUS_STATS;
     
 /******************************************************************************* 
  * Function to initialise the LCD display
@@ -261,6 +303,166 @@ extern void LCD_PrintString(const char *input);
 */
 extern void LCD_PrintInteger(int16_t number, uint8_t intBase);
 
+
+/******************************************************************************* 
+ * Function to clear the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief The shadow framebuffer holds the frame the application draws, which
+ * is sent to the display by LCD_Flush(). This function fills the framebuffer
+ * with spaces and sets its cursor to the left edge of the first line. The 
+ * display isn't accessed.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FrameClear(void);
+
+
+/******************************************************************************* 
+ * Function to set the cursor position in the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief This function sets the cursor of the framebuffer like 
+ * LCD_SetCursor() does on the display.
+ * 
+ * @param cursor line, cursor position offset
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FrameSetCursor(LCD_CURSOR_LINE line, uint8_t offset);
+
+
+/******************************************************************************* 
+ * Function to shift the cursor of the shadow framebuffer to the right
+ ******************************************************************************/
+/*
+ * @brief This function moves the cursor of the framebuffer by one position
+ * to the right without changing the cell.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FrameShiftCursorRight(void);
+
+
+/******************************************************************************* 
+ * Function to print a character into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief This function stores a character at the cursor of the framebuffer
+ * and moves the cursor to the right. Characters beyond the visible area are
+ * dropped.
+ * 
+ * @param input (char)
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FramePrintCharacter(char input);
+
+
+/******************************************************************************* 
+ * Function to print a string into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief This function prints a string into the framebuffer
+ * 
+ * @param pointer to char
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FramePrintString(const char *input);
+
+
+/******************************************************************************* 
+ * Function to print an integer value into the shadow framebuffer
+ ******************************************************************************/
+/*
+ * @brief This function prints an integer value into the framebuffer
+ * 
+ * @param number, base (decimal, hexadecimal, octal) 
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_FramePrintInteger(int16_t number, uint8_t intBase);
+
+
+/******************************************************************************* 
+ * Function to send the shadow framebuffer to the display
+ ******************************************************************************/
+/*
+ * @brief This function compares the framebuffer with a mirror of the display
+ * and writes only the changed cells. Runs of changed cells are written with
+ * a single set cursor command, which is skipped if the address counter of 
+ * the display already points to the run. The display isn't cleared, hence 
+ * it doesn't flicker. If the display has been shifted, it is cleared first.
+ * The mirror follows every byte written by this API, so that the direct
+ * functions, e.g. LCD_PrintString(), can still be used in between.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_Flush(void);
+
+
+/******************************************************************************* 
+ * Function to get the bus statistics of the display
+ ******************************************************************************/
+/*
+ * @brief This function returns the bytes written to the display since 
+ * initialisation.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics (LCD_BUS_STATS)
+ * 
+*/
+extern const LCD_BUS_STATS *LCD_GetBusStats(void);
+
+
+/******************************************************************************* 
+ * Function to check whether the command queue is empty
+ ******************************************************************************/
+/*
+ * @brief This function indicates whether all queued bytes have been sent to
+ * the display, e.g. before entering sleep mode. Without the queue, it always 
+ * returns true.
+ * 
+ * @param None
+ * 
+ * @return True if the queue is empty
+ * 
+*/
+extern _Bool LCD_IsQueueEmpty(void);
+
+
+/******************************************************************************* 
+ * Interrupt service routine draining the command queue
+ ******************************************************************************/
+/*
+ * @brief This ISR is registered for timer 6 by LCD_Init(). It sends the
+ * oldest queued byte per call. The next byte follows a period later, which
+ * exceeds the execution time of most instructions, so the busy flag isn't
+ * read. After clear display and return home, it waits for
+ * LCD_LONG_EXEC_TIME_US. The interrupt is disabled once the queue is empty.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+extern void LCD_TimerISR(void);
+
 #ifdef	__cplusplus
 }
 #endif
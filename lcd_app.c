@@ -34,7 +34,10 @@ const char *pText[LCD_NUM_MESSAGES] = {
     "improving",
     "worsening",
     "stable",
-    "dP="
+    "dP=",
+    "Rel.alt ",
+    "Vario   ",
+    "m/s"
     
     
 };
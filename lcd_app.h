@@ -38,6 +38,9 @@ typedef enum {
     LCD_TXT_TREND_DOWNWARD,
     LCD_TXT_TREND_STABLE,
     LCD_TXT_DELTA_PRESSURE,
+    LCD_TXT_VARIO_ALTITUDE,
+    LCD_TXT_VARIO_SPEED,
+    LCD_TXT_VARIO_SPEED_UNIT,
     LCD_NUM_MESSAGES // This entry has to be the last!   
 } LcdTextIndex;
 
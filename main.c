@@ -43,7 +43,14 @@
 #include "lcd_app.h"
 #include "bmp180.h"
 #include "state.h"
+#include "acquisition.h"
 #include "trend.h"
+#include "tick.h"
+#include "vario.h"
+#include "i2c_profile.h"
+#include "power.h"
+#include "state_profile.h"
+#include "console.h"
 
 // Global variables
 BMP180_PARAM bmp180param;
@@ -83,7 +90,17 @@ void main(void)
     TMR2_Start();
     
     // Initialise the internal state machine
-    initStateMachine(&currentState, &deviceContext);
+    initStateMachine(&currentState, &deviceContext, &bmp180param);
+    
+    // Initialise the millisecond timebase
+    initTick();
+    
+#if I2C_PROFILE_ENABLED
+    resetI2cProfile();
+#endif
+#if STATE_PROFILE_ENABLED
+    resetStateProfile();
+#endif
     
     // Initialise pressure recordings
     initPressureReadings();
@@ -94,19 +111,48 @@ void main(void)
     __delay_ms(500);
     
     // Initialise the BMP180 barometric pressure sensor
-    if (BMP180_Init(&bmp180param) != 0) {
-        sensorInitFailed = true;
-        LCD_Clear();
-        LCD_PrintString(getLcdText(LCD_TXT_ERROR_SENSOR));
+    bmp180param.tempRefreshSamples = BMP180_TEMP_REFRESH_SAMPLES;
+    bmp180param.tempRefreshPeriod = BMP180_TEMP_REFRESH_PERIOD;
+#if VARIO_MODE_ENABLED
+    bmp180param.oversampling = BMP180_MODE_ULTRALOWPOWER;
+#endif
+    while (BMP180_Init(&bmp180param) != 0) {
+        // Keep trying; each attempt is bounded by the I2C timeouts and retries
+        if (!sensorInitFailed) {
+            sensorInitFailed = true;
+            LCD_Clear();
+            LCD_PrintString(getLcdText(LCD_TXT_ERROR_SENSOR));
+        }
+        __delay_ms(BMP180_INIT_RETRY_PERIOD);
     }
-    while (sensorInitFailed); // Remain here if sensor communication has failed 
+    
+#if VARIO_MODE_ENABLED
+    // Initialise the high-rate variometer sample pipeline
+    initVariometer(&bmp180param);
+#else
+    // Initialise the background acquisition of the measurements
+    initAcquisition(&bmp180param);
+#endif
+    
+    // Idle the CPU whenever no task is ready
+    initPower();
     
     /***************************************************************************
      * Main infinite loop 
      **************************************************************************/
     while (1)
     {
+        serviceConsole();
+#if VARIO_MODE_ENABLED
+        runVariometer();
+#else
+        runAcquisition();
         runStateMachine(&currentState, &deviceContext);
+#if POWER_IDLE_ENABLED
+        if (!isAcquisitionReady() && !isStateMachineReady())
+            idleUntilInterrupt();
+#endif
+#endif
     }
 }
 /**
@@ -0,0 +1,342 @@
+/**
+\file
+\addtogroup doc_driver_i2c_code
+\brief This file provides some basic blocking helper functions for common operations on the I2C API
+
+\copyright (c) 2020 Microchip Technology Inc. and its subsidiaries.
+\page License
+    (c) 2020 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+
+#include ".././i2c1_master.h"
+#include "i2c1_simple_master.h"
+#include "../../tick.h"
+#include "../../i2c_profile.h"
+
+static i2c1_error_t lastError;
+static i2c1_error_stats_t errorStats;
+
+static i2c1_error_t i2c1_open(i2c1_address_t address);
+static i2c1_error_t i2c1_operation(i2c1_address_t address, i2c1_callback_t cb,
+        void *cbPayload, void *buffer, size_t len, bool read);
+static void i2c1_backOff(uint8_t delayMs);
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to get the result of the last helper function call
+ *  
+ *  \return I2C1_NOERR, or the error of the last attempt if all retries 
+ *          have failed
+ */
+i2c1_error_t i2c1_getLastError(void)
+{
+    return lastError;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to get the error statistics of the helper functions
+ *  
+ *  \return Pointer to the error statistics
+ */
+const i2c1_error_stats_t *i2c1_getErrorStats(void)
+{
+    return &errorStats;
+}
+
+/****************************************************************/
+/*
+ * Waits for the bus, which may be occupied by a stalled transfer, for at most
+ * I2C1_OPEN_TIMEOUT. The stalled transfer is aborted meanwhile.
+ */
+static i2c1_error_t i2c1_open(i2c1_address_t address)
+{
+    uint16_t startTick = getTickMs();
+
+    while(I2C1_Open(address) != I2C1_NOERR)
+    {
+        I2C1_CheckTimeout();
+        if(hasTickElapsed(startTick, I2C1_OPEN_TIMEOUT + 1))
+        {
+            return I2C1_BUSY;
+        }
+    }
+    return I2C1_NOERR;
+}
+
+/*
+ * Runs an operation and repeats it up to I2C1_RETRY_LIMIT times if it fails.
+ * Each attempt is bounded by the I2C1 timeout, which also recovers the bus;
+ * after a collision the bus is recovered here. Hence, a call stalls the 
+ * caller for at most 
+ * (I2C1_RETRY_LIMIT + 1) * (I2C1_OPEN_TIMEOUT + I2C1 timeout + 2 ms) + 7 ms,
+ * i.e. less than 100 ms with the default settings.
+ */
+static i2c1_error_t i2c1_operation(i2c1_address_t address, i2c1_callback_t cb,
+        void *cbPayload, void *buffer, size_t len, bool read)
+{
+    i2c1_error_t e = I2C1_FAIL;
+    uint8_t backOff = 1;
+    uint8_t x;
+#if I2C_PROFILE_ENABLED
+    I2C_CALL_SITE site = getI2cCallSite();
+    I2C_OPERATION_RECORD record = {0};
+    uint16_t startTick = getTickMs();
+    uint16_t startTime = getTimerUs();
+#endif
+
+    for(x = 0; x <= I2C1_RETRY_LIMIT; x++)
+    {
+        if(x)
+        {
+            errorStats.retries++;
+            i2c1_backOff(backOff);
+            if(backOff < I2C1_RETRY_BACKOFF_MAX)
+            {
+                backOff <<= 1;
+            }
+        }
+        e = i2c1_open(address);
+        if(e == I2C1_NOERR)
+        {
+            I2C1_SetDataCompleteCallback(cb,cbPayload);
+            I2C1_SetBuffer(buffer,len);
+            I2C1_SetAddressNackCallback(NULL,NULL); //NACK polling?
+            I2C1_MasterOperation(read);
+            while(I2C1_BUSY == (e = I2C1_Close())); // bounded by the timeout
+#if I2C_PROFILE_ENABLED
+            record.bytes += I2C1_GetByteCount();
+#endif
+        }
+        if(e == I2C1_NOERR)
+        {
+            break;
+        }
+        switch(e)
+        {
+            case I2C1_TIMEDOUT:
+                errorStats.timeouts++;
+                errorStats.recoveries++; // recovered by the I2C1 driver
+                break;
+            case I2C1_COLLISION:
+                errorStats.collisions++;
+                errorStats.recoveries++;
+                I2C1_RecoverBus();
+                break;
+            case I2C1_FAIL:
+                errorStats.nacks++;
+                break;
+            default:
+                break;
+        }
+#if I2C_PROFILE_ENABLED
+        record.timeouts += (e == I2C1_TIMEDOUT);
+        record.collisions += (e == I2C1_COLLISION);
+        record.nacks += (e == I2C1_FAIL);
+#endif
+    }
+#if I2C_PROFILE_ENABLED
+    record.retries = (x > I2C1_RETRY_LIMIT) ? I2C1_RETRY_LIMIT : x;
+    // The microsecond counter wraps around after 65 ms
+    record.waitTime = hasTickElapsed(startTick, 65) ? 0xFFFF 
+            : (uint16_t)(getTimerUs() - startTime);
+    recordI2cOperation(site, &record);
+#endif
+    if(e != I2C1_NOERR)
+    {
+        errorStats.failures++;
+    }
+    lastError = e;
+    return e;
+}
+
+static void i2c1_backOff(uint8_t delayMs)
+{
+    while(delayMs--)
+    {
+        __delay_ms(1);
+    }
+}
+
+/****************************************************************/
+static i2c1_operations_t wr1RegCompleteHandler(void *p)
+{
+    I2C1_SetBuffer(p,1);
+    I2C1_SetDataCompleteCallback(NULL,NULL);
+    return I2C1_CONTINUE;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to write 1 byte of data to a register location
+ *  
+ *  \param [in] address [type]i2c1_address_t The slave address
+ *         [in] reg     [type]uint8_t The register address to be written to
+ *         [in] data    [type]uint8_t The data to be written
+ *  
+ *  \return None
+ */
+void i2c1_write1ByteRegister(i2c1_address_t address, uint8_t reg, uint8_t data)
+{
+    i2c1_operation(address, wr1RegCompleteHandler, &data, &reg, 1, false);
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to write N byte of data 
+ *  
+ *  \param [in] address [type]i2c1_address_t Slave address
+ *         [in] data    [type]uint8_t Array of data to be send
+ *         [in] len     [type]uint8_t The size of the array
+ *  
+ *  \return None
+ */
+void i2c1_writeNBytes(i2c1_address_t address, void* data, size_t len)
+{
+    i2c1_operation(address, NULL, NULL, data, len, false);
+}
+
+/****************************************************************/
+static i2c1_operations_t rd1RegCompleteHandler(void *p)
+{
+    I2C1_SetBuffer(p,1);
+    I2C1_SetDataCompleteCallback(NULL,NULL);
+    return I2C1_RESTART_READ;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to read 1 byte of data from a register location
+ *  
+ *  \param [in] address [type]i2c1_address_t Slave address
+ *         [in] reg     [type]uint8_t The register address to be read
+ *  
+ *  \return [out] The read data byte
+ */
+uint8_t i2c1_read1ByteRegister(i2c1_address_t address, uint8_t reg)
+{
+    uint8_t    d2=42;
+
+    i2c1_operation(address, rd1RegCompleteHandler, &d2, &reg, 1, false);
+
+    return d2;
+}
+
+/****************************************************************/
+static i2c1_operations_t rd2RegCompleteHandler(void *p)
+{
+    I2C1_SetBuffer(p,2);
+    I2C1_SetDataCompleteCallback(NULL,NULL);
+    return I2C1_RESTART_READ;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to read 2 byte of data from a register location
+ *  
+ *  \param [in] address [type]i2c1_address_t Slave address
+ *         [in] reg     [type]uint8_t The register address to be read
+ *  
+ *  \return [out] The read 2 bytes of data
+ */
+uint16_t i2c1_read2ByteRegister(i2c1_address_t address, uint8_t reg)
+{
+    // result is little endian
+    uint16_t    result;
+
+    i2c1_operation(address, rd2RegCompleteHandler, &result, &reg, 1, false);
+    
+    return (result << 8 | result >> 8);
+}
+
+/****************************************************************/
+static i2c1_operations_t wr2RegCompleteHandler(void *p)
+{
+    I2C1_SetBuffer(p,2);
+    I2C1_SetDataCompleteCallback(NULL,NULL);
+    return I2C1_CONTINUE;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to write 1 byte of data to a register location
+ *  
+ *  \param [in] address [type]i2c1_address_t The slave address
+ *         [in] reg     [type]uint8_t The register address to be written to
+ *         [in] data    [type]uint8_t The data to be written
+ *  
+ *  \return None
+ */
+void i2c1_write2ByteRegister(i2c1_address_t address, uint8_t reg, uint16_t data)
+{
+    i2c1_operation(address, wr2RegCompleteHandler, &data, &reg, 1, false);
+}
+
+/****************************************************************/
+typedef struct
+{
+    size_t len;
+    char *data;
+}buf_t;
+
+static i2c1_operations_t rdBlkRegCompleteHandler(void *p)
+{
+    I2C1_SetBuffer(((buf_t *)p)->data,((buf_t*)p)->len);
+    I2C1_SetDataCompleteCallback(NULL,NULL);
+    return I2C1_RESTART_READ;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to read block of data from a register location
+ *  
+ *  \param [in] address [type]i2c1_address_t Slave address
+ *         [in] reg     [type]uint8_t The register address to be read
+ *         [out] data   [type]void* The read data block
+ *         [in] len     [type]size_t The size of data block
+ *  
+ *  \return None
+ */
+void i2c1_readDataBlock(i2c1_address_t address, uint8_t reg, void *data, size_t len)
+{
+    // result is little endian
+    buf_t    d;
+    d.data = data;
+    d.len = len;
+
+    i2c1_operation(address, rdBlkRegCompleteHandler, &d, &reg, 1, false);
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to read N bytes of data
+ *  
+ *  \param [in] address [type]i2c1_address_t Slave address
+ *         [out] data   [type]void* The read data block
+ *         [in] len     [type]size_t The size of data block
+ *  
+ *  \return None
+ */
+void i2c1_readNBytes(i2c1_address_t address, void *data, size_t len)
+{
+    i2c1_operation(address, NULL, NULL, data, len, true);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+\file
+\addtogroup doc_driver_i2c_code
+\ingroup doc_driver_i2c
+\brief This file contains the API that implements the I2C simple master driver functionalities.
+
+\copyright (c) 2020 Microchip Technology Inc. and its subsidiaries.
+\page License
+    (c) 2020 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+#ifndef I2C1_SIMPLE_MASTER_H
+#define	I2C1_SIMPLE_MASTER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include ".././i2c1_master.h"
+
+// Retries of a failed operation; the delay before a retry starts at 1 ms
+// and is doubled up to I2C1_RETRY_BACKOFF_MAX
+#define I2C1_RETRY_LIMIT             3
+#define I2C1_RETRY_BACKOFF_MAX       4   // [ms]
+// Max. time to wait for the bus to be released by a stalled transfer [ms]
+#define I2C1_OPEN_TIMEOUT            I2C1_DEFAULT_TIMEOUT
+
+// Error statistics of the helper functions
+typedef struct
+{
+    uint16_t retries;       // operations repeated after a failure
+    uint16_t timeouts;      // operations aborted by the I2C1 timeout
+    uint16_t collisions;    // operations which lost the arbitration
+    uint16_t nacks;         // operations not acknowledged by the slave
+    uint16_t recoveries;    // bus recovery sequences
+    uint16_t failures;      // calls which failed after all retries
+} i2c1_error_stats_t;
+
+i2c1_error_t i2c1_getLastError(void);
+const i2c1_error_stats_t *i2c1_getErrorStats(void);
+
+uint8_t i2c1_read1ByteRegister(i2c1_address_t address, uint8_t reg);
+uint16_t i2c1_read2ByteRegister(i2c1_address_t address, uint8_t reg);
+void i2c1_write1ByteRegister(i2c1_address_t address, uint8_t reg, uint8_t data);
+void i2c1_write2ByteRegister(i2c1_address_t address, uint8_t reg, uint16_t data);
+
+void i2c1_writeNBytes(i2c1_address_t address, void* data, size_t len);
+void i2c1_readDataBlock(i2c1_address_t address, uint8_t reg, void *data, size_t len);
+void i2c1_readNBytes(i2c1_address_t address, void *data, size_t len);
+
+#endif	/* I2C1_SIMPLE_MASTER_H */
+
@@ -29,6 +29,153 @@
 
 #include ".././i2c2_master.h"
 #include "i2c_simple_master.h"
+#include "../../tick.h"
+#include "../../i2c_profile.h"
+
+static i2c2_error_t lastError;
+static i2c_error_stats_t errorStats;
+
+static i2c2_error_t i2c_open(i2c2_address_t address);
+static i2c2_error_t i2c_operation(i2c2_address_t address, i2c2_callback_t cb,
+        void *cbPayload, void *buffer, size_t len, bool read);
+static void i2c_backOff(uint8_t delayMs);
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to get the result of the last helper function call
+ *  
+ *  \return I2C2_NOERR, or the error of the last attempt if all retries 
+ *          have failed
+ */
+i2c2_error_t i2c_getLastError(void)
+{
+    return lastError;
+}
+
+/**
+ *  \ingroup doc_driver_i2c_code
+ *  \brief Function to get the error statistics of the helper functions
+ *  
+ *  \return Pointer to the error statistics
+ */
+const i2c_error_stats_t *i2c_getErrorStats(void)
+{
+    return &errorStats;
+}
+
+/****************************************************************/
+/*
+ * Waits for the bus, which may be occupied by a queued transfer, for at most
+ * I2C_OPEN_TIMEOUT. A stalled queued transfer is aborted meanwhile.
+ */
+static i2c2_error_t i2c_open(i2c2_address_t address)
+{
+    uint16_t startTick = getTickMs();
+
+    while(I2C2_Open(address) != I2C2_NOERR)
+    {
+        I2C2_CheckTimeout();
+        if(hasTickElapsed(startTick, I2C_OPEN_TIMEOUT + 1))
+        {
+            return I2C2_BUSY;
+        }
+    }
+    return I2C2_NOERR;
+}
+
+/*
+ * Runs an operation and repeats it up to I2C_RETRY_LIMIT times if it fails.
+ * Each attempt is bounded by the I2C2 timeout, which also recovers the bus;
+ * after a collision the bus is recovered here. Hence, a call stalls the 
+ * caller for at most 
+ * (I2C_RETRY_LIMIT + 1) * (I2C_OPEN_TIMEOUT + I2C2 timeout + 2 ms) + 7 ms,
+ * i.e. less than 100 ms with the default settings.
+ */
+static i2c2_error_t i2c_operation(i2c2_address_t address, i2c2_callback_t cb,
+        void *cbPayload, void *buffer, size_t len, bool read)
+{
+    i2c2_error_t e = I2C2_FAIL;
+    uint8_t backOff = 1;
+    uint8_t x;
+#if I2C_PROFILE_ENABLED
+    I2C_CALL_SITE site = getI2cCallSite();
+    I2C_OPERATION_RECORD record = {0};
+    uint16_t startTick = getTickMs();
+    uint16_t startTime = getTimerUs();
+#endif
+
+    for(x = 0; x <= I2C_RETRY_LIMIT; x++)
+    {
+        if(x)
+        {
+            errorStats.retries++;
+            i2c_backOff(backOff);
+            if(backOff < I2C_RETRY_BACKOFF_MAX)
+            {
+                backOff <<= 1;
+            }
+        }
+        e = i2c_open(address);
+        if(e == I2C2_NOERR)
+        {
+            I2C2_SetDataCompleteCallback(cb,cbPayload);
+            I2C2_SetBuffer(buffer,len);
+            I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
+            I2C2_MasterOperation(read);
+            while(I2C2_BUSY == (e = I2C2_Close())); // bounded by the timeout
+#if I2C_PROFILE_ENABLED
+            record.bytes += I2C2_GetByteCount();
+#endif
+        }
+        if(e == I2C2_NOERR)
+        {
+            break;
+        }
+        switch(e)
+        {
+            case I2C2_TIMEDOUT:
+                errorStats.timeouts++;
+                errorStats.recoveries++; // recovered by the I2C2 driver
+                break;
+            case I2C2_COLLISION:
+                errorStats.collisions++;
+                errorStats.recoveries++;
+                I2C2_RecoverBus();
+                break;
+            case I2C2_FAIL:
+                errorStats.nacks++;
+                break;
+            default:
+                break;
+        }
+#if I2C_PROFILE_ENABLED
+        record.timeouts += (e == I2C2_TIMEDOUT);
+        record.collisions += (e == I2C2_COLLISION);
+        record.nacks += (e == I2C2_FAIL);
+#endif
+    }
+#if I2C_PROFILE_ENABLED
+    record.retries = (x > I2C_RETRY_LIMIT) ? I2C_RETRY_LIMIT : x;
+    // The microsecond counter wraps around after 65 ms
+    record.waitTime = hasTickElapsed(startTick, 65) ? 0xFFFF 
+            : (uint16_t)(getTimerUs() - startTime);
+    recordI2cOperation(site, &record);
+#endif
+    if(e != I2C2_NOERR)
+    {
+        errorStats.failures++;
+    }
+    lastError = e;
+    return e;
+}
+
+static void i2c_backOff(uint8_t delayMs)
+{
+    while(delayMs--)
+    {
+        __delay_ms(1);
+    }
+}
 
 /****************************************************************/
 static i2c2_operations_t wr1RegCompleteHandler(void *p)
@@ -50,12 +197,7 @@ static i2c2_operations_t wr1RegCompleteHandler(void *p)
  */
 void i2c_write1ByteRegister(i2c2_address_t address, uint8_t reg, uint8_t data)
 {
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetDataCompleteCallback(wr1RegCompleteHandler,&data);
-    I2C2_SetBuffer(&reg,1);
-    I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-    I2C2_MasterWrite();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
+    i2c_operation(address, wr1RegCompleteHandler, &data, &reg, 1, false);
 }
 
 /**
@@ -70,11 +212,7 @@ void i2c_write1ByteRegister(i2c2_address_t address, uint8_t reg, uint8_t data)
  */
 void i2c_writeNBytes(i2c2_address_t address, void* data, size_t len)
 {
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetBuffer(data,len);
-    I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-    I2C2_MasterWrite();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
+    i2c_operation(address, NULL, NULL, data, len, false);
 }
 
 /****************************************************************/
@@ -97,20 +235,8 @@ static i2c2_operations_t rd1RegCompleteHandler(void *p)
 uint8_t i2c_read1ByteRegister(i2c2_address_t address, uint8_t reg)
 {
     uint8_t    d2=42;
-    i2c2_error_t e;
-    int x;
 
-    for(x = 2; x != 0; x--)
-    {
-        while(!I2C2_Open(address)); // sit here until we get the bus..
-        I2C2_SetDataCompleteCallback(rd1RegCompleteHandler,&d2);
-        I2C2_SetBuffer(&reg,1);
-        I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-        I2C2_MasterWrite();
-        while(I2C2_BUSY == (e = I2C2_Close())); // sit here until finished.
-        if(e==I2C2_NOERR) break;
-    }
-    
+    i2c_operation(address, rd1RegCompleteHandler, &d2, &reg, 1, false);
 
     return d2;
 }
@@ -137,12 +263,7 @@ uint16_t i2c_read2ByteRegister(i2c2_address_t address, uint8_t reg)
     // result is little endian
     uint16_t    result;
 
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetDataCompleteCallback(rd2RegCompleteHandler,&result);
-    I2C2_SetBuffer(&reg,1);
-    I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-    I2C2_MasterWrite();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
+    i2c_operation(address, rd2RegCompleteHandler, &result, &reg, 1, false);
     
     return (result << 8 | result >> 8);
 }
@@ -167,12 +288,7 @@ static i2c2_operations_t wr2RegCompleteHandler(void *p)
  */
 void i2c_write2ByteRegister(i2c2_address_t address, uint8_t reg, uint16_t data)
 {
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetDataCompleteCallback(wr2RegCompleteHandler,&data);
-    I2C2_SetBuffer(&reg,1);
-    I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-    I2C2_MasterWrite();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
+    i2c_operation(address, wr2RegCompleteHandler, &data, &reg, 1, false);
 }
 
 /****************************************************************/
@@ -207,12 +323,7 @@ void i2c_readDataBlock(i2c2_address_t address, uint8_t reg, void *data, size_t l
     d.data = data;
     d.len = len;
 
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetDataCompleteCallback(rdBlkRegCompleteHandler,&d);
-    I2C2_SetBuffer(&reg,1);
-    I2C2_SetAddressNackCallback(NULL,NULL); //NACK polling?
-    I2C2_MasterWrite();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
+    i2c_operation(address, rdBlkRegCompleteHandler, &d, &reg, 1, false);
 }
 
 /**
@@ -227,8 +338,5 @@ void i2c_readDataBlock(i2c2_address_t address, uint8_t reg, void *data, size_t l
  */
 void i2c_readNBytes(i2c2_address_t address, void *data, size_t len)
 {
-    while(!I2C2_Open(address)); // sit here until we get the bus..
-    I2C2_SetBuffer(data,len);
-    I2C2_MasterRead();
-    while(I2C2_BUSY == I2C2_Close()); // sit here until finished.
-}
\ No newline at end of file
+    i2c_operation(address, NULL, NULL, data, len, true);
+}
\ No newline at end of file
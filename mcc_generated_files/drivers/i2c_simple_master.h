@@ -34,6 +34,27 @@
 #include <stdio.h>
 #include ".././i2c2_master.h"
 
+// Retries of a failed operation; the delay before a retry starts at 1 ms
+// and is doubled up to I2C_RETRY_BACKOFF_MAX
+#define I2C_RETRY_LIMIT             3
+#define I2C_RETRY_BACKOFF_MAX       4   // [ms]
+// Max. time to wait for the bus to be released by a queued transfer [ms]
+#define I2C_OPEN_TIMEOUT            I2C2_DEFAULT_TIMEOUT
+
+// Error statistics of the helper functions
+typedef struct
+{
+    uint16_t retries;       // operations repeated after a failure
+    uint16_t timeouts;      // operations aborted by the I2C2 timeout
+    uint16_t collisions;    // operations which lost the arbitration
+    uint16_t nacks;         // operations not acknowledged by the slave
+    uint16_t recoveries;    // bus recovery sequences
+    uint16_t failures;      // calls which failed after all retries
+} i2c_error_stats_t;
+
+i2c2_error_t i2c_getLastError(void);
+const i2c_error_stats_t *i2c_getErrorStats(void);
+
 uint8_t i2c_read1ByteRegister(i2c2_address_t address, uint8_t reg);
 uint16_t i2c_read2ByteRegister(i2c2_address_t address, uint8_t reg);
 void i2c_write1ByteRegister(i2c2_address_t address, uint8_t reg, uint8_t data);
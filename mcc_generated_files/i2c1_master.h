@@ -0,0 +1,271 @@
+/**
+  I2C1 Generated Driver API Header File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    i2c1_master.h
+
+  @Summary
+    This is the generated header file for the I2C1 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This header file provides APIs for driver for I2C1.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.81.8
+        Device            :  PIC18F47Q10
+        Driver Version    :  1.0.0
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 2.36 and above or later
+        MPLAB             :  MPLAB X 6.00
+*/
+
+/*
+    (c) 2018 Microchip Technology Inc. and its subsidiaries. 
+    
+    Subject to your compliance with these terms, you may use Microchip software and any 
+    derivatives exclusively with Microchip products. It is your responsibility to comply with third party 
+    license terms applicable to your use of third party software (including open source software) that 
+    may accompany Microchip software.
+    
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER 
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY 
+    IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS 
+    FOR A PARTICULAR PURPOSE.
+    
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP 
+    HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO 
+    THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL 
+    CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT 
+    OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS 
+    SOFTWARE.
+*/
+
+#ifndef I2C1_MASTER_H
+#define I2C1_MASTER_H
+
+/**
+  Section: Included Files
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Set to 1 to run the FSM from the MSSP1 interrupt instead of polling it
+#define I2C1_INTERRUPT_DRIVEN 1
+
+// Max. duration of an operation before it is aborted [ms]
+#define I2C1_DEFAULT_TIMEOUT 10
+
+typedef enum {
+    I2C1_NOERR, // The message was sent.
+    I2C1_BUSY,  // Message was not sent, bus was busy.
+    I2C1_FAIL,  // Message was not sent, bus failure
+               // If you are interested in the failure reason,
+               // Sit on the event call-backs.
+    I2C1_TIMEDOUT,  // Operation aborted after the timeout, bus recovered
+    I2C1_COLLISION  // Arbitration was lost due to a bus collision
+} i2c1_error_t;
+
+typedef enum
+{
+    I2C1_STOP=1,
+    I2C1_RESTART_READ,
+    I2C1_RESTART_WRITE,
+    I2C1_CONTINUE,
+    I2C1_RESET_LINK
+} i2c1_operations_t;
+
+typedef uint8_t i2c1_address_t;
+typedef i2c1_operations_t (*i2c1_callback_t)(void *funPtr);
+
+// common callback responses
+i2c1_operations_t I2C1_CallbackReturnStop(void *funPtr);
+i2c1_operations_t I2C1_CallbackReturnReset(void *funPtr);
+i2c1_operations_t I2C1_CallbackRestartWrite(void *funPtr);
+i2c1_operations_t I2C1_CallbackRestartRead(void *funPtr);
+
+/**
+ * \brief Initialize I2C1 interface
+ *
+ * \return Nothing
+ */
+void I2C1_Initialize(void);
+
+/**
+ * \brief Open the I2C1 for communication
+ *
+ * \param[in] address The slave address to use in the transfer
+ *
+ * \return Initialization status.
+ * \retval I2C1_NOERR The I2C1 open was successful
+ * \retval I2C1_BUSY  The I2C1 open failed because the interface is busy
+ * \retval I2C1_FAIL  The I2C1 open failed with an error
+ */
+i2c1_error_t I2C1_Open(i2c1_address_t address);
+
+/**
+ * \brief Close the I2C1 interface
+ *
+ * \return Status of close operation.
+ * \retval I2C1_NOERR The I2C1 open was successful
+ * \retval I2C1_BUSY  The I2C1 open failed because the interface is busy
+ * \retval I2C1_FAIL  The I2C1 open failed with an error
+ */
+i2c1_error_t I2C1_Close(void);
+
+/**
+ * \brief Start an operation on an opened I2C1 interface
+ *
+ * \param[in] read Set to true for read, false for write
+ *
+ * \return Status of operation
+ * \retval I2C1_NOERR The I2C1 open was successful
+ * \retval I2C1_BUSY  The I2C1 open failed because the interface is busy
+ * \retval I2C1_FAIL  The I2C1 open failed with an error
+ */
+i2c1_error_t I2C1_MasterOperation(bool read);
+
+/**
+ * \brief Identical to I2C1_MasterOperation(false);
+ */
+i2c1_error_t I2C1_MasterWrite(void); // to be depreciated
+
+/**
+ * \brief Identical to I2C1_MasterOperation(true);
+ */
+i2c1_error_t I2C1_MasterRead(void); // to be depreciated
+
+/**
+ * \brief Set timeout to be used for I2C1 operations. Uses the millisecond
+ *        timebase of the tick module. An operation which is still busy after
+ *        the timeout is aborted, the timeout callback is called and the bus
+ *        is recovered by I2C1_RecoverBus().
+ *
+ * \param[in] timeOutValue Timeout in ms
+ *
+ * \return Nothing
+ */
+void I2C1_SetTimeOut(uint8_t timeOutValue);
+
+/**
+ * \brief Abort the operation in progress if its timeout has elapsed. This is
+ *        checked by I2C1_Close(); a caller who doesn't poll I2C1_Close(), 
+ *        e.g. a transfer queue, has to invoke it periodically. The operation
+ *        complete handler is called after aborting.
+ *
+ * \return True if an operation was aborted
+ */
+bool I2C1_CheckTimeout(void);
+
+/**
+ * \brief Recover a bus held by a slave. The MSSP1 is disabled, 9 clock pulses
+ *        are sent on SCL1 to let the slave finish the byte it is sending,
+ *        a stop condition is generated and the MSSP1 is initialised again.
+ *        Takes about 110 us and must not be called during an operation.
+ *
+ * \return Nothing
+ */
+void I2C1_RecoverBus(void);
+
+/**
+ * \brief Sets up the data buffer to use, and number of bytes to transfer
+ *
+ * \param[in] buffer Pointer to data buffer to use for read or write data
+ * \param[in] bufferSize Number of bytes to read or write from slave
+ *
+ * \return Nothing
+ */
+void I2C1_SetBuffer(void *buffer, size_t bufferSize);
+
+// Event Callback functions.
+
+/**
+ * \brief Set callback to be called when all specifed data has been transferred.
+ *
+ * \param[in] cb Pointer to callback function
+ * \param[in] ptr  Pointer to the callback function's parameters
+ *
+ * \return Nothing
+ */
+void I2C1_SetDataCompleteCallback(i2c1_callback_t cb, void *ptr);
+
+/**
+ * \brief Set callback to be called when there has been a bus collision and arbitration was lost.
+ *
+ * \param[in] cb Pointer to callback function
+ * \param[in] ptr  Pointer to the callback function's parameters
+ *
+ * \return Nothing
+ */
+void I2C1_SetWriteCollisionCallback(i2c1_callback_t cb, void *ptr);
+
+/**
+ * \brief Set callback to be called when the transmitted address was Nack'ed.
+ *
+ * \param[in] cb Pointer to callback function
+ * \param[in] ptr  Pointer to the callback function's parameters
+ *
+ * \return Nothing
+ */
+void I2C1_SetAddressNackCallback(i2c1_callback_t cb, void *ptr);
+
+/**
+ * \brief Set callback to be called when the transmitted data was Nack'ed.
+ *
+ * \param[in] cb Pointer to callback function
+ * \param[in] ptr  Pointer to the callback function's parameters
+ *
+ * \return Nothing
+ */
+void I2C1_SetDataNackCallback(i2c1_callback_t cb, void *ptr);
+
+/**
+ * \brief Set callback to be called when there was a bus timeout.
+ *
+ * \param[in] cb Pointer to callback function
+ * \param[in] ptr  Pointer to the callback function's parameters
+ *
+ * \return Nothing
+ */
+void I2C1_SetTimeoutCallback(i2c1_callback_t cb, void *ptr);
+
+/**
+ * \brief Set handler to be called when an operation has completed and the
+ *        bus is released. In interrupt driven mode the handler is called
+ *        from the interrupt context.
+ *
+ * \param[in] handler Pointer to handler function, NULL to remove
+ *
+ * \return Nothing
+ */
+void I2C1_SetOperationCompleteHandler(void (*handler)(void));
+
+/**
+ * \brief Get the number of bytes clocked on the bus by the current or last
+ *        operation, including the address bytes. Used for bus profiling.
+ *
+ * \return Number of bytes
+ */
+uint16_t I2C1_GetByteCount(void);
+
+/**
+ * \brief MSSP1 interrupt service routine, called by the Interrupt Manager.
+ *
+ * \return Nothing
+ */
+void I2C1_ISR(void);
+
+/**
+ * \brief MSSP1 bus collision interrupt service routine, called by the
+ *        Interrupt Manager.
+ *
+ * \return Nothing
+ */
+void I2C1_BusCollisionIsr(void);
+
+#endif //I2C1_MASTER_H
\ No newline at end of file
@@ -46,6 +46,20 @@
 
 #include "i2c2_master.h"
 #include <xc.h>
+#include "device_config.h"
+#include "pin_manager.h"
+#include "../tick.h"
+
+// Bus recovery: SCL2 (RB1) and SDA2 (RB2) are operated as open drain port
+// pins, i.e. driven low by clearing TRIS and released by setting TRIS
+#define I2C2_SCL_LOW()                  RB1_SetDigitalOutput()
+#define I2C2_SCL_RELEASE()              RB1_SetDigitalInput()
+#define I2C2_SDA_LOW()                  RB2_SetDigitalOutput()
+#define I2C2_SDA_RELEASE()              RB2_SetDigitalInput()
+#define I2C2_SCL_PPS_VALUE              0x11
+#define I2C2_SDA_PPS_VALUE              0x12
+#define I2C2_RECOVERY_PULSES            9
+#define I2C2_RECOVERY_HALF_PERIOD_US    5   // 100 kHz
 
 // I2C2 STATES
 typedef enum {
@@ -83,13 +97,15 @@ typedef struct
 {
     i2c2_callback_t callbackTable[6];
     void *callbackPayload[6];           //  each callBack can have a payload
-    uint16_t time_out;                  // I2C2 Timeout Counter between I2C2 Events.
-    uint16_t time_out_value;            // Reload value for the timeouts
+    uint16_t time_out;                  // Tick when the operation was started
+    uint16_t time_out_value;            // Timeout of an operation [ms]
     i2c2_address_t address;             // The I2C2 Address
     uint8_t *data_ptr;                  // pointer to a data buffer
     size_t data_length;                 // Bytes in the data buffer
     i2c2_fsm_states_t state;            // Driver State
     i2c2_error_t error;
+    void (*operationCompleteHandler)(void); // called once the bus is released
+    uint16_t byteCount;                 // bytes clocked in this operation
     unsigned addressNackCheck:1;
     unsigned busy:1;
     unsigned inUse:1;
@@ -98,8 +114,12 @@ typedef struct
 } i2c2_status_t;
 
 static void I2C2_SetCallback(i2c2_callbackIndex_t idx, i2c2_callback_t cb, void *ptr);
+#if !I2C2_INTERRUPT_DRIVEN
 static void I2C2_Poller(void);
+#endif
 static inline void I2C2_MasterFsm(void);
+static bool I2C2_MasterIsTimedOut(void);
+static void I2C2_MasterAbort(void);
 
 /* I2C2 interfaces */
 static inline bool I2C2_MasterOpen(void);
@@ -122,7 +142,7 @@ static inline bool I2C2_MasterIsIrqEnabled(void);
 static inline void I2C2_MasterDisableIrq(void);
 static inline void I2C2_MasterClearIrq(void);
 static inline void I2C2_MasterSetIrq(void);
-static inline void I2C2_MasterWaitForEvent(void);
+static inline bool I2C2_MasterWaitForEvent(void);
 
 static i2c2_fsm_states_t I2C2_DO_IDLE(void);
 static i2c2_fsm_states_t I2C2_DO_SEND_ADR_READ(void);
@@ -166,11 +186,19 @@ i2c2_status_t I2C2_Status = {0};
 
 void I2C2_Initialize()
 {
+    if(!I2C2_Status.time_out_value)
+    {
+        I2C2_Status.time_out_value = I2C2_DEFAULT_TIMEOUT;
+    }
     SSP2STAT = 0x00;
     SSP2CON1 = 0x08;
     SSP2CON2 = 0x00;
     SSP2ADD  = 0x27;
     SSP2CON1bits.SSPEN = 0;
+#if I2C2_INTERRUPT_DRIVEN
+    PIR3bits.BCL2IF = 0;
+    PIE3bits.BCL2IE = 1;
+#endif
 }
 
 i2c2_error_t I2C2_Open(i2c2_address_t address)
@@ -184,7 +212,6 @@ i2c2_error_t I2C2_Open(i2c2_address_t address)
         I2C2_Status.inUse = 1;
         I2C2_Status.addressNackCheck = 0;
         I2C2_Status.state = I2C2_RESET;
-        I2C2_Status.time_out_value = 500; // MCC should determine a reasonable starting value here.
         I2C2_Status.bufferFree = 1;
 
         // set all the call backs to a default of sending stop
@@ -209,6 +236,7 @@ i2c2_error_t I2C2_Open(i2c2_address_t address)
 i2c2_error_t I2C2_Close(void)
 {
     i2c2_error_t returnValue = I2C2_BUSY;
+    I2C2_CheckTimeout();
     if(!I2C2_Status.busy)
     {
         I2C2_Status.inUse = 0;
@@ -227,6 +255,9 @@ i2c2_error_t I2C2_MasterOperation(bool read)
     if(!I2C2_Status.busy)
     {
         I2C2_Status.busy = true;
+        I2C2_Status.error = I2C2_NOERR;
+        I2C2_Status.time_out = getTickMs();
+        I2C2_Status.byteCount = 0;
         returnValue = I2C2_NOERR;
 
         if(read)
@@ -238,7 +269,11 @@ i2c2_error_t I2C2_MasterOperation(bool read)
             I2C2_Status.state = I2C2_SEND_ADR_WRITE;
         }
         I2C2_MasterStart();
+#if I2C2_INTERRUPT_DRIVEN
+        I2C2_MasterEnableIrq();
+#else
         I2C2_Poller();
+#endif
     }
     return returnValue;
 }
@@ -255,9 +290,71 @@ i2c2_error_t I2C2_MasterWrite(void)
 
 void I2C2_SetTimeOut(uint8_t timeOutValue)
 {
-    I2C2_MasterDisableIrq();
+    // A 8-bit write is atomic, no need to mask the interrupt
     I2C2_Status.time_out_value = timeOutValue;
-    I2C2_MasterEnableIrq();
+}
+
+bool I2C2_CheckTimeout(void)
+{
+    if(!I2C2_Status.busy || !I2C2_MasterIsTimedOut())
+    {
+        return false;
+    }
+    I2C2_MasterDisableIrq();
+    if(!I2C2_Status.busy)
+    {
+        return false; // completed right before the interrupt was masked
+    }
+    I2C2_MasterAbort();
+    I2C2_RecoverBus();
+    if(I2C2_Status.operationCompleteHandler)
+    {
+        I2C2_Status.operationCompleteHandler();
+    }
+    return true;
+}
+
+void I2C2_RecoverBus(void)
+{
+    uint8_t pulses;
+
+    I2C2_MasterDisableIrq();
+    I2C2_MasterClose();
+
+    // Hand the pins over to the port latches, which are held low
+    RB1PPS = 0x00;
+    RB2PPS = 0x00;
+    LATBbits.LATB1 = 0;
+    LATBbits.LATB2 = 0;
+    I2C2_SDA_RELEASE();
+    I2C2_SCL_RELEASE();
+
+    // Clock out the byte a slave may still be sending
+    for(pulses = 0; pulses < I2C2_RECOVERY_PULSES; pulses++)
+    {
+        __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+        I2C2_SCL_LOW();
+        __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+        I2C2_SCL_RELEASE();
+    }
+
+    // Stop condition: SDA rising while SCL is high
+    __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+    I2C2_SCL_LOW();
+    I2C2_SDA_LOW();
+    __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+    I2C2_SCL_RELEASE();
+    __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+    I2C2_SDA_RELEASE();
+    __delay_us(I2C2_RECOVERY_HALF_PERIOD_US);
+
+    RB1PPS = I2C2_SCL_PPS_VALUE;
+    RB2PPS = I2C2_SDA_PPS_VALUE;
+    I2C2_Initialize();
+    if(I2C2_Status.inUse)
+    {
+        I2C2_MasterOpen();
+    }
 }
 
 void I2C2_SetBuffer(void *buffer, size_t bufferSize)
@@ -295,6 +392,21 @@ void I2C2_SetTimeoutCallback(i2c2_callback_t cb, void *ptr)
     I2C2_SetCallback(I2C2_TIMEOUT, cb, ptr);
 }
 
+void I2C2_SetOperationCompleteHandler(void (*handler)(void))
+{
+    I2C2_Status.operationCompleteHandler = handler;
+}
+
+uint16_t I2C2_GetByteCount(void)
+{
+    return I2C2_Status.byteCount;
+}
+
+void I2C2_ISR(void)
+{
+    I2C2_MasterFsm();
+}
+
 static void I2C2_SetCallback(i2c2_callbackIndex_t idx, i2c2_callback_t cb, void *ptr)
 {
     if(cb)
@@ -309,14 +421,36 @@ static void I2C2_SetCallback(i2c2_callbackIndex_t idx, i2c2_callback_t cb, void
     }
 }
 
+#if !I2C2_INTERRUPT_DRIVEN
 static void I2C2_Poller(void)
 {
     while(I2C2_Status.busy)
     {
-        I2C2_MasterWaitForEvent();
+        if(!I2C2_MasterWaitForEvent())
+        {
+            I2C2_CheckTimeout();
+            break;
+        }
         I2C2_MasterFsm();
     }
 }
+#endif
+
+static bool I2C2_MasterIsTimedOut(void)
+{
+    // One additional tick, as the operation may have started right before it
+    return hasTickElapsed(I2C2_Status.time_out, I2C2_Status.time_out_value + 1);
+}
+
+static void I2C2_MasterAbort(void)
+{
+    (void) I2C2_Status.callbackTable[I2C2_TIMEOUT](I2C2_Status.callbackPayload[I2C2_TIMEOUT]);
+    I2C2_Status.error = I2C2_TIMEDOUT;
+    I2C2_Status.state = I2C2_RESET;
+    I2C2_Status.addressNackCheck = 0;
+    I2C2_Status.bufferFree = true;
+    I2C2_Status.busy = false;
+}
 
 static inline void I2C2_MasterFsm(void)
 {
@@ -327,13 +461,18 @@ static inline void I2C2_MasterFsm(void)
         I2C2_Status.state = I2C2_ADDRESS_NACK;
     }
     I2C2_Status.state = i2c2_fsmStateTable[I2C2_Status.state]();
+
+    if(!I2C2_Status.busy && I2C2_Status.operationCompleteHandler)
+    {
+        I2C2_Status.operationCompleteHandler();
+    }
 }
 
 
 static i2c2_fsm_states_t I2C2_DO_IDLE(void)
 {
+    // The error was cleared when starting the operation; keep a NACK
     I2C2_Status.busy = false;
-    I2C2_Status.error = I2C2_NOERR;
     return I2C2_RESET;
 }
 
@@ -355,6 +494,7 @@ static i2c2_fsm_states_t I2C2_DO_TX(void)
 {
     if(I2C2_MasterIsNack())
     {
+        I2C2_Status.error = I2C2_FAIL;
         switch(I2C2_Status.callbackTable[I2C2_DATA_NACK](I2C2_Status.callbackPayload[I2C2_DATA_NACK]))
         {
             case I2C2_RESTART_READ:
@@ -423,30 +563,6 @@ static i2c2_fsm_states_t I2C2_DO_TX_EMPTY(void)
     }
 }
 
-static i2c2_fsm_states_t I2C2_DO_RX_EMPTY(void)
-{
-    I2C2_Status.bufferFree = true;
-    switch(I2C2_Status.callbackTable[I2C2_DATA_COMPLETE](I2C2_Status.callbackPayload[I2C2_DATA_COMPLETE]))
-    {
-        case I2C2_RESTART_WRITE:
-            I2C2_MasterEnableRestart();
-            return I2C2_SEND_RESTART_WRITE;
-        case I2C2_RESTART_READ:
-            I2C2_MasterEnableRestart();
-            return I2C2_SEND_RESTART_READ;
-        case I2C2_CONTINUE:
-            // Avoid the counter stop condition , Counter is incremented by 1
-            return I2C2_RX;
-        default:
-        case I2C2_STOP:
-            if(I2C2_Status.state != I2C2_SEND_RESTART_READ)
-            {
-                I2C2_MasterDisableRestart();
-            }
-            return I2C2_RESET;
-    }
-}
-
 static i2c2_fsm_states_t I2C2_DO_SEND_RESTART_READ(void)
 {
     I2C2_MasterEnableRestart();
@@ -493,8 +609,8 @@ static i2c2_fsm_states_t I2C2_DO_RX_NACK_RESTART(void)
 
 static i2c2_fsm_states_t I2C2_DO_RESET(void)
 {
+    // Reached after a bus collision, which has set the error
     I2C2_Status.busy = false;
-    I2C2_Status.error = I2C2_NOERR;
     return I2C2_RESET;
 }
 static i2c2_fsm_states_t I2C2_DO_ADDRESS_NACK(void)
@@ -514,7 +630,11 @@ static i2c2_fsm_states_t I2C2_DO_ADDRESS_NACK(void)
 void I2C2_BusCollisionIsr(void)
 {
     I2C2_MasterClearBusCollision();
+    I2C2_Status.error = I2C2_COLLISION;
     I2C2_Status.state = I2C2_RESET;
+#if I2C2_INTERRUPT_DRIVEN
+    I2C2_MasterSetIrq(); // let the FSM release the bus
+#endif
 }
 
 i2c2_operations_t I2C2_CallbackReturnStop(void *funPtr)
@@ -562,11 +682,13 @@ static inline void I2C2_MasterClose(void)
 
 static inline uint8_t I2C2_MasterGetRxData(void)
 {
+    I2C2_Status.byteCount++;
     return SSP2BUF;
 }
 
 static inline void I2C2_MasterSendTxData(uint8_t data)
 {
+    I2C2_Status.byteCount++;
     SSP2BUF  = data;
 }
 
@@ -647,13 +769,17 @@ static inline void I2C2_MasterSetIrq(void)
     PIR3bits.SSP2IF = 1;
 }
 
-static inline void I2C2_MasterWaitForEvent(void)
+static inline bool I2C2_MasterWaitForEvent(void)
 {
     while(1)
     {
         if(PIR3bits.SSP2IF)
         {    
-            break;
+            return true;
+        }
+        if(I2C2_MasterIsTimedOut())
+        {
+            return false;
         }
     }
 }
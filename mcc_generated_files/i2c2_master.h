@@ -55,12 +55,20 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Set to 1 to run the FSM from the MSSP2 interrupt instead of polling it
+#define I2C2_INTERRUPT_DRIVEN 1
+
+// Max. duration of an operation before it is aborted [ms]
+#define I2C2_DEFAULT_TIMEOUT 10
+
 typedef enum {
     I2C2_NOERR, // The message was sent.
     I2C2_BUSY,  // Message was not sent, bus was busy.
-    I2C2_FAIL   // Message was not sent, bus failure
+    I2C2_FAIL,  // Message was not sent, bus failure
                // If you are interested in the failure reason,
                // Sit on the event call-backs.
+    I2C2_TIMEDOUT,  // Operation aborted after the timeout, bus recovered
+    I2C2_COLLISION  // Arbitration was lost due to a bus collision
 } i2c2_error_t;
 
 typedef enum
@@ -133,13 +141,36 @@ i2c2_error_t I2C2_MasterWrite(void); // to be depreciated
 i2c2_error_t I2C2_MasterRead(void); // to be depreciated
 
 /**
- * \brief Set timeout to be used for I2C2 operations. Uses the Timeout driver.
+ * \brief Set timeout to be used for I2C2 operations. Uses the millisecond
+ *        timebase of the tick module. An operation which is still busy after
+ *        the timeout is aborted, the timeout callback is called and the bus
+ *        is recovered by I2C2_RecoverBus().
+ *
+ * \param[in] timeOutValue Timeout in ms
+ *
+ * \return Nothing
+ */
+void I2C2_SetTimeOut(uint8_t timeOutValue);
+
+/**
+ * \brief Abort the operation in progress if its timeout has elapsed. This is
+ *        checked by I2C2_Close(); a caller who doesn't poll I2C2_Close(), 
+ *        e.g. a transfer queue, has to invoke it periodically. The operation
+ *        complete handler is called after aborting.
  *
- * \param[in] to Timeout in ticks
+ * \return True if an operation was aborted
+ */
+bool I2C2_CheckTimeout(void);
+
+/**
+ * \brief Recover a bus held by a slave. The MSSP2 is disabled, 9 clock pulses
+ *        are sent on SCL2 to let the slave finish the byte it is sending,
+ *        a stop condition is generated and the MSSP2 is initialised again.
+ *        Takes about 110 us and must not be called during an operation.
  *
  * \return Nothing
  */
-void I2C2_SetTimeout(uint8_t timeOut);
+void I2C2_RecoverBus(void);
 
 /**
  * \brief Sets up the data buffer to use, and number of bytes to transfer
@@ -203,4 +234,38 @@ void I2C2_SetDataNackCallback(i2c2_callback_t cb, void *ptr);
  */
 void I2C2_SetTimeoutCallback(i2c2_callback_t cb, void *ptr);
 
-#endif //I2C2_MASTER_H
\ No newline at end of file
+/**
+ * \brief Set handler to be called when an operation has completed and the
+ *        bus is released. In interrupt driven mode the handler is called
+ *        from the interrupt context.
+ *
+ * \param[in] handler Pointer to handler function, NULL to remove
+ *
+ * \return Nothing
+ */
+void I2C2_SetOperationCompleteHandler(void (*handler)(void));
+
+/**
+ * \brief Get the number of bytes clocked on the bus by the current or last
+ *        operation, including the address bytes. Used for bus profiling.
+ *
+ * \return Number of bytes
+ */
+uint16_t I2C2_GetByteCount(void);
+
+/**
+ * \brief MSSP2 interrupt service routine, called by the Interrupt Manager.
+ *
+ * \return Nothing
+ */
+void I2C2_ISR(void);
+
+/**
+ * \brief MSSP2 bus collision interrupt service routine, called by the
+ *        Interrupt Manager.
+ *
+ * \return Nothing
+ */
+void I2C2_BusCollisionIsr(void);
+
+#endif //I2C2_MASTER_H
\ No newline at end of file
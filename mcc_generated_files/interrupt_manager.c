@@ -64,7 +64,31 @@ void __interrupt() INTERRUPT_InterruptManager (void)
     }
     else if(INTCONbits.PEIE == 1)
     {
-        if(PIE1bits.ADTIE == 1 && PIR1bits.ADTIF == 1)
+        if(PIE4bits.TMR1IE == 1 && PIR4bits.TMR1IF == 1)
+        {
+            TMR1_ISR();
+        } 
+        else if(PIE4bits.TMR6IE == 1 && PIR4bits.TMR6IF == 1)
+        {
+            TMR6_ISR();
+        } 
+        else if(PIE3bits.SSP1IE == 1 && PIR3bits.SSP1IF == 1)
+        {
+            I2C1_ISR();
+        } 
+        else if(PIE3bits.BCL1IE == 1 && PIR3bits.BCL1IF == 1)
+        {
+            I2C1_BusCollisionIsr();
+        } 
+        else if(PIE3bits.SSP2IE == 1 && PIR3bits.SSP2IF == 1)
+        {
+            I2C2_ISR();
+        } 
+        else if(PIE3bits.BCL2IE == 1 && PIR3bits.BCL2IF == 1)
+        {
+            I2C2_BusCollisionIsr();
+        } 
+        else if(PIE1bits.ADTIE == 1 && PIR1bits.ADTIF == 1)
         {
             ADCC_ThresholdISR();
         } 
@@ -51,6 +51,7 @@ void SYSTEM_Initialize(void)
 {
     INTERRUPT_Initialize();
     PMD_Initialize();
+    I2C1_Initialize();
     I2C2_Initialize();
     PIN_MANAGER_Initialize();
     OSCILLATOR_Initialize();
@@ -59,6 +60,9 @@ void SYSTEM_Initialize(void)
     PWM3_Initialize();
     TMR2_Initialize();
     TMR0_Initialize();
+    TMR1_Initialize();
+    TMR3_Initialize();
+    TMR6_Initialize();
     EUSART1_Initialize();
 }
 
@@ -53,14 +53,19 @@
 #include <stdbool.h>
 #include <conio.h>
 #include "interrupt_manager.h"
+#include "i2c1_master.h"
 #include "i2c2_master.h"
 #include "tmr4.h"
 #include "tmr2.h"
 #include "tmr0.h"
+#include "tmr1.h"
+#include "tmr3.h"
+#include "tmr6.h"
 #include "adcc.h"
 #include "pwm3.h"
 #include "eusart1.h"
 #include "drivers/i2c_simple_master.h"
+#include "drivers/i2c1_simple_master.h"
 
 
 
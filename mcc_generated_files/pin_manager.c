@@ -76,7 +76,7 @@ void PIN_MANAGER_Initialize(void)
     ANSELx registers
     */
     ANSELD = 0x00;
-    ANSELC = 0x3F;
+    ANSELC = 0x27;
     ANSELB = 0xF9;
     ANSELE = 0x07;
     ANSELA = 0xFF;
@@ -125,12 +125,16 @@ void PIN_MANAGER_Initialize(void)
     
 	
     SSP2DATPPS = 0x0A;   //RB2->MSSP2:SDA2;    
+    SSP1CLKPPS = 0x13;   //RC3->MSSP1:SCL1;    
     RX1PPS = 0x17;   //RC7->EUSART1:RX1;    
     RB1PPS = 0x11;   //RB1->MSSP2:SCL2;    
     RB2PPS = 0x12;   //RB2->MSSP2:SDA2;    
+    RC3PPS = 0x0F;   //RC3->MSSP1:SCL1;    
+    RC4PPS = 0x10;   //RC4->MSSP1:SDA1;    
     RD0PPS = 0x07;   //RD0->PWM3:PWM3;    
     RC6PPS = 0x09;   //RC6->EUSART1:TX1;    
     SSP2CLKPPS = 0x09;   //RB1->MSSP2:SCL2;    
+    SSP1DATPPS = 0x14;   //RC4->MSSP1:SDA1;    
 }
   
 void PIN_MANAGER_IOC(void)
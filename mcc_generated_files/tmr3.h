@@ -0,0 +1,212 @@
+/**
+  TMR3 Generated Driver API Header File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    tmr3.h
+
+  @Summary
+    This is the generated header file for the TMR3 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This header file provides APIs for TMR3.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.81.8
+        Device            :  PIC18F47Q10
+        Driver Version    :  2.11
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 2.36 and above
+        MPLAB 	          :  MPLAB X 6.00
+*/
+
+/*
+    (c) 2018 Microchip Technology Inc. and its subsidiaries. 
+    
+    Subject to your compliance with these terms, you may use Microchip software and any 
+    derivatives exclusively with Microchip products. It is your responsibility to comply with third party 
+    license terms applicable to your use of third party software (including open source software) that 
+    may accompany Microchip software.
+    
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER 
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY 
+    IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS 
+    FOR A PARTICULAR PURPOSE.
+    
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, 
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND 
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP 
+    HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO 
+    THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL 
+    CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT 
+    OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS 
+    SOFTWARE.
+*/
+
+#ifndef TMR3_H
+#define TMR3_H
+
+/**
+  Section: Included Files
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+
+/**
+  Section: TMR3 APIs
+*/
+
+/**
+  @Summary
+    Initializes the TMR3
+
+  @Description
+    This routine initializes the TMR3.
+    This routine must be called before any other TMR3 routine is called.
+    The timer is clocked by FOSC/4 with a 1:4 prescaler, i.e. it counts
+    microseconds, and overflows every 65.536 ms without an interrupt.
+
+  @Preconditions
+    None
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void TMR3_Initialize(void);
+
+/**
+  @Summary
+    This function starts the TMR3.
+
+  @Description
+    This function starts the TMR3 operation.
+    This function must be called after the initialization of TMR3.
+
+  @Preconditions
+    Initialize  the TMR3 before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void TMR3_StartTimer(void);
+
+/**
+  @Summary
+    This function stops the TMR3.
+
+  @Description
+    This function stops the TMR3 operation.
+    This function must be called after the start of TMR3.
+
+  @Preconditions
+    Initialize  the TMR3 before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void TMR3_StopTimer(void);
+
+/**
+  @Summary
+    Reads the TMR3 register.
+
+  @Description
+    This function reads the TMR3 register value and return it.
+
+  @Preconditions
+    Initialize  the TMR3 before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    This function returns the current value of TMR3 register
+*/
+uint16_t TMR3_ReadTimer(void);
+
+/**
+  @Summary
+    Writes the TMR3 register.
+
+  @Description
+    This function writes the TMR3 register.
+    This function must be called after the initialization of TMR3.
+
+  @Preconditions
+    Initialize  the TMR3 before calling this function.
+
+  @Param
+    timerVal - Value to write into TMR3 register.
+
+  @Returns
+    None
+*/
+void TMR3_WriteTimer(uint16_t timerVal);
+
+/**
+  @Summary
+    Reload the TMR3 register.
+
+  @Description
+    This function reloads the TMR3 register.
+    This function must be called to write initial value into TMR3 register.
+
+  @Preconditions
+    Initialize  the TMR3 before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void TMR3_Reload(void);
+
+/**
+  @Summary
+    Boolean routine to poll or to check for the overflow flag on the fly.
+
+  @Description
+    This function is called to check for the timer overflow flag.
+    This function is usd in timer polling method.
+
+  @Preconditions
+    Initialize  the TMR3 module before calling this routine.
+
+  @Param
+    None
+
+  @Returns
+    true - timer overflow has occured.
+    false - timer overflow has not occured.
+*/
+bool TMR3_HasOverflowOccured(void);
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif // TMR3_H
+/**
+ End of File
+*/
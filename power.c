@@ -0,0 +1,193 @@
+/**
+ * 
+ * File:                power.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the power management of the main loop. The SLEEP 
+ * instruction enters IDLE mode, since SLEEP mode would stop the system clock
+ * and with it timer 1, timer 6, MSSP2 and the PWM of the backlight. Each idle
+ * period is measured with the microsecond counter of timer 3, which keeps
+ * running in IDLE mode. As the timer 1 tick wakes the CPU every millisecond,
+ * an idle period never exceeds the range of the counter. The elapsed time is
+ * taken from the millisecond tick.
+*/
+
+
+#include "power.h"
+#include "tick.h"
+
+#define POWER_PERMILLE_SCALE_LIMIT  0x003FFFFFUL    // x 1000 fits in 32 bits
+
+// Local variables
+static POWER_STATS stats;
+static uint16_t lastTick;
+static uint16_t idleUs;                 // fraction of idleMs
+
+
+/******************************************************************************* 
+ * Function to initialise the power management
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void initPower(void) {
+    
+    CPUDOZEbits.IDLEN = 1;
+    resetPowerStats();
+}
+
+
+/******************************************************************************* 
+ * Function to idle until the next interrupt
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void idleUntilInterrupt(void) {
+    
+    uint16_t startUs;
+    
+    (void) getPowerStats();
+    startUs = getTimerUs();
+    SLEEP();
+    NOP();
+    idleUs += getTimerUs() - startUs;
+    while (idleUs >= 1000) {
+        idleUs -= 1000;
+        stats.idleMs++;
+    }
+    stats.wakeups++;
+}
+
+
+/******************************************************************************* 
+ * Function to reset the statistics
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void resetPowerStats(void) {
+    
+    stats.totalMs = 0;
+    stats.idleMs = 0;
+    stats.wakeups = 0;
+    idleUs = 0;
+    lastTick = getTickMs();
+}
+
+
+/******************************************************************************* 
+ * Function to get the statistics
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+const POWER_STATS *getPowerStats(void) {
+    
+    uint16_t tick = getTickMs();
+    
+    stats.totalMs += (uint16_t) (tick - lastTick);
+    lastTick = tick;
+    
+    return &stats;
+}
+
+
+/******************************************************************************* 
+ * Function to get the duty cycle of the CPU
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint16_t getPowerDutyCycle(void) {
+    
+    uint32_t totalMs = getPowerStats()->totalMs;
+    uint32_t awakeMs;
+    
+    if (totalMs == 0)
+        return 1000;
+    // The idle time is measured more precisely; it may exceed the tick count
+    awakeMs = (stats.idleMs < totalMs) ? totalMs - stats.idleMs : 0;
+    while (totalMs > POWER_PERMILLE_SCALE_LIMIT) {
+        totalMs >>= 1;
+        awakeMs >>= 1;
+    }
+    
+    return (uint16_t) (awakeMs * 1000 / totalMs);
+}
+
+
+/******************************************************************************* 
+ * Function to estimate the mean supply current
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+uint16_t getPowerEstimatedCurrent(void) {
+    
+    return POWER_IDLE_CURRENT_UA + (uint16_t) ((uint32_t) getPowerDutyCycle() 
+            * (POWER_RUN_CURRENT_UA - POWER_IDLE_CURRENT_UA) / 1000);
+}
+
+
+/******************************************************************************* 
+ * Function to print the statistics
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+void printPowerStats(void) {
+    
+    uint16_t dutyCycle = getPowerDutyCycle();
+
+    printf("POWER - elapsed %lu ms, idle %lu ms, %lu wake-ups\n",
+            (unsigned long) stats.totalMs, (unsigned long) stats.idleMs,
+            (unsigned long) stats.wakeups);
+    printf("duty cycle %u.%u %%, est. current %u uA\n", dutyCycle / 10,
+            dutyCycle % 10, getPowerEstimatedCurrent());
+    printf("----------------------------------\n");
+}
+
+
+/******************************************************************************* 
+ * Function to handle a power command
+ ******************************************************************************/
+/*
+ * @brief For more details refer to the documentation in the corresponding
+ * header file
+ * 
+ */
+_Bool handlePowerCommand(uint8_t command) {
+    
+    switch (command) {
+        case POWER_CMD_PRINT:
+            printPowerStats();
+            return true;
+        case POWER_CMD_RESET:
+            resetPowerStats();
+            return true;
+        default:
+            return false;
+    }
+}
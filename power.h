@@ -0,0 +1,176 @@
+/* 
+ * File:                power.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module idles the CPU whenever no task of the main loop is ready. In
+ * IDLE mode, the CPU stops while the peripherals keep running on the system
+ * clock, thus the millisecond tick, the LCD queue, the I2C2 transfers, 
+ * EUSART1 and the backlight PWM continue. Any interrupt wakes the CPU, at the
+ * latest the timer 1 tick after 1 ms. The time spent idle is accumulated, so
+ * that the duty cycle of the CPU and the mean supply current can be 
+ * estimated.
+ *    
+ */
+
+#ifndef POWER_H
+#define	POWER_H
+
+#include "mcc_generated_files/mcc.h"
+
+#define POWER_IDLE_ENABLED          1   // set to 0 to keep the CPU running
+
+/* Supply current of the MCU at 16 MHz HFINTOSC and 5 V, running and in IDLE
+ * mode. These are estimates; adjust them to a measurement of the board. */
+#define POWER_RUN_CURRENT_UA        2300
+#define POWER_IDLE_CURRENT_UA       900
+
+// Commands received over EUSART1
+#define POWER_CMD_PRINT             'p'
+#define POWER_CMD_RESET             'P'
+
+// Statistics of the CPU since the last reset
+typedef struct {
+    uint32_t totalMs;           // elapsed time
+    uint32_t idleMs;            // time spent in IDLE mode
+    uint32_t wakeups;           // number of times the CPU was woken up
+} POWER_STATS;
+
+/******************************************************************************* 
+ * Function to initialise the power management
+ ******************************************************************************/
+/*
+ * @brief This initialisation function selects IDLE mode for the SLEEP 
+ * instruction and resets the statistics. It needs to be invoked once, after
+ * the millisecond tick has been initialised.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void initPower(void);
+
+
+/******************************************************************************* 
+ * Function to idle until the next interrupt
+ ******************************************************************************/
+/*
+ * @brief This enters IDLE mode and returns once an interrupt has woken the 
+ * CPU and has been serviced. It should be invoked by the main loop if no 
+ * task is ready. If an interrupt makes a task ready just before IDLE mode is
+ * entered, the task runs after the next tick at the latest.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void idleUntilInterrupt(void);
+
+
+/******************************************************************************* 
+ * Function to reset the statistics
+ ******************************************************************************/
+/*
+ * @brief This clears the elapsed time, the idle time and the wake-ups.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void resetPowerStats(void);
+
+
+/******************************************************************************* 
+ * Function to get the statistics
+ ******************************************************************************/
+/*
+ * @brief This updates the elapsed time and returns the statistics. It has to
+ * be invoked at least once per 65 s, which idleUntilInterrupt() does.
+ * 
+ * @param None
+ * 
+ * @return pointer to the statistics
+ * 
+*/
+const POWER_STATS *getPowerStats(void);
+
+
+/******************************************************************************* 
+ * Function to get the duty cycle of the CPU
+ ******************************************************************************/
+/*
+ * @brief This returns the share of the elapsed time the CPU was awake.
+ * 
+ * @param None
+ * 
+ * @return duty cycle in 0.1 % (uint16_t)
+ * 
+*/
+uint16_t getPowerDutyCycle(void);
+
+
+/******************************************************************************* 
+ * Function to estimate the mean supply current
+ ******************************************************************************/
+/*
+ * @brief This weights POWER_RUN_CURRENT_UA and POWER_IDLE_CURRENT_UA with the
+ * duty cycle. The current of the sensor, the LCD and its backlight isn't
+ * included.
+ * 
+ * @param None
+ * 
+ * @return estimated current of the MCU in uA (uint16_t)
+ * 
+*/
+uint16_t getPowerEstimatedCurrent(void);
+
+
+/******************************************************************************* 
+ * Function to print the statistics
+ ******************************************************************************/
+/*
+ * @brief This prints the statistics, the duty cycle and the estimated current
+ * over EUSART1.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void printPowerStats(void);
+
+
+/******************************************************************************* 
+ * Function to handle a power command
+ ******************************************************************************/
+/*
+ * @brief This prints the statistics on POWER_CMD_PRINT and clears them on
+ * POWER_CMD_RESET.
+ * 
+ * @param command received over EUSART1 (uint8_t)
+ * 
+ * @return true if the command has been handled
+ * 
+*/
+_Bool handlePowerCommand(uint8_t command);
+
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* POWER_H */
+
@@ -0,0 +1,153 @@
+/**
+ * 
+ * File:                sensor_group.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the round robin scheduler for several BMP180 sensors.
+ * Every sensor runs its own conversion cycle of temperature (if the refresh 
+ * is due) and pressure. As each step of a cycle only starts or collects a
+ * conversion, the conversion times of all sensors overlap and the sample
+ * throughput scales with the number of sensors as long as the buses are idle
+ * most of the time.
+*/
+
+
+#include "sensor_group.h"
+
+// Local function prototypes
+static void serviceSensorChannel(SENSOR_CHANNEL *pChannel);
+
+
+/******************************************************************************* 
+ * Function to initialise a sensor group
+ ******************************************************************************/
+/*
+ * @brief This function removes all sensors from the group.
+ * 
+ * @param pGroup -> pointer to the sensor group
+ * 
+ * @return void 
+ * 
+*/
+void initSensorGroup(SENSOR_GROUP *pGroup) {
+    
+    pGroup->numChannels = 0;
+}
+
+
+/******************************************************************************* 
+ * Function to add a sensor to a group
+ ******************************************************************************/
+/*
+ * @brief This function adds an initialised sensor to the group. Its first 
+ * conversion is started with the next invocation of runSensorGroup().
+ * 
+ * @param pGroup -> pointer to the sensor group
+ * @param pSensor -> pointer to a sensor initialised by BMP180_Init()
+ * 
+ * @return the result of adding the sensor
+ * @retval 0 -> success
+ * @retval 1 -> failed; the group is full
+ * 
+*/
+uint8_t addSensorToGroup(SENSOR_GROUP *pGroup, BMP180_PARAM *pSensor) {
+    
+    SENSOR_CHANNEL *pChannel;
+    
+    if (pGroup->numChannels >= SENSOR_GROUP_MAX_SENSORS)
+        return 1; // Error 1; group is full
+    
+    pChannel = &pGroup->channel[pGroup->numChannels++];
+    pChannel->pSensor = pSensor;
+    pChannel->phase = SENSOR_PHASE_START;
+    pChannel->rawTemperature = 0;
+    pChannel->temperature = 0;
+    pChannel->pressure = 0;
+    pChannel->sampleCount = 0;
+    
+    return 0;
+}
+
+
+/******************************************************************************* 
+ * Function to run the sensor group
+ ******************************************************************************/
+/*
+ * @brief This function has to be invoked continuously. It advances the 
+ * conversion cycle of every sensor in the group by at most one step. 
+ * 
+ * @param pGroup -> pointer to the sensor group
+ * 
+ * @return void 
+ * 
+*/
+void runSensorGroup(SENSOR_GROUP *pGroup) {
+    
+    for (uint8_t i = 0; i < pGroup->numChannels; i++) {
+        serviceSensorChannel(&pGroup->channel[i]);
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to advance the conversion cycle of a single sensor
+ ******************************************************************************/
+/*
+ * @brief This function starts the next conversion or collects the result of
+ * a completed conversion. The results of a completed cycle are stored in the
+ * channel and the next cycle is started right away. If the pressure
+ * conversion can't be started, the cycle starts over with a new temperature.
+ * 
+ * @param pChannel -> pointer to the sensor channel
+ * 
+ * @return void 
+ * 
+*/
+static void serviceSensorChannel(SENSOR_CHANNEL *pChannel) {
+    
+    BMP180_PARAM *pSensor = pChannel->pSensor;
+    uint32_t rawPressure;
+    
+    switch (pChannel->phase) {
+        case SENSOR_PHASE_START:
+            if (!BMP180_IsTemperatureRefreshDue(pSensor)) {
+                pChannel->rawTemperature = 
+                        BMP180_GetLastRawTemperature(pSensor);
+                if (BMP180_StartPressureConversion(pSensor) == 0)
+                    pChannel->phase = SENSOR_PHASE_COLLECT_PRESSURE;
+            } else if (BMP180_StartTemperatureConversion(pSensor) == 0) {
+                pChannel->phase = SENSOR_PHASE_COLLECT_TEMPERATURE;
+            }
+            break;
+        case SENSOR_PHASE_COLLECT_TEMPERATURE:
+            if (!BMP180_IsConversionComplete(pSensor))
+                return;
+            pChannel->rawTemperature = BMP180_CollectRawTemperature(pSensor);
+            if (BMP180_StartPressureConversion(pSensor) == 0)
+                pChannel->phase = SENSOR_PHASE_COLLECT_PRESSURE;
+            else
+                pChannel->phase = SENSOR_PHASE_START;
+            break;
+        case SENSOR_PHASE_COLLECT_PRESSURE:
+            if (!BMP180_IsConversionComplete(pSensor))
+                return;
+            pChannel->phase = SENSOR_PHASE_START;
+            rawPressure = BMP180_CollectRawPressure(pSensor);
+            if (rawPressure == BMP180_INVALID_DATA 
+                    || pChannel->rawTemperature == BMP180_INVALID_DATA)
+                break; // sample lost due to a bus failure
+            pChannel->temperature = BMP180_CalcTemperature(pSensor, 
+                    pChannel->rawTemperature);
+            pChannel->pressure = BMP180_CalcPressure(pSensor, rawPressure,
+                    pChannel->rawTemperature);
+            pChannel->sampleCount++;
+            break;
+    }
+}
@@ -0,0 +1,61 @@
+/* 
+ * File:                sensor_group.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module schedules the conversions of several BMP180 sensors, each bound
+ * to its own I2C bus. The sensors are serviced round robin without blocking,
+ * so that one sensor is read out while the others are still converting.
+ *    
+ */
+
+#ifndef SENSOR_GROUP_H
+#define	SENSOR_GROUP_H
+
+#include "mcc_generated_files/mcc.h"
+#include "bmp180.h"
+
+#define SENSOR_GROUP_MAX_SENSORS        2
+
+// Phases of the conversion cycle of a single sensor
+typedef enum {
+    SENSOR_PHASE_START,
+    SENSOR_PHASE_COLLECT_TEMPERATURE,
+    SENSOR_PHASE_COLLECT_PRESSURE
+} SensorPhase;
+
+// Conversion cycle and latest result of a single sensor
+typedef struct {
+    BMP180_PARAM *pSensor;
+    SensorPhase phase;
+    uint16_t rawTemperature;
+    int16_t temperature;    // latest temperature in 0.1 Celsius degree
+    int32_t pressure;       // latest pressure in Pa
+    uint16_t sampleCount;   // number of completed pressure samples
+} SENSOR_CHANNEL;
+
+// Group of sensors which are serviced round robin
+typedef struct {
+    SENSOR_CHANNEL channel[SENSOR_GROUP_MAX_SENSORS];
+    uint8_t numChannels;
+} SENSOR_GROUP;
+
+void initSensorGroup(SENSOR_GROUP *pGroup);
+uint8_t addSensorToGroup(SENSOR_GROUP *pGroup, BMP180_PARAM *pSensor);
+void runSensorGroup(SENSOR_GROUP *pGroup);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SENSOR_GROUP_H */
@@ -16,45 +16,47 @@
 
 #include "state.h"
 #include "bmp180.h"
+#include "acquisition.h"
 #include "lcd.h"
 #include "lcd_app.h"
 #include "trend.h"
+#include "tick.h"
+#include "state_profile.h"
 
 // Global variables
 static _Bool stateHasChanged;
+static uint16_t stateDelayStartTick;
+static uint16_t stateDelayMs; // 0 = the handler is invoked on each run
+
+// Generators of the tables from STATE_TABLE
+#define STATE_PROTOTYPE(state, handler, durationMs, nextState) \
+    static void handler(DeviceState *pCurrentState, DeviceContext *pContext);
+#define STATE_HANDLER(state, handler, durationMs, nextState)    &handler,
+#define STATE_DURATION(state, handler, durationMs, nextState)   durationMs,
+#define STATE_NEXT(state, handler, durationMs, nextState)       nextState,
+
+// Fails to compile unless the table has an entry per state
+#define STATE_CHECK_SIZE(table) typedef char table##SizeCheck[ \
+        (sizeof(table) / sizeof(table[0]) == STATE_COUNT) ? 1 : -1]
 
 // Function prototypes for state handler functions
-static void stateInit(DeviceState *pCurrentState, 
-        DeviceContext *pContext);
-static void stateUpdateMeasurement(DeviceState *pCurrentState, 
-        DeviceContext *pContext);
-static void stateDisplayTemperature(DeviceState *pCurrentState, 
-        DeviceContext *pContext);
-static void stateDisplayPressure(DeviceState *pCurrentState, 
-        DeviceContext *pContext);
-static void stateDisplayAltitude(DeviceState *pCurrentState,
-        DeviceContext *pContext);
-static void stateDisplayWeatherTrend(DeviceState *pCurrentState, 
-        DeviceContext *pContext);
-static void stateWait(DeviceState *pCurrentState,
-        DeviceContext *pContext);
-static void stateFinal(DeviceState *pCurrentState,
-        DeviceContext *pContext);
-
-// Declare an array of function pointers for state handlers in flash memory
+STATE_TABLE(STATE_PROTOTYPE)
+static void enterNextState(DeviceState *pCurrentState);
+static void suspendState(uint16_t durationMs);
+
+// Tables of the state handlers, durations and transitions in flash memory
 static void (*const pStateHandlers[])(DeviceState*, DeviceContext*) = {
-    &stateInit,
-    &stateUpdateMeasurement,
-    &stateDisplayTemperature,
-    &stateWait,
-    &stateDisplayPressure,
-    &stateWait,
-    &stateDisplayAltitude,
-    &stateWait,
-    &stateDisplayWeatherTrend,
-    &stateWait,            
-    &stateFinal
+    STATE_TABLE(STATE_HANDLER)
+};
+static const uint16_t stateDurations[] = {
+    STATE_TABLE(STATE_DURATION)
 };
+static const DeviceState nextStates[] = {
+    STATE_TABLE(STATE_NEXT)
+};
+STATE_CHECK_SIZE(pStateHandlers);
+STATE_CHECK_SIZE(stateDurations);
+STATE_CHECK_SIZE(nextStates);
 
 
 /******************************************************************************* 
@@ -63,12 +65,14 @@ static void (*const pStateHandlers[])(DeviceState*, DeviceContext*) = {
 /*
  * @brief This initialisation function needs to be invoked once 
  * 
- * @param pointer to the current state, pointer to the device context
+ * @param pointer to the current state, pointer to the device context,
+ * pointer to the BMP180 sensor the measurements are taken from
  * 
  * @return void 
  * 
 */
-void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
+void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext,
+        BMP180_PARAM *pSensor) {
     
     // Check for null pointers
     if (pContext == 0 || pCurrentState == 0)
@@ -78,9 +82,12 @@ void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
     pContext->altitude = 0;
     pContext->pressure = 0;
     pContext->temperature = 0;
+    pContext->pSensor = pSensor;
     
-    // Set the initial state
+    // Set the initial state, which is entered by the first run
     *pCurrentState = STATE_INIT;
+    stateHasChanged = true;
+    stateDelayMs = 0;
 }
 
 
@@ -99,13 +106,31 @@ void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
 void runStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
     
     static DeviceState prevState;
+#if STATE_PROFILE_ENABLED
+    DeviceState state;
+    uint16_t startTime;
+#endif
     
     // Check for null pointers
     if (pContext == 0 || pCurrentState == 0)
         return;
+    
+    // Return immediately until the suspended handler is due again
+    if (stateDelayMs != 0) {
+        if (!hasTickElapsed(stateDelayStartTick, stateDelayMs))
+            return;
+        stateDelayMs = 0;
+    }
 
     // Call the current state's handler function
+#if STATE_PROFILE_ENABLED
+    state = *pCurrentState;
+    startTime = getTimerUs();
+    pStateHandlers[state](pCurrentState, pContext);
+    recordStateExecution(state, getTimerUs() - startTime);
+#else
     pStateHandlers[*pCurrentState](pCurrentState, pContext);
+#endif
 
     // Set a flag if the state has changed
     stateHasChanged = (prevState != *pCurrentState) ? true : false;
@@ -113,11 +138,33 @@ void runStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
     
 }
 
+
+/******************************************************************************* 
+ * Function to check whether the finite state machine is ready to run
+ ******************************************************************************/
+/*
+ * @brief This checks whether the next run would invoke the current state
+ * handler
+ * 
+ * @param None
+ * 
+ * @return true if the finite state machine is ready to run
+ * 
+*/
+_Bool isStateMachineReady(void) {
+    
+    return stateDelayMs == 0 
+            || hasTickElapsed(stateDelayStartTick, stateDelayMs);
+}
+
+
 /******************************************************************************* 
  * State: Initialise 
  ******************************************************************************/
 /*
- * @brief This state is the initialisation routine of the state machine
+ * @brief This state is the initialisation routine of the state machine. It
+ * scrolls the welcome text without blocking: the handler is suspended 
+ * between the steps.
  * 
  * @param pointer to the current state, pointer to the device context
  * 
@@ -126,21 +173,28 @@ void runStateMachine(DeviceState *pCurrentState, DeviceContext *pContext) {
 */
 static void stateInit(DeviceState *pCurrentState, DeviceContext *pContext) {
     
-    uint8_t i;
+    static uint8_t scrollSteps;
        
-    // Scroll the welcome text from right to left 
-    LCD_Clear();
-    LCD_SetCursor(LCD_FIRST_LINE, 0);
-    LCD_PrintString(getLcdText(LCD_TXT_WELCOME));
-    __delay_ms(1000);
+    // Print the welcome text on entry and show it for a while
+    if (stateHasChanged) {
+        LCD_Clear();
+        LCD_SetCursor(LCD_FIRST_LINE, 0);
+        LCD_PrintString(getLcdText(LCD_TXT_WELCOME));
+        scrollSteps = 0;
+        suspendState(stateDurations[*pCurrentState]);
+        return;
+    }
    
-    for (i = 0; i < LCD_CHAR_LENGTH ; i++) {
+    // Scroll the welcome text from right to left, one column per invocation
+    if (scrollSteps < LCD_CHAR_LENGTH) {
         LCD_ShiftDisplayLeft();
-        __delay_ms(250);    
+        scrollSteps++;
+        suspendState(STATE_SCROLL_PERIOD_MS);
+        return;
     }
     
     // Transition to the following state
-    (*pCurrentState)++;     
+    enterNextState(pCurrentState);     
 }
 
 
@@ -148,8 +202,10 @@ static void stateInit(DeviceState *pCurrentState, DeviceContext *pContext) {
  * State: Update Measurement 
  ******************************************************************************/
 /*
- * @brief This state reads the raw sensor data and calculates pressure,
- * temperature, and altitude values.
+ * @brief This state copies the newest snapshot published by the acquisition
+ * task into the device context, so that the following screens show consistent
+ * values. Until the first sample has been published, it returns immediately 
+ * and remains in this state.
  * 
  * @param pointer to the current state, pointer to the device context
  * 
@@ -159,21 +215,16 @@ static void stateInit(DeviceState *pCurrentState, DeviceContext *pContext) {
 static void stateUpdateMeasurement(DeviceState *pCurrentState, 
         DeviceContext *pContext){
     
-    uint16_t rawTemperature;
-   
-    // Get raw sensor data and calculate temperature, pressure and altitude
-    rawTemperature = BMP180_ReadRawTemperature();
-    pContext->temperature = BMP180_CalcTemperature(rawTemperature);
-    pContext->pressure = BMP180_CalcPressure(BMP180_ReadRawPressure(), 
-            rawTemperature);
-    pContext->altitude = BMP180_CalcAltitude(pContext->pressure);
+    ACQ_SNAPSHOT snapshot;
     
-    if (updatePressureReading) {
-        updatePressureReadings(pContext->pressure);
-    }
+    if (!getAcquisitionSnapshot(&snapshot))
+        return;
+    pContext->temperature = snapshot.temperature;
+    pContext->pressure = snapshot.pressure;
+    pContext->altitude = snapshot.altitude;
     
     // Transition to the following state
-    (*pCurrentState)++; 
+    enterNextState(pCurrentState); 
 }
 
 
@@ -196,23 +247,25 @@ static void stateDisplayTemperature(DeviceState *pCurrentState,
     char strTemperature[LCD_TEMPERATURE_BUFFER_SIZE - 1];
     
     // Print the headline "Temperature" in the centre of the first line
-    LCD_Clear();
+    LCD_FrameClear();
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH 
             - strlen(getLcdText(LCD_TXT_TEMPERATURE))) / 2;
-    LCD_SetCursor(LCD_FIRST_LINE, cursorPos);
-    LCD_PrintString(getLcdText(LCD_TXT_TEMPERATURE));
+    LCD_FrameSetCursor(LCD_FIRST_LINE, cursorPos);
+    LCD_FramePrintString(getLcdText(LCD_TXT_TEMPERATURE));
 
     // Print the temperature value and its unit in the centre of the second line
     convertTemperatureToString(pContext->temperature, strTemperature);
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH - strlen(strTemperature) - 3) / 2;    
-    LCD_SetCursor(LCD_SECOND_LINE, cursorPos);
-    LCD_PrintString(strTemperature);
-    LCD_ShiftCursorRight();
-    LCD_PrintCharacter(0xdf); // 0xdf = Celsius degree symbol
-    LCD_PrintCharacter('C');        
+    LCD_FrameSetCursor(LCD_SECOND_LINE, cursorPos);
+    LCD_FramePrintString(strTemperature);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintCharacter(0xdf); // 0xdf = Celsius degree symbol
+    LCD_FramePrintCharacter('C');        
+    
+    LCD_Flush(); // write the changed cells only
     
     // Transition to the following state
-    (*pCurrentState)++; 
+    enterNextState(pCurrentState); 
 }
 
 
@@ -239,23 +292,25 @@ static void stateDisplayPressure(DeviceState *pCurrentState,
     hpa = (int16_t)(pContext->pressure / 100); // convert Pa to hPa
     
     // Print the headline "Pressure" in the centre of the first line
-    LCD_Clear();
+    LCD_FrameClear();
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH 
             - strlen(getLcdText(LCD_TXT_PRESSURE))) / 2;
-    LCD_SetCursor(LCD_FIRST_LINE, cursorPos);
-    LCD_PrintString(getLcdText(LCD_TXT_PRESSURE));
+    LCD_FrameSetCursor(LCD_FIRST_LINE, cursorPos);
+    LCD_FramePrintString(getLcdText(LCD_TXT_PRESSURE));
 
     // Print the pressure value and its unit in the centre of the second line
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH 
             - strlen(itoa(hpa, itoaBuffer, sizeof(itoaBuffer)))
             - strlen(getLcdText(LCD_TXT_PRESSURE_UNIT))) / 2;    
-    LCD_SetCursor(LCD_SECOND_LINE, cursorPos);
-    LCD_PrintInteger(hpa, INT_BASE_DECIMAL);
-    LCD_ShiftCursorRight();
-    LCD_PrintString(getLcdText(LCD_TXT_PRESSURE_UNIT));
+    LCD_FrameSetCursor(LCD_SECOND_LINE, cursorPos);
+    LCD_FramePrintInteger(hpa, INT_BASE_DECIMAL);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintString(getLcdText(LCD_TXT_PRESSURE_UNIT));
+    
+    LCD_Flush(); // write the changed cells only
     
     // Transition to the following state
-    (*pCurrentState)++; 
+    enterNextState(pCurrentState); 
 }
 
 /******************************************************************************* 
@@ -276,23 +331,25 @@ static void stateDisplayAltitude(DeviceState *pCurrentState,
     char itoaBuffer[12];
    
     // Print the headline "Altitude" in the centre of the first line
-    LCD_Clear();
+    LCD_FrameClear();
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH 
             - strlen(getLcdText(LCD_TXT_ALTITUDE))) / 2;
-    LCD_SetCursor(LCD_FIRST_LINE, cursorPos);
-    LCD_PrintString(getLcdText(LCD_TXT_ALTITUDE));
+    LCD_FrameSetCursor(LCD_FIRST_LINE, cursorPos);
+    LCD_FramePrintString(getLcdText(LCD_TXT_ALTITUDE));
 
     // Print the altitude value and its unit in the centre of the second line
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH 
             - strlen(itoa(pContext->altitude, itoaBuffer, sizeof(itoaBuffer)))
             - strlen(getLcdText(LCD_TXT_ALTITUDE_UNIT))) / 2;    
-    LCD_SetCursor(LCD_SECOND_LINE, cursorPos);
-    LCD_PrintInteger(pContext->altitude, INT_BASE_DECIMAL);
-    LCD_ShiftCursorRight();
-    LCD_PrintString(getLcdText(LCD_TXT_ALTITUDE_UNIT));
+    LCD_FrameSetCursor(LCD_SECOND_LINE, cursorPos);
+    LCD_FramePrintInteger(pContext->altitude, INT_BASE_DECIMAL);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintString(getLcdText(LCD_TXT_ALTITUDE_UNIT));
+    
+    LCD_Flush(); // write the changed cells only
     
     // Transition to the following state
-    (*pCurrentState)++; 
+    enterNextState(pCurrentState); 
 }
 
 
@@ -339,32 +396,37 @@ static void stateDisplayWeatherTrend(DeviceState *pCurrentState,
     }
            
     // Display the weather trend in the first line
-    LCD_Clear();
-    LCD_SetCursor(LCD_FIRST_LINE, 0);
-    LCD_PrintString(getLcdText(LCD_TXT_WEATHER_TREND));
-    LCD_ShiftCursorRight();
-    LCD_PrintString(getLcdText(trendTxt));
+    LCD_FrameClear();
+    LCD_FrameSetCursor(LCD_FIRST_LINE, 0);
+    LCD_FramePrintString(getLcdText(LCD_TXT_WEATHER_TREND));
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintString(getLcdText(trendTxt));
     
     // Display delta hPa and number of reading samples in the second line
-    LCD_SetCursor(LCD_SECOND_LINE, 0);
-    LCD_PrintString(getLcdText(LCD_TXT_DELTA_PRESSURE));
-    LCD_PrintInteger(delta_hPa, INT_BASE_DECIMAL);
-    LCD_ShiftCursorRight();
-    LCD_PrintString(getLcdText(LCD_TXT_PRESSURE_UNIT));    
+    LCD_FrameSetCursor(LCD_SECOND_LINE, 0);
+    LCD_FramePrintString(getLcdText(LCD_TXT_DELTA_PRESSURE));
+    LCD_FramePrintInteger(delta_hPa, INT_BASE_DECIMAL);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintString(getLcdText(LCD_TXT_PRESSURE_UNIT));    
     cursorPos = (uint8_t)(LCD_CHAR_LENGTH - strlen(itoa(numberOfValidReadings,
             itoaBuffer, sizeof(itoaBuffer))));
-    LCD_SetCursor(LCD_SECOND_LINE, cursorPos);
-    LCD_PrintInteger(numberOfValidReadings, INT_BASE_DECIMAL);
+    LCD_FrameSetCursor(LCD_SECOND_LINE, cursorPos);
+    LCD_FramePrintInteger(numberOfValidReadings, INT_BASE_DECIMAL);
         
-    // Transition to the following state
-    (*pCurrentState)++;
+    LCD_Flush(); // write the changed cells only
     
-    
-}/******************************************************************************* 
+    // Transition to the following state
+    enterNextState(pCurrentState);
+}
+
+
+/******************************************************************************* 
  * State: Wait
  ******************************************************************************/
 /*
- * @brief This state delays switching to the next state.
+ * @brief This state delays switching to the next state. On entry, the handler
+ * is suspended for the duration of the state instead of blocking the main
+ * loop.
  * 
  * @param pointer to the current state, pointer to the device context
  * 
@@ -373,9 +435,12 @@ static void stateDisplayWeatherTrend(DeviceState *pCurrentState,
 */
 static void stateWait(DeviceState *pCurrentState, DeviceContext *pContext) {
    
-    __delay_ms(4000);
+    if (stateHasChanged) {
+        suspendState(stateDurations[*pCurrentState]);
+        return;
+    }
     // Transition to the following state
-    (*pCurrentState)++;
+    enterNextState(pCurrentState);
 }
 
 
@@ -392,5 +457,42 @@ static void stateWait(DeviceState *pCurrentState, DeviceContext *pContext) {
 */
 static void stateFinal(DeviceState *pCurrentState, DeviceContext *pContext) {
     
-    (*pCurrentState) = STATE_INIT;    
+    enterNextState(pCurrentState);
+}
+
+
+/******************************************************************************* 
+ * Function to transition to the following state
+ ******************************************************************************/
+/*
+ * @brief This sets the current state to the next state of the state table.
+ * 
+ * @param pointer to the current state
+ * 
+ * @return void 
+ * 
+*/
+static void enterNextState(DeviceState *pCurrentState) {
+    
+    *pCurrentState = nextStates[*pCurrentState];
+}
+
+
+/******************************************************************************* 
+ * Function to suspend the current state handler
+ ******************************************************************************/
+/*
+ * @brief runStateMachine() doesn't invoke the handler again until the duration
+ * has elapsed on the millisecond timebase. The handler stays in its state, 
+ * i.e. stateHasChanged is false when it is re-entered.
+ * 
+ * @param duration in ms (uint16_t)
+ * 
+ * @return void 
+ * 
+*/
+static void suspendState(uint16_t durationMs) {
+    
+    stateDelayStartTick = getTickMs();
+    stateDelayMs = durationMs;
 }
@@ -18,18 +18,35 @@
 #define	STATE_H
 
 #include "mcc_generated_files/mcc.h"
+#include "bmp180.h"
+
+// Timing of the display carousel (ms); handlers are suspended, not blocked
+#define STATE_WAIT_PERIOD_MS        4000 // time a screen is displayed
+#define STATE_WELCOME_PERIOD_MS     1000 // welcome text before scrolling
+#define STATE_SCROLL_PERIOD_MS      250  // per column of the welcome text
+
+/* Table of the device states, from which the enumeration, the handler table,
+ * the durations and the transitions are generated. Each line declares
+ * X(state, handler, duration in ms, next state); the duration is the time the
+ * handler shows its text before passing on, 0 for none. */
+#define STATE_TABLE(X) \
+    X(STATE_INIT,                   stateInit,                  STATE_WELCOME_PERIOD_MS,    STATE_UPDATE_MEASUREMENT)   \
+    X(STATE_UPDATE_MEASUREMENT,     stateUpdateMeasurement,     0,                          STATE_DISPLAY_TEMPERATURE)  \
+    X(STATE_DISPLAY_TEMPERATURE,    stateDisplayTemperature,    0,                          STATE_WAIT_1)               \
+    X(STATE_WAIT_1,                 stateWait,                  STATE_WAIT_PERIOD_MS,       STATE_DISPLAY_PRESSURE)     \
+    X(STATE_DISPLAY_PRESSURE,       stateDisplayPressure,       0,                          STATE_WAIT_2)               \
+    X(STATE_WAIT_2,                 stateWait,                  STATE_WAIT_PERIOD_MS,       STATE_DISPLAY_ALTITUDE)     \
+    X(STATE_DISPLAY_ALTITUDE,       stateDisplayAltitude,       0,                          STATE_WAIT_3)               \
+    X(STATE_WAIT_3,                 stateWait,                  STATE_WAIT_PERIOD_MS,       STATE_DISPLAY_TREND)        \
+    X(STATE_DISPLAY_TREND,          stateDisplayWeatherTrend,   0,                          STATE_WAIT_4)               \
+    X(STATE_WAIT_4,                 stateWait,                  STATE_WAIT_PERIOD_MS,       STATE_FINAL)                \
+    X(STATE_FINAL,                  stateFinal,                 0,                          STATE_INIT)
 
 // Define the device states
+#define STATE_ENUM(state, handler, durationMs, nextState)   state,
 typedef enum {
-    STATE_INIT,
-    STATE_UPDATE_MEASUREMENT,
-    STATE_DISPLAY_TEMPERATURE,
-    STATE_WAIT_1,        
-    STATE_DISPLAY_PRESSURE,
-    STATE_WAIT_2,        
-    STATE_DISPLAY_ALTITUDE,
-    STATE_WAIT_3,
-    STATE_FINAL        
+    STATE_TABLE(STATE_ENUM)
+    STATE_COUNT
 } DeviceState;
 
 // Structure to hold state context information
@@ -37,6 +54,7 @@ typedef struct {
     int16_t temperature;
     int32_t pressure;
     int16_t altitude;
+    BMP180_PARAM *pSensor;
 } DeviceContext;
 
 // Function pointer type for state handler functions
@@ -48,12 +66,14 @@ typedef void (*stateHandler)(DeviceState*, DeviceContext*);
 /*
  * @brief This initialisation function needs to be invoked once 
  * 
- * @param pointer to the current state, pointer to the device context
+ * @param pointer to the current state, pointer to the device context,
+ * pointer to the BMP180 sensor the measurements are taken from
  * 
  * @return void 
  * 
 */
-void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext);
+void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext,
+        BMP180_PARAM *pSensor);
 
 
 /******************************************************************************* 
@@ -61,7 +81,8 @@ void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext);
  ******************************************************************************/
 /*
  * @brief This drives the finite state machine and needs to be invoked
- * cyclically
+ * cyclically. It returns immediately while the current state handler is
+ * suspended, so that other tasks can be serviced in between.
  * 
  * @param pointer to the current state, pointer to the device context
  * 
@@ -71,6 +92,22 @@ void initStateMachine(DeviceState *pCurrentState, DeviceContext *pContext);
 void runStateMachine(DeviceState *pCurrentState, DeviceContext *pContext);
 
 
+/******************************************************************************* 
+ * Function to check whether the finite state machine is ready to run
+ ******************************************************************************/
+/*
+ * @brief This checks whether the next run would invoke the current state
+ * handler, i.e. whether the handler isn't suspended or its suspension has
+ * elapsed. Otherwise, the CPU may idle until the next millisecond tick.
+ * 
+ * @param None
+ * 
+ * @return true if the finite state machine is ready to run
+ * 
+*/
+_Bool isStateMachineReady(void);
+
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,234 @@
+/**
+ * 
+ * File:                state_profile.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+
+ * Description:
+ * ------------
+ * This module contains the profiler of the state handlers. The execution
+ * times are accumulated per state and sorted into a histogram of logarithmic
+ * bins, i.e. bin 0 counts times below 64 us, bin n times from 2^(5+n) to
+ * 2^(6+n) us and the last bin all longer times. A handler running longer
+ * than 65 ms is recorded modulo the range of the microsecond counter.
+ * 
+ * The deadlines are kept when the profile is reset, so that they may be set
+ * once at initialisation.
+*/
+
+
+#include <string.h>
+#include "state_profile.h"
+
+#if STATE_PROFILE_ENABLED
+
+// Local variables
+static STATE_PROFILE stateProfiles[STATE_COUNT];
+static uint16_t deadlines[STATE_COUNT];
+static _Bool areDeadlinesSet;
+
+// Names of the states generated from the state table
+#define STATE_NAME(state, handler, durationMs, nextState)   #state,
+static const char *const stateNames[STATE_COUNT] = {
+    STATE_TABLE(STATE_NAME)
+};
+
+// Local function prototypes
+static uint8_t getHistogramBin(uint16_t time);
+
+
+/******************************************************************************* 
+ * Function to reset the state profile
+ ******************************************************************************/
+/*
+ * @brief This function clears the profiles of all states. On the first 
+ * invocation, the deadlines are set to STATE_PROFILE_DEADLINE_US.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void resetStateProfile(void) {
+    
+    if (!areDeadlinesSet) {
+        for (uint8_t i = 0; i < STATE_COUNT; i++)
+            deadlines[i] = STATE_PROFILE_DEADLINE_US;
+        areDeadlinesSet = true;
+    }
+    memset(stateProfiles, 0, sizeof(stateProfiles));
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        stateProfiles[i].minTime = 0xFFFF;
+        stateProfiles[i].deadline = deadlines[i];
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to set the deadline of a state
+ ******************************************************************************/
+/*
+ * @brief This function sets the execution time a handler call of the state
+ * must not exceed. Calls recorded afterwards are checked against it.
+ * 
+ * @param state (DeviceState), deadline in us (uint16_t); 0 = none
+ * 
+ * @return void
+ * 
+*/
+void setStateDeadline(DeviceState state, uint16_t deadline) {
+    
+    if (state >= STATE_COUNT)
+        return;
+    if (!areDeadlinesSet)
+        resetStateProfile();
+    deadlines[state] = deadline;
+    stateProfiles[state].deadline = deadline;
+}
+
+
+/******************************************************************************* 
+ * Function to record the execution of a state handler
+ ******************************************************************************/
+/*
+ * @brief This function adds a handler call to the profile of the state and
+ * counts a miss if the call has exceeded the deadline.
+ * 
+ * @param state (DeviceState), execution time in us (uint16_t)
+ * 
+ * @return void
+ * 
+*/
+void recordStateExecution(DeviceState state, uint16_t time) {
+
+    STATE_PROFILE *pProfile;
+
+    if (state >= STATE_COUNT)
+        return;
+    pProfile = &stateProfiles[state];
+
+    pProfile->calls++;
+    if (time < pProfile->minTime)
+        pProfile->minTime = time;
+    if (time > pProfile->maxTime)
+        pProfile->maxTime = time;
+    pProfile->totalTime += time;
+    if (pProfile->deadline != 0 && time > pProfile->deadline)
+        pProfile->misses++;
+    pProfile->histogram[getHistogramBin(time)]++;
+}
+
+
+/******************************************************************************* 
+ * Function to get the profile of a state
+ ******************************************************************************/
+/*
+ * @brief This function returns the profile of a state collected since the
+ * last reset.
+ * 
+ * @param state (DeviceState)
+ * 
+ * @return pointer to the profile, NULL for an invalid state
+ * 
+*/
+const STATE_PROFILE *getStateProfile(DeviceState state) {
+    
+    if (state >= STATE_COUNT)
+        return NULL;
+
+    return &stateProfiles[state];
+}
+
+
+/******************************************************************************* 
+ * Function to print the state profile
+ ******************************************************************************/
+/*
+ * @brief This function prints the profile of each state with at least one
+ * call over EUSART1, followed by the histogram of its execution times.
+ * 
+ * @param None
+ * 
+ * @return void
+ * 
+*/
+void printStateProfile(void) {
+    
+    const STATE_PROFILE *pProfile;
+
+    printf("STATE PROFILE - state: calls, time min/mean/max [us], "
+            "deadline [us], misses\n");
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        pProfile = &stateProfiles[i];
+        if (pProfile->calls == 0)
+            continue;
+        printf("%s: %u, %u/%lu/%u, %u, %u\n", stateNames[i],
+                pProfile->calls, pProfile->minTime,
+                (unsigned long) (pProfile->totalTime / pProfile->calls),
+                pProfile->maxTime, pProfile->deadline, pProfile->misses);
+        printf("  histogram:");
+        for (uint8_t bin = 0; bin < STATE_PROFILE_HISTOGRAM_BINS; bin++)
+            printf(" %u", pProfile->histogram[bin]);
+        printf("\n");
+    }
+    printf("----------------------------------\n");
+}
+
+
+/******************************************************************************* 
+ * Function to handle a profile command
+ ******************************************************************************/
+/*
+ * @brief This function prints the profile on STATE_PROFILE_CMD_PRINT and
+ * clears it on STATE_PROFILE_CMD_RESET.
+ * 
+ * @param command received over EUSART1 (uint8_t)
+ * 
+ * @return True if the command has been handled
+ * 
+*/
+_Bool handleStateProfileCommand(uint8_t command) {
+    
+    switch (command) {
+        case STATE_PROFILE_CMD_PRINT:
+            printStateProfile();
+            return true;
+        case STATE_PROFILE_CMD_RESET:
+            resetStateProfile();
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to get the histogram bin of an execution time
+ ******************************************************************************/
+/*
+ * @brief This function returns the logarithmic bin of an execution time, 
+ * i.e. the number of significant bits above STATE_PROFILE_HISTOGRAM_SHIFT.
+ * 
+ * @param execution time in us (uint16_t)
+ * 
+ * @return index of the bin (uint8_t)
+ * 
+*/
+static uint8_t getHistogramBin(uint16_t time) {
+    
+    uint8_t bin = 0;
+
+    time >>= STATE_PROFILE_HISTOGRAM_SHIFT;
+    while (time != 0 && bin < STATE_PROFILE_HISTOGRAM_BINS - 1) {
+        time >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * File:                state_profile.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+
+ * Description:
+ * ------------
+ * This module profiles the execution time of the state handlers per state.
+ * runStateMachine() takes the microsecond counter of the tick module before
+ * and after each handler call. Each state has a deadline, and calls which
+ * exceed it are counted as misses. The profile is printed over EUSART1 on
+ * request.
+ * 
+ */
+
+#ifndef STATE_PROFILE_H
+#define	STATE_PROFILE_H
+
+#include "mcc_generated_files/mcc.h"
+#include "state.h"
+
+// The profiler is part of debug builds only; MPLAB X defines __DEBUG for them
+#ifdef __DEBUG
+    #define STATE_PROFILE_ENABLED       1
+#else
+    #define STATE_PROFILE_ENABLED       0
+#endif
+#define STATE_PROFILE_HISTOGRAM_BINS    8
+#define STATE_PROFILE_HISTOGRAM_SHIFT   6   // upper limit of the first bin 64 us
+#define STATE_PROFILE_DEADLINE_US       2000 // default deadline of each state
+
+// Commands received over EUSART1
+#define STATE_PROFILE_CMD_PRINT         's'
+#define STATE_PROFILE_CMD_RESET         'S'
+
+// Profile of a state; the mean execution time is totalTime / calls
+typedef struct {
+    uint16_t calls;
+    uint16_t minTime;               // [us]
+    uint16_t maxTime;               // [us]
+    uint32_t totalTime;             // [us]
+    uint16_t deadline;              // [us]; 0 = none
+    uint16_t misses;                // calls exceeding the deadline
+    uint16_t histogram[STATE_PROFILE_HISTOGRAM_BINS]; // log2 bins of the time
+} STATE_PROFILE;
+
+void resetStateProfile(void);
+void setStateDeadline(DeviceState state, uint16_t deadline);
+void recordStateExecution(DeviceState state, uint16_t time);
+const STATE_PROFILE *getStateProfile(DeviceState state);
+void printStateProfile(void);
+_Bool handleStateProfileCommand(uint8_t command);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* STATE_PROFILE_H */
@@ -0,0 +1,125 @@
+/**
+ * 
+ * File:                tick.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains functions for a free-running millisecond timebase,
+ * which is incremented by the timer 1 interrupt every millisecond. 
+ * 
+ * Timer 3 is configured by MCC to count FOSC/4 with a 1:4 prescaler, i.e. in
+ * microseconds, without interrupt. 
+*/
+
+
+#include "tick.h"
+
+// Global variables
+static volatile uint16_t tickCounterMs;
+
+
+/******************************************************************************* 
+ * Function to initialise the millisecond timebase
+ ******************************************************************************/
+/*
+ * @brief This function resets the tick counter and registers the timer 1 
+ * interrupt handler
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void initTick(void) {
+    
+    tickCounterMs = 0;
+    TMR1_SetInterruptHandler(&timer1ISR);
+}
+
+
+/******************************************************************************* 
+ * Function to get the current tick count
+ ******************************************************************************/
+/*
+ * @brief This function returns the milliseconds elapsed since initialisation.
+ * The counter wraps around after 65535 ms. As the 16-bit counter can't be read
+ * atomically on an 8-bit MCU, the timer 1 interrupt is briefly masked.
+ * 
+ * @param None
+ * 
+ * @return tick count in ms (uint16_t)
+ * 
+*/
+uint16_t getTickMs(void) {
+    
+    uint16_t tick;
+    
+    PIE4bits.TMR1IE = 0;
+    tick = tickCounterMs;
+    PIE4bits.TMR1IE = 1;
+    
+    return tick;
+}
+
+
+/******************************************************************************* 
+ * Function to check whether a period has elapsed
+ ******************************************************************************/
+/*
+ * @brief This function checks whether the given duration has elapsed since the
+ * provided start tick. Unsigned arithmetic handles the counter wrap-around, 
+ * provided that durations are shorter than 65535 ms.
+ * 
+ * @param start tick (uint16_t), duration in ms (uint16_t)
+ * 
+ * @return True if the duration has elapsed
+ * 
+*/
+_Bool hasTickElapsed(uint16_t startTick, uint16_t durationMs) {
+    
+    return (uint16_t)(getTickMs() - startTick) >= durationMs;
+}
+
+
+/******************************************************************************* 
+ * Function to get the microsecond counter
+ ******************************************************************************/
+/*
+ * @brief This function returns the free-running microsecond counter of timer
+ * 3, which wraps around after 65535 us. Hence, it is suited to measure short 
+ * durations by unsigned subtraction. Timer 3 runs in 16-bit read mode, so
+ * the value is consistent without masking interrupts.
+ * 
+ * @param None
+ * 
+ * @return counter value in us (uint16_t)
+ * 
+*/
+uint16_t getTimerUs(void) {
+    
+    return TMR3_ReadTimer();
+}
+
+
+/******************************************************************************* 
+ * Interrupt service routine for timer 1
+ ******************************************************************************/
+/*
+ * @brief This ISR is invoked every millisecond by timer 1 to increment the 
+ * tick counter.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void timer1ISR(void) {
+    
+    tickCounterMs++;
+}
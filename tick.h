@@ -0,0 +1,39 @@
+/* 
+ * File:                tick.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module provides a free-running millisecond timebase driven by the 
+ * timer 1 interrupt. It allows time-consuming operations, such as sensor
+ * conversions, to be started and collected later without blocking the CPU.
+ * For profiling, timer 3 runs as a free-running microsecond counter.
+ *    
+ */
+
+#ifndef TICK_H
+#define	TICK_H
+
+#include "mcc_generated_files/mcc.h"
+
+void initTick(void);
+uint16_t getTickMs(void);
+_Bool hasTickElapsed(uint16_t startTick, uint16_t durationMs);
+uint16_t getTimerUs(void);
+void timer1ISR(void);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TICK_H */
+
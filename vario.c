@@ -0,0 +1,350 @@
+/**
+ * 
+ * File:                vario.c
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module contains the sample pipeline of the variometer mode. The 
+ * acquisition starts a pressure conversion every VARIO_SAMPLE_PERIOD_MS and 
+ * interleaves the temperature conversions requested by the BMP180 refresh
+ * schedule. Finished samples are queued in a ring buffer, drained by the 
+ * alpha-beta filter and the filtered values are shown on the LCD.
+*/
+
+
+#include <string.h>
+#include "vario.h"
+#include "bmp180.h"
+#include "lcd.h"
+#include "lcd_app.h"
+#include "tick.h"
+
+// Phases of the variometer sample acquisition
+typedef enum {
+    VARIO_PHASE_WAIT_PERIOD,
+    VARIO_PHASE_COLLECT_TEMPERATURE,
+    VARIO_PHASE_COLLECT_PRESSURE
+} VarioPhase;
+
+// Local variables
+static VARIO_SAMPLE sampleBuffer[VARIO_RING_BUFFER_SIZE];
+static uint8_t sampleHead;  // index of the next sample to be written
+static uint8_t sampleTail;  // index of the next sample to be read
+static VarioPhase acquisitionPhase;
+static uint16_t sampleStartTick;
+static uint16_t displayTick;
+static VARIO_FILTER varioFilter;
+static BMP180_PARAM *varioSensor;
+
+// Local function prototypes
+static void acquireVarioSample(void);
+static void displayVariometer(void);
+
+
+/******************************************************************************* 
+ * Function to initialise the variometer
+ ******************************************************************************/
+/*
+ * @brief This function clears the sample ring buffer and the filter and 
+ * schedules the first sample. The BMP180 has to be initialised beforehand,
+ * ideally in ultra low power mode (oss = 0).
+ * 
+ * @param pSensor -> pointer to the BMP180 the samples are taken from
+ * 
+ * @return void 
+ * 
+*/
+void initVariometer(BMP180_PARAM *pSensor) {
+    
+    varioSensor = pSensor;
+    sampleHead = 0;
+    sampleTail = 0;
+    acquisitionPhase = VARIO_PHASE_WAIT_PERIOD;
+    sampleStartTick = getTickMs() - VARIO_SAMPLE_PERIOD_MS;
+    displayTick = getTickMs();
+    resetVarioFilter(&varioFilter);
+}
+
+
+/******************************************************************************* 
+ * Function to run the variometer
+ ******************************************************************************/
+/*
+ * @brief This function has to be invoked continuously from the main loop. It
+ * advances the sample acquisition, feeds all queued samples to the filter and
+ * refreshes the LCD every VARIO_DISPLAY_PERIOD_MS. None of these steps blocks.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+void runVariometer(void) {
+    
+    VARIO_SAMPLE sample;
+    
+    acquireVarioSample();
+    
+    while (popVarioSample(&sample)) {
+        updateVarioFilter(&varioFilter, BMP180_CalcAltitudeCm(sample.pressure));
+    }
+    
+    if (hasTickElapsed(displayTick, VARIO_DISPLAY_PERIOD_MS)) {
+        displayTick += VARIO_DISPLAY_PERIOD_MS;
+        displayVariometer();
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to queue a sample in the ring buffer
+ ******************************************************************************/
+/*
+ * @brief This function appends a sample to the ring buffer.
+ * 
+ * @param pSample Pointer to the sample to be queued
+ * 
+ * @return true if queued, false if the buffer is full and the sample dropped
+ * 
+*/
+_Bool pushVarioSample(const VARIO_SAMPLE *pSample) {
+    
+    uint8_t nextHead = (sampleHead + 1) & (VARIO_RING_BUFFER_SIZE - 1);
+    
+    if (nextHead == sampleTail)
+        return false; // buffer full
+    sampleBuffer[sampleHead] = *pSample;
+    sampleHead = nextHead;
+    
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to take the oldest sample from the ring buffer
+ ******************************************************************************/
+/*
+ * @brief This function removes the oldest sample from the ring buffer.
+ * 
+ * @param pSample Pointer to the location the sample is copied to
+ * 
+ * @return true if a sample was copied, false if the buffer is empty
+ * 
+*/
+_Bool popVarioSample(VARIO_SAMPLE *pSample) {
+    
+    if (sampleTail == sampleHead)
+        return false; // buffer empty
+    *pSample = sampleBuffer[sampleTail];
+    sampleTail = (sampleTail + 1) & (VARIO_RING_BUFFER_SIZE - 1);
+    
+    return true;
+}
+
+
+/******************************************************************************* 
+ * Function to reset the alpha-beta filter
+ ******************************************************************************/
+/*
+ * @brief This function resets the filter. The next altitude passed to 
+ * updateVarioFilter() initialises the filter and becomes the reference for 
+ * the relative altitude.
+ * 
+ * @param pFilter Pointer to the filter state
+ * 
+ * @return void 
+ * 
+*/
+void resetVarioFilter(VARIO_FILTER *pFilter) {
+    
+    pFilter->altitude = 0;
+    pFilter->speed = 0;
+    pFilter->reference = 0;
+    pFilter->isInitialised = false;
+}
+
+
+/******************************************************************************* 
+ * Function to update the alpha-beta filter with a new altitude sample
+ ******************************************************************************/
+/*
+ * @brief This function predicts the altitude from the previous estimate and 
+ * corrects altitude and speed by the residual, scaled by the power-of-two 
+ * gains alpha and beta. The states are kept in fixed point with 
+ * VARIO_FILTER_FRACTION_BITS fractional bits, so that only additions and 
+ * shifts are required per sample.
+ * 
+ * @param pFilter Pointer to the filter state
+ * @param altitudeCm Altitude sample in cm
+ * 
+ * @return void 
+ * 
+*/
+void updateVarioFilter(VARIO_FILTER *pFilter, int32_t altitudeCm) {
+    
+    int32_t residual;
+    
+    if (!pFilter->isInitialised) {
+        pFilter->reference = altitudeCm;
+        pFilter->altitude = 0;
+        pFilter->speed = 0;
+        pFilter->isInitialised = true;
+        return;
+    }
+    altitudeCm -= pFilter->reference;
+    
+    pFilter->altitude += pFilter->speed;
+    residual = ((altitudeCm << VARIO_FILTER_FRACTION_BITS) - pFilter->altitude);
+    pFilter->altitude += residual >> VARIO_FILTER_ALPHA_SHIFT;
+    pFilter->speed += residual >> VARIO_FILTER_BETA_SHIFT;
+}
+
+
+/******************************************************************************* 
+ * Function to get the filtered relative altitude
+ ******************************************************************************/
+/*
+ * @brief This function returns the filtered altitude relative to the first
+ * sample after the last filter reset.
+ * 
+ * @param pFilter Pointer to the filter state
+ * 
+ * @return relative altitude in 1/10 m (int16_t)
+ * 
+*/
+int16_t getVarioRelativeAltitude(const VARIO_FILTER *pFilter) {
+    
+    int32_t altitude = pFilter->altitude;
+    
+    // Round the altitude in cm (Q8) to the nearest 1/10 m
+    return (int16_t)((altitude / 10 
+            + (1 << (VARIO_FILTER_FRACTION_BITS - 1))) 
+            >> VARIO_FILTER_FRACTION_BITS);
+}
+
+
+/******************************************************************************* 
+ * Function to get the filtered vertical speed
+ ******************************************************************************/
+/*
+ * @brief This function returns the filtered vertical speed, positive values
+ * indicate a climb.
+ * 
+ * @param pFilter Pointer to the filter state
+ * 
+ * @return vertical speed in 1/10 m/s (int16_t)
+ * 
+*/
+int16_t getVarioVerticalSpeed(const VARIO_FILTER *pFilter) {
+    
+    int32_t speed = pFilter->speed;
+    
+    // Convert cm per sample period (Q8) to 1/10 m/s
+    return (int16_t)((speed * (VARIO_SAMPLE_RATE_HZ / 10) 
+            + (1 << (VARIO_FILTER_FRACTION_BITS - 1))) 
+            >> VARIO_FILTER_FRACTION_BITS);
+}
+
+
+/******************************************************************************* 
+ * Function to advance the sample acquisition
+ ******************************************************************************/
+/*
+ * @brief This function starts a conversion every VARIO_SAMPLE_PERIOD_MS and 
+ * queues the compensated pressure once the conversion has completed. If the 
+ * temperature refresh is due, the temperature is converted first within the 
+ * same period. A sample period missed due to such an extra conversion is 
+ * caught up with the next sample, so that the mean sample rate is retained.
+ * If the pressure conversion can't be started, the sample is dropped and the
+ * next one is taken in the next period.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+static void acquireVarioSample(void) {
+    
+    VARIO_SAMPLE sample;
+    uint16_t rawTemperature;
+    uint32_t rawPressure;
+    
+    switch (acquisitionPhase) {
+        case VARIO_PHASE_WAIT_PERIOD:
+            if (!hasTickElapsed(sampleStartTick, VARIO_SAMPLE_PERIOD_MS))
+                return;
+            sampleStartTick += VARIO_SAMPLE_PERIOD_MS;
+            if (hasTickElapsed(sampleStartTick, VARIO_SAMPLE_PERIOD_MS))
+                sampleStartTick = getTickMs(); // too late; resynchronise
+            if (BMP180_IsTemperatureRefreshDue(varioSensor)) {
+                if (BMP180_StartTemperatureConversion(varioSensor) == 0)
+                    acquisitionPhase = VARIO_PHASE_COLLECT_TEMPERATURE;
+            } else if (BMP180_StartPressureConversion(varioSensor) == 0) {
+                acquisitionPhase = VARIO_PHASE_COLLECT_PRESSURE;
+            }
+            break;
+        case VARIO_PHASE_COLLECT_TEMPERATURE:
+            if (!BMP180_IsConversionComplete(varioSensor))
+                return;
+            (void) BMP180_CollectRawTemperature(varioSensor);
+            if (BMP180_StartPressureConversion(varioSensor) == 0)
+                acquisitionPhase = VARIO_PHASE_COLLECT_PRESSURE;
+            else
+                acquisitionPhase = VARIO_PHASE_WAIT_PERIOD;
+            break;
+        case VARIO_PHASE_COLLECT_PRESSURE:
+            if (!BMP180_IsConversionComplete(varioSensor))
+                return;
+            acquisitionPhase = VARIO_PHASE_WAIT_PERIOD;
+            rawPressure = BMP180_CollectRawPressure(varioSensor);
+            if (rawPressure == BMP180_INVALID_DATA)
+                break; // sample lost due to a bus failure
+            rawTemperature = BMP180_GetLastRawTemperature(varioSensor);
+            sample.pressure = BMP180_CalcPressure(varioSensor, rawPressure,
+                    rawTemperature);
+            sample.tick = getTickMs();
+            (void) pushVarioSample(&sample);
+            break;
+    }
+}
+
+
+/******************************************************************************* 
+ * Function to display the relative altitude and the vertical speed
+ ******************************************************************************/
+/*
+ * @brief This function displays the relative altitude on the first line and
+ * the vertical speed on the second line of the LCD, both with one decimal.
+ * 
+ * @param None
+ * 
+ * @return void 
+ * 
+*/
+static void displayVariometer(void) {
+    
+    char strValue[LCD_TEMPERATURE_BUFFER_SIZE - 1];
+    
+    LCD_FrameClear();
+    LCD_FrameSetCursor(LCD_FIRST_LINE, 0);
+    LCD_FramePrintString(getLcdText(LCD_TXT_VARIO_ALTITUDE));
+    convertTemperatureToString(getVarioRelativeAltitude(&varioFilter), 
+            strValue);
+    LCD_FramePrintString(strValue);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintCharacter('m');
+    
+    LCD_FrameSetCursor(LCD_SECOND_LINE, 0);
+    LCD_FramePrintString(getLcdText(LCD_TXT_VARIO_SPEED));
+    convertTemperatureToString(getVarioVerticalSpeed(&varioFilter), strValue);
+    LCD_FramePrintString(strValue);
+    LCD_FrameShiftCursorRight();
+    LCD_FramePrintString(getLcdText(LCD_TXT_VARIO_SPEED_UNIT));
+    LCD_Flush(); // write the changed cells only
+}
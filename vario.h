@@ -0,0 +1,75 @@
+/* 
+ * File:                vario.h
+ * Author:              J. Striebel
+ * Project:             Weather Station
+ * Device:              PIC18F47Q10 @ 16 MHz internal OSC, 5V
+ * Platform:            Curiosity HPC board (DM164136)
+ * Compiler:            XC8 (v2.41)
+ * IDE:                 MPLAB X (v6.10), MCC (5.3.7)
+ 
+ * Description:
+ * ------------
+ * This module implements a high-rate variometer mode. The BMP180 is sampled
+ * continuously in ultra low power mode (oss = 0), the pressure samples are
+ * queued in a ring buffer and converted to altitude, and a fixed-point 
+ * alpha-beta filter estimates the relative altitude and the vertical speed 
+ * which are shown on the LCD several times per second.
+ *    
+ */
+
+#ifndef VARIO_H
+#define	VARIO_H
+
+#include "mcc_generated_files/mcc.h"
+#include "bmp180.h"
+
+/* Set to 1 to run the variometer instead of the weather station carousel */
+#define VARIO_MODE_ENABLED          0
+
+/* Sample pipeline configuration */
+#define VARIO_SAMPLE_PERIOD_MS      10  // 100 Hz; oss = 0 converts in 4.5 ms
+#define VARIO_SAMPLE_RATE_HZ        (1000 / VARIO_SAMPLE_PERIOD_MS)
+#define VARIO_RING_BUFFER_SIZE      16  // has to be a power of two
+#define VARIO_DISPLAY_PERIOD_MS     250
+
+/* Alpha-beta filter gains given as right shifts, i.e. alpha = 1/2^5 and 
+ * beta = 1/2^9. These gains settle a vertical speed step within ~0.5 s at
+ * 100 Hz while keeping the speed noise of the oss = 0 samples (~0.5 m rms 
+ * altitude noise) at a few tenths of m/s, as checked by
+ * host/vario_host_test.c. */
+#define VARIO_FILTER_ALPHA_SHIFT    5
+#define VARIO_FILTER_BETA_SHIFT     9
+#define VARIO_FILTER_FRACTION_BITS  8   // fixed-point fraction of the states
+
+// Pressure sample queued by the acquisition for the filter
+typedef struct {
+    int32_t pressure;       // true pressure in Pa
+    uint16_t tick;          // millisecond tick at the end of the conversion
+} VARIO_SAMPLE;
+
+// State of the fixed-point alpha-beta filter
+typedef struct {
+    int32_t altitude;       // estimated altitude in cm (Q8)
+    int32_t speed;          // estimated speed in cm per sample period (Q8)
+    int32_t reference;      // altitude in cm for the relative altitude of zero
+    _Bool isInitialised;
+} VARIO_FILTER;
+
+void initVariometer(BMP180_PARAM *pSensor);
+void runVariometer(void);
+_Bool pushVarioSample(const VARIO_SAMPLE *pSample);
+_Bool popVarioSample(VARIO_SAMPLE *pSample);
+void resetVarioFilter(VARIO_FILTER *pFilter);
+void updateVarioFilter(VARIO_FILTER *pFilter, int32_t altitudeCm);
+int16_t getVarioRelativeAltitude(const VARIO_FILTER *pFilter);
+int16_t getVarioVerticalSpeed(const VARIO_FILTER *pFilter);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* VARIO_H */